@@ -12,6 +12,7 @@ TARGET = caffe_test
 CONFIG   += console
 CONFIG   -= app_bundle
 CONFIG   += c++11
+CONFIG   += thread
 
 TEMPLATE = app
 
@@ -24,14 +25,70 @@ INCLUDEPATH += include/
 LIBS += -lboost_system
 LIBS += -lglog
 LIBS += -lprotobuf
+LIBS += -lpthread
 
 
 SOURCES += main.cpp \
-    src/ANN.cpp
+    src/ANN.cpp \
+    src/StreamingEvaluator.cpp \
+    src/MLP.cpp \
+    src/IntervalVerifier.cpp \
+    src/AccuracyEvaluator.cpp \
+    src/PiecewiseLinearEvaluator.cpp \
+    src/LinearAlgebra.cpp \
+    src/LowRankCompressor.cpp \
+    src/DataSource.cpp \
+    src/MappedDataSource.cpp \
+    src/PrefetchingDataSource.cpp \
+    src/GeneratorDataSource.cpp \
+    src/QuasiRandomSampler.cpp \
+    src/AdaptiveTrainer.cpp \
+    src/ColumnarDataSet.cpp \
+    src/CsvIO.cpp \
+    src/Normalizer.cpp \
+    src/Transforms.cpp \
+    src/Matrix.cpp \
+    src/DataParallelSync.cpp \
+    src/AsynchronousSGD.cpp \
+    src/RingAllReduce.cpp \
+    src/DistributedSync.cpp \
+    src/LevenbergMarquardt.cpp \
+    src/LBFGS.cpp \
+    src/EarlyStopping.cpp \
+    src/SolverNet.cpp
 
 HEADERS += \
     include/ANN.h \
-    include/catch.hpp
+    include/catch.hpp \
+    include/BoundedQueue.h \
+    include/StreamingEvaluator.h \
+    include/Domain.h \
+    include/MLP.h \
+    include/IntervalVerifier.h \
+    include/AccuracyEvaluator.h \
+    include/PiecewiseLinearEvaluator.h \
+    include/LinearAlgebra.h \
+    include/LowRankCompressor.h \
+    include/DataSource.h \
+    include/MappedDataSource.h \
+    include/PrefetchingDataSource.h \
+    include/GeneratorDataSource.h \
+    include/QuasiRandomSampler.h \
+    include/AdaptiveTrainer.h \
+    include/ColumnarDataSet.h \
+    include/CsvIO.h \
+    include/Normalizer.h \
+    include/Transforms.h \
+    include/Matrix.h \
+    include/DataParallelSync.h \
+    include/AsynchronousSGD.h \
+    include/RingAllReduce.h \
+    include/DistributedSync.h \
+    include/LevenbergMarquardt.h \
+    include/LBFGS.h \
+    include/EarlyStopping.h \
+    include/CancellationToken.h \
+    include/SolverNet.h
 
 
 
@@ -6,14 +6,35 @@
 #include <map>
 #include <iostream>
 #include <fstream>
+#include <thread>
+#include <algorithm>
+#include <chrono>
 // caffe
 #include "caffe/caffe.hpp"
 #include "caffe/util/io.hpp"
+#include "caffe/util/upgrade_proto.hpp"
 #include "caffe/blob.hpp"
 #include "caffe/common.hpp"
 #include "caffe/sgd_solvers.hpp"
 #include "caffe/solver.hpp"
 #include "google/protobuf/text_format.h"
+// own
+#include "DataSource.h"
+#include "ColumnarDataSet.h"
+#include "MappedDataSource.h"
+#include "PrefetchingDataSource.h"
+#include "GeneratorDataSource.h"
+#include "Normalizer.h"
+#include "Transforms.h"
+#include "Matrix.h"
+#include "DataParallelSync.h"
+#include "AsynchronousSGD.h"
+#include "DistributedSync.h"
+#include "LevenbergMarquardt.h"
+#include "LBFGS.h"
+#include "EarlyStopping.h"
+#include "CancellationToken.h"
+#include "SolverNet.h"
 
 using namespace caffe;
 using namespace std;
@@ -32,6 +53,9 @@ using namespace std;
  */
 class ANN {
     public:
+        // why the last training has ended
+        enum StopReason { COMPLETED, EARLY_STOPPING, TIME_BUDGET, CANCELLED };
+
         /* --- constructors / destructors --- */
         ANN(const string& netStructurePrototxtPath_, const string &trainedWeightsCaffemodelPath_ = "",
             const string& solverParametersPrototxtPath_ = "");
@@ -40,38 +64,153 @@ class ANN {
         string getNetStructurePrototxtPath     () const {return netStructurePrototxtPath     ;};
         string getTrainedWeightsCaffemodelPath () const {return trainedWeightsCaffemodelPath ;};
         string getSolverParametersPrototxtPath () const {return solverParametersPrototxtPath ;};
+        string getSolverStatePath              () const {return solverStatePath              ;};
+        int    getBatchSize                    () const {return batchSize                    ;};
+        bool   getShuffle                      () const {return shuffle                      ;};
+        int    getMaxIterations                () const {return maxIterations                ;};
+        string getSolverType                   () const {return solverType                   ;};
+        int    getNumThreads                   () const {return numThreads                   ;};
+        bool   getAsynchronous                 () const {return asynchronous                 ;};
+        RingAllReduce* getRing                 () const {return ring                         ;};
+        int    getLBFGSHistorySize             () const {return lbfgsHistorySize             ;};
+        double getValidationFraction           () const {return validationFraction           ;};
+        int    getValidationInterval           () const {return validationInterval           ;};
+        int    getPatience                     () const {return patience                     ;};
+        double getTargetValidationError        () const {return targetValidationError        ;};
+        double getTimeBudget                   () const {return timeBudget                   ;};
+        CancellationToken* getCancellationToken() const {return cancellationToken            ;};
+        StopReason getStopReason               () const {return stopReason                   ;};
+        Normalizer::Method getNormalization    () const {return normalization                ;};
+        const Normalizer&  getInputNormalizer  () const {return inputNormalizer              ;};
+        const Normalizer&  getOutputNormalizer () const {return outputNormalizer             ;};
+        const AsynchronousSGD::Report& getAsynchronousReport() const {return asynchronousReport;};
+        const LevenbergMarquardt::Report& getLevenbergMarquardtReport() const {return levenbergMarquardtReport;};
+        const LBFGS::Report& getLBFGSReport    () const {return lbfgsReport                  ;};
+        const EarlyStopping::Report& getValidationReport() const {return validationReport   ;};
 
         void setNetStructurePrototxtPath     (const string& val_) {netStructurePrototxtPath     = val_;};
         void setTrainedWeightsCaffemodelPath (const string& val_) {trainedWeightsCaffemodelPath = val_;};
         void setSolverParametersPrototxtPath (const string& val_) {solverParametersPrototxtPath = val_;};
+        void setSolverStatePath              (const string& val_) {solverStatePath              = val_;};
+        void setBatchSize                    (int           val_) {batchSize                    = val_;};
+        void setShuffle                      (bool          val_) {shuffle                      = val_;};
+        void setMaxIterations                (int           val_) {maxIterations                = val_;};
+        void setSolverType                   (const string& val_) {solverType                   = val_;};
+        void setNumThreads                   (int           val_) {numThreads                   = val_;};
+        void setAsynchronous                 (bool          val_) {asynchronous                 = val_;};
+        void setRing                         (RingAllReduce* val_) {ring                        = val_;};
+        void setLBFGSHistorySize             (int           val_) {lbfgsHistorySize             = val_;};
+        void setValidationFraction           (double        val_) {validationFraction           = val_;};
+        void setValidationInterval           (int           val_) {validationInterval           = val_;};
+        void setPatience                     (int           val_) {patience                     = val_;};
+        void setTargetValidationError        (double        val_) {targetValidationError        = val_;};
+        void setTimeBudget                   (double        val_) {timeBudget                   = val_;};
+        void setCancellationToken            (CancellationToken* val_) {cancellationToken       = val_;};
+        void setNormalization                (Normalizer::Method val_) {normalization          = val_;};
 
         /* --- pushing values forward (from input to output) --- */
         double         forward (double         inputValue_);
         vector<double> forward (vector<double> inputValues_);
         vector<vector<double>> forward(vector<vector<double>> inputValues_);
+        Matrix         forward (const MatrixView& inputValues_);
+        bool           forward (const ColumnarDataSet& dataSet_, vector<double>& outputValues_);
 
         /* --- train / optimize weights --- */
         bool train (vector<double> inputValues_, vector<double> expectedOutputValues_);
         bool train (vector< vector<double> > inputValues_, vector<double> expectedOutputValues_);
+        bool train (vector< vector<double> > inputValues_, vector< vector<double> > expectedOutputValues_);
+        bool train (const MatrixView& inputValues_, const MatrixView& expectedOutputValues_);
+        bool train (DataSource& dataSource_, DataSource* validationDataSource_ = nullptr);
+        bool train (const string& dataSetPath_);
+        bool train (const string& binaryDataSetPath_, int numInputs_, int numOutputs_ = 1);
+        bool train (const Domain& domain_, const function<vector<double>(const vector<double>&)>& targetFunction_, int numOutputs_ = 1);
+
+        /* --- access to the loaded net --- */
+        Net<double>* loadNet();
 
         /* --- miscellaneous --- */
         vector<double> zTransformVector(const vector<double> &vectorToTransform_);
         vector<double> reZTransformVector(const vector<double> &vectorToReTransform_, const vector<double> &vectorBeforeZTransform_);
         vector<double> scaleVector(const vector<double> &vectorToScale_, double scaleFactor_, bool minimize_);
         vector<vector<double>> scaleVector(const vector<vector<double>> &vectorToScale_, double scaleFactor_, bool minimize_);
+        void           scaleVector(Matrix& matrixToScale_, double scaleFactor_, bool minimize_);
 
      private:
         // artificial neural net
-        Net<double> *net;
+        caffe::shared_ptr<Net<double> > net;
+        // solver of the running training, released with its helpers when train returns
         caffe::shared_ptr<Solver<double> > solver_;
+        // replicas of the net for data-parallel training, registered as callback of solver_
+        caffe::shared_ptr<DataParallelSync> parallelSync;
+        // workers of asynchronous training, their solvers share the weights with solver_
+        caffe::shared_ptr<AsynchronousSGD>  asynchronousSGD;
+        // sums the gradients of the ranks of a distributed training job
+        caffe::shared_ptr<DistributedSync>  distributedSync;
+        // validation net and best weights of early stopping, evaluated by the action function of solver_
+        caffe::shared_ptr<EarlyStopping>    earlyStopping;
         // paths of important files
         string netStructurePrototxtPath;
         string trainedWeightsCaffemodelPath;
         string solverParametersPrototxtPath;
-
+        // solver state (*.solverstate) training resumes from, "" : training starts at iteration 0
+        string solverStatePath;
+        // paths the currently loaded net was built from
+        string loadedNetStructurePrototxtPath;
+        string loadedTrainedWeightsCaffemodelPath;
+        // training : samples per iteration (0 : full batch), shuffling of in-memory samples
+        // and number of iterations (0 : max_iter of the solver prototxt)
+        int    batchSize;
+        bool   shuffle;
+        int    maxIterations;
+        // training : type of the solver ("SGD", "Nesterov", "AdaGrad", "RMSProp", "AdaDelta", "Adam",
+        // "LevenbergMarquardt", "LBFGS"), empty : the type of the solver prototxt
+        string solverType;
+        // training : number of threads, one replica of the net per thread (0 : all available cores)
+        int    numThreads;
+        // training : lock-free asynchronous updates of the threads instead of summed gradients
+        bool   asynchronous;
+        AsynchronousSGD::Report asynchronousReport;
+        LevenbergMarquardt::Report levenbergMarquardtReport;
+        // training : number of curvature pairs of the solver type "LBFGS"
+        int    lbfgsHistorySize;
+        LBFGS::Report lbfgsReport;
+        // training : share of the in-memory samples held out for validation (0 : no validation),
+        // iterations between validations, validations without improvement before training stops
+        // (0 : never) and validation error at which training stops (0 : none)
+        double validationFraction;
+        int    validationInterval;
+        int    patience;
+        double targetValidationError;
+        EarlyStopping::Report validationReport;
+        // training : wall-clock seconds per call of train (0 : unlimited) and token which cancels
+        // the training from another thread (nullptr : not cancellable)
+        double timeBudget;
+        CancellationToken* cancellationToken;
+        chrono::steady_clock::time_point deadline;
+        // training : set by the action function of solver_ when the iterations have to stop
+        bool   stopRequested;
+        StopReason stopReason;
+        // training : ring of the processes of a distributed training job (nullptr : not distributed)
+        RingAllReduce* ring;
+        // normalization of the input and expected output values, fitted by train and
+        // persisted next to the caffemodel
+        Normalizer::Method normalization;
+        Normalizer         inputNormalizer;
+        Normalizer         outputNormalizer;
 
         /* --- miscellaneous --- */
         void  setDataOfBLOB(Blob<double>* blobToModify_,int indexNum_, int indexChannel_, int indexHeight_, int indexWidth_, double value_);
+        void  fillTrainingBLOBs(DataSource& dataSource_, Blob<double>* inputDataBLOB_, Blob<double>* expectedOutputDataBLOB_);
+        void  fitNormalizers(DataSource& dataSource_);
+        bool  trainLevenbergMarquardt(DataSource& dataSource_, const SolverParameter& param_);
+        bool  trainLBFGS(DataSource& dataSource_, const SolverParameter& param_);
+        bool  trainInMemory(InMemoryDataSource& dataSource_);
+        bool  isInterrupted() const;
+        void  releaseSolver();
+        bool  loadNormalizers();
+        bool  saveNormalizers();
+        void  normalizeInputs   (double* inputValues_ , int num_, int numInputs_ );
+        void  denormalizeOutputs(double* outputValues_, int num_, int numOutputs_);
         double getDataOfBLOB(Blob<double>* blobToReadFrom_, int indexNum_, int indexChannel_, int indexHeight_, int indexWidth_);
 
 
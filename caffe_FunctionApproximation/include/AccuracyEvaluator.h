@@ -0,0 +1,95 @@
+#ifndef ACCURACYEVALUATOR_H
+#define ACCURACYEVALUATOR_H
+
+// STL
+#include <vector>
+#include <functional>
+#include <iostream>
+// own
+#include "MLP.h"
+#include "Domain.h"
+
+using namespace std;
+
+
+/**
+ * @brief The AccuracyEvaluator class - measures the error of a net against the true function
+ *
+ * Before a trained net is used, its root mean square error, its maximum error and the
+ * distribution of its errors are measured on a huge number of samples. The AccuracyEvaluator
+ * generates the samples on the fly (nothing is stored per sample), evaluates them batch by
+ * batch on several threads and reduces per-thread statistics and histograms at the end.
+ *
+ * The samples are taken from a domain either as
+ *   - GRID           : a regular grid with the same number of points in every dimension,
+ *                      including the bounds of the domain
+ *   - UNIFORM_RANDOM : uniformly distributed random points, reproducible by the seed
+ *   - SOBOL, HALTON  : scrambled low-discrepancy points (see QuasiRandomSampler), scrambled
+ *                      by the seed; they cover the domain more evenly than random points
+ *
+ * Every output neuron of every sample contributes one error value |ann(x) - reference(x)|.
+ * The histogram divides [0, histogramRange) into numBuckets buckets of equal width, errors
+ * greater or equal to histogramRange are counted in an additional overflow bucket.
+ *
+ * Errors which are not finite (the net or the reference function returns NaN or infinity)
+ * count as infinite : maxError is infinity, worstInput is the first such input and they are
+ * counted in the overflow bucket and in numNonFiniteErrors. The root mean square error and
+ * the mean absolute error are computed from the finite errors only.
+ *
+ */
+class AccuracyEvaluator {
+    public:
+        enum Sampling {
+            GRID,
+            UNIFORM_RANDOM,
+            SOBOL,
+            HALTON
+        };
+
+        struct Report {
+            unsigned long long         numSamples;
+            unsigned long long         numErrors;
+            unsigned long long         numNonFiniteErrors;
+            double                     rootMeanSquareError;
+            double                     meanAbsoluteError;
+            double                     maxError;
+            vector<double>             worstInput;
+            double                     histogramRange;
+            vector<unsigned long long> histogram;
+            double                     seconds;
+
+            Report() : numSamples(0), numErrors(0), numNonFiniteErrors(0), rootMeanSquareError(0), meanAbsoluteError(0),
+                       maxError(0), histogramRange(0), seconds(0) {};
+
+            void print(ostream& oStream_) const;
+        };
+
+        /* --- constructors / destructors --- */
+        AccuracyEvaluator(const MLP& mlp_, const function<vector<double>(const vector<double>&)>& referenceFunction_);
+
+        /* --- getter / setter --- */
+        int                getNumThreads() const {return numThreads;};
+        int                getBatchSize () const {return batchSize ;};
+        unsigned long long getSeed      () const {return seed      ;};
+
+        void setNumThreads(int val_) {numThreads = val_;};
+        void setBatchSize (int val_) {batchSize  = (val_ > 0) ? val_ : 1;};
+        void setSeed      (unsigned long long val_) {seed = val_;};
+        void setHistogram (int numBuckets_, double histogramRange_);
+
+        /* --- evaluation --- */
+        Report evaluate(const Domain& domain_, unsigned long long numSamples_, Sampling sampling_);
+
+    private:
+        const MLP& mlp;
+        function<vector<double>(const vector<double>&)> referenceFunction;
+        int    numThreads;
+        int    batchSize;
+        int    numBuckets;
+        double histogramRange;
+        unsigned long long seed;
+
+};
+
+
+#endif // ACCURACYEVALUATOR_H
@@ -0,0 +1,95 @@
+#ifndef ADAPTIVETRAINER_H
+#define ADAPTIVETRAINER_H
+
+// STL
+#include <vector>
+#include <functional>
+#include <iostream>
+// own
+#include "ANN.h"
+#include "Domain.h"
+
+using namespace std;
+
+
+/**
+ * @brief The AdaptiveTrainer class - trains an ANN on samples placed where its error is largest
+ *
+ * A uniformly sampled training set spends most samples in regions which the net already
+ * approximates well, e.g. the flat parts of sin over a wide range. The AdaptiveTrainer starts
+ * with a small low-discrepancy training set and alternates between
+ *   1. training the net for getIterationsPerRound() iterations on the current training set
+ *   2. measuring the residual |ann(x) - target(x)| on a fresh pool of candidate points
+ *   3. adding the getSamplesPerRound() candidates with the largest residuals to the training set
+ * until the maximum residual on the candidate pool reaches the target error or the maximum number
+ * of rounds is reached.
+ *
+ * If a sample budget is set (setMaxSamples) and the training set is full, the new candidates
+ * replace the training samples with the smallest residuals instead of being added, therefore
+ * the samples move to the difficult regions while their number stays fixed.
+ *
+ * NOTICE : the ANN needs a solver prototxt, training continues from its current weights
+ *
+ */
+class AdaptiveTrainer {
+    public:
+        struct Report {
+            int    numRounds;
+            int    numIterations;
+            int    numSamples;
+            double maxError;            // maximum residual on the last candidate pool
+            double rootMeanSquareError; // on the last candidate pool
+            bool   converged;
+            vector<double> maxErrors;   // maximum residual on the candidate pool of every round
+
+            Report() : numRounds(0), numIterations(0), numSamples(0), maxError(0), rootMeanSquareError(0), converged(false) {};
+
+            void print(ostream& oStream_) const;
+        };
+
+        /* --- constructors / destructors --- */
+        AdaptiveTrainer(ANN& ann_, const Domain& domain_, const function<double(const vector<double>&)>& targetFunction_);
+
+        /* --- getter / setter --- */
+        int    getInitialSamples     () const {return initialSamples     ;};
+        int    getSamplesPerRound    () const {return samplesPerRound    ;};
+        int    getCandidatePoolSize  () const {return candidatePoolSize  ;};
+        int    getIterationsPerRound () const {return iterationsPerRound ;};
+        int    getMaxRounds          () const {return maxRounds          ;};
+        int    getMaxSamples         () const {return maxSamples         ;};
+        double getTargetMaxError     () const {return targetMaxError     ;};
+        const vector<vector<double>>& getInputValues() const {return inputValues;};
+
+        void setInitialSamples    (int    val_) {initialSamples     = val_;};
+        void setSamplesPerRound   (int    val_) {samplesPerRound    = val_;};
+        void setCandidatePoolSize (int    val_) {candidatePoolSize  = val_;};
+        void setIterationsPerRound(int    val_) {iterationsPerRound = val_;};
+        void setMaxRounds         (int    val_) {maxRounds          = val_;};
+        void setMaxSamples        (int    val_) {maxSamples         = val_;};
+        void setTargetMaxError    (double val_) {targetMaxError     = val_;};
+        void setSeed              (unsigned long long val_) {seed = val_;};
+
+        /* --- training --- */
+        bool train(Report& report_);
+
+    private:
+        ANN&   ann;
+        Domain domain;
+        function<double(const vector<double>&)> targetFunction;
+        int    initialSamples;
+        int    samplesPerRound;
+        int    candidatePoolSize;
+        int    iterationsPerRound;
+        int    maxRounds;
+        int    maxSamples;
+        double targetMaxError;
+        unsigned long long seed;
+        // current training set
+        vector<vector<double>> inputValues;
+        vector<double>         expectedOutputValues;
+
+        vector<double> residuals(const vector<vector<double>>& inputValues_, const vector<double>& expectedOutputValues_);
+};
+
+
+#endif // ADAPTIVETRAINER_H
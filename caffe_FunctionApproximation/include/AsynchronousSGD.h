@@ -0,0 +1,111 @@
+#ifndef ASYNCHRONOUSSGD_H
+#define ASYNCHRONOUSSGD_H
+
+// STL
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <functional>
+#include <iostream>
+// caffe
+#include "caffe/caffe.hpp"
+#include "caffe/solver.hpp"
+#include "caffe/sgd_solvers.hpp"
+
+using namespace caffe;
+using namespace std;
+
+
+/**
+ * @brief The AsynchronousSGD class - lock-free asynchronous (Hogwild) training of one net on several threads
+ *
+ * The data-parallel training of DataParallelSync waits for all replicas in every iteration.
+ * For the tiny nets of function approximations the iterations take only microseconds, therefore
+ * the waiting dominates. AsynchronousSGD does not synchronize at all : every worker owns a solver
+ * (with its own momentum history) whose net shares the weights with the net of the given solver,
+ * and updates the shared weights without any lock as soon as its gradients are ready. Updates
+ * of different workers may overlap and are computed from weights which have been changed by
+ * other workers in between (stale gradients), which SGD tolerates for small learning rates.
+ *
+ * Worker 0 is the given solver, it runs on the thread calling run(). The other workers are
+ * created from the parameters of the given solver (of the same type, e.g. Adam) without
+ * tests, snapshots and display.
+ *
+ * The workers are monitored :
+ *   - staleness : number of updates of other workers between reading the weights (start of
+ *                 the forward pass) and updating them
+ *   - loss      : moving average of the loss of the iterations of every worker
+ * which is summarized in a Report and logged every display() iterations of the solver.
+ *
+ * NOTICE : the learning rate policy of every worker advances with its own iterations
+ *
+ */
+class AsynchronousSGD {
+    public:
+        struct Report {
+            int    numWorkers;
+            long   numUpdates;
+            double seconds;
+            double updatesPerSecond;
+            double meanStaleness;
+            long   maxStaleness;
+            double loss;            // mean of the moving averages of the workers
+
+            Report() : numWorkers(0), numUpdates(0), seconds(0), updatesPerSecond(0), meanStaleness(0), maxStaleness(0), loss(0) {};
+
+            void print(ostream& oStream_) const;
+        };
+
+        /* --- constructors / destructors --- */
+        AsynchronousSGD(Solver<double>* solver_, int numWorkers_);
+
+        AsynchronousSGD(const AsynchronousSGD&) = delete;
+        AsynchronousSGD& operator=(const AsynchronousSGD&) = delete;
+
+        /* --- getter / setter --- */
+        int          getNumWorkers() const {return numWorkers;};
+        Net<double>* getReplica   (int worker_);
+
+        /* --- training --- */
+        Report run(long numUpdates_, const function<void(Net<double>*)>& loadBatch_,
+                   const function<bool()>& stop_ = function<bool()>());
+
+    private:
+        /**
+         * @brief The Monitor class - measures the staleness and the loss of the iterations of one worker
+         */
+        class Monitor : public Solver<double>::Callback {
+            public:
+                Monitor(AsynchronousSGD& owner_, Solver<double>* solver_);
+
+                long   numUpdates;
+                long   sumStaleness;
+                long   maxStaleness;
+                double loss;
+
+            protected:
+                void on_start();
+                void on_gradients_ready();
+
+            private:
+                AsynchronousSGD& owner;
+                Solver<double>*  solver;
+                long             startUpdates;
+        };
+
+        Solver<double>*                              solver;
+        int                                          numWorkers;
+        vector<caffe::shared_ptr<Solver<double> > >  workerSolvers;
+        vector<caffe::shared_ptr<Monitor> >          monitors;
+        // number of updates which have been applied to the shared weights
+        atomic<long>                                 updates;
+        // number of iterations which have been claimed by the workers
+        atomic<long>                                 claimed;
+
+        /* --- miscellaneous --- */
+        void work(int worker_, long numUpdates_, const function<void(Net<double>*)>& loadBatch_, const function<bool()>& stop_);
+};
+
+
+#endif // ASYNCHRONOUSSGD_H
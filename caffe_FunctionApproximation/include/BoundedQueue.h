@@ -0,0 +1,86 @@
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+// STL
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <utility>
+
+using namespace std;
+
+
+/**
+ * @brief The BoundedQueue class - a thread-safe first-in-first-out queue with a fixed capacity
+ *
+ * BoundedQueue is used to hand over work packages (e.g. chunks of samples) between
+ * threads of a pipeline. As the capacity is fixed the memory used by the pipeline
+ * does not depend on the amount of data flowing through it:
+ *   - push() blocks while the queue is full
+ *   - pop()  blocks while the queue is empty
+ *
+ * A producer calls close() after pushing its last element. Afterwards push() refuses
+ * new elements and pop() returns false as soon as all remaining elements have been
+ * taken out of the queue.
+ *
+ */
+template <typename T>
+class BoundedQueue {
+    public:
+        /* --- constructors / destructors --- */
+        explicit BoundedQueue(size_t capacity_) : capacity(capacity_ > 0 ? capacity_ : 1), closed(false) {};
+
+        /* --- pushing / popping elements --- */
+
+        /**
+         * @brief push appends element_ to the queue, blocks while the queue is full
+         * @return returns false if the queue has been closed, otherwise true
+         */
+        bool push(T element_) {
+            unique_lock<mutex> lock(queueMutex);
+            notFull.wait(lock, [this] { return closed || (elements.size() < capacity); });
+            if (closed) {
+                return false;
+            }
+            elements.push_back(std::move(element_));
+            notEmpty.notify_one();
+            return true;
+        }
+
+        /**
+         * @brief pop takes the oldest element out of the queue, blocks while the queue is empty
+         * @return returns false if the queue is closed and empty, otherwise true
+         */
+        bool pop(T& element_) {
+            unique_lock<mutex> lock(queueMutex);
+            notEmpty.wait(lock, [this] { return closed || !elements.empty(); });
+            if (elements.empty()) {
+                return false;
+            }
+            element_ = std::move(elements.front());
+            elements.pop_front();
+            notFull.notify_one();
+            return true;
+        }
+
+        /**
+         * @brief close marks the end of the stream and wakes up all waiting threads
+         */
+        void close() {
+            lock_guard<mutex> lock(queueMutex);
+            closed = true;
+            notFull.notify_all();
+            notEmpty.notify_all();
+        }
+
+    private:
+        size_t   capacity;
+        bool     closed;
+        deque<T> elements;
+        mutex    queueMutex;
+        condition_variable notFull;
+        condition_variable notEmpty;
+};
+
+
+#endif // BOUNDEDQUEUE_H
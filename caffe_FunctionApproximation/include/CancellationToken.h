@@ -0,0 +1,40 @@
+#ifndef CANCELLATIONTOKEN_H
+#define CANCELLATIONTOKEN_H
+
+// STL
+#include <atomic>
+
+using namespace std;
+
+
+/**
+ * @brief The CancellationToken class - requests a running training to stop from another thread
+ *
+ * The training (see ANN::setCancellationToken) polls isCancelled() after every iteration and
+ * stops cleanly, i.e. it saves the weights trained so far. cancel() may be called from any
+ * thread at any time, it only sets an atomic flag and returns immediately.
+ *
+ * NOTICE : the token stays cancelled until reset() is called, a cancelled token stops every
+ *          training it is set for before the first iteration
+ *
+ */
+class CancellationToken {
+    public:
+        /* --- constructors / destructors --- */
+        CancellationToken() : cancelled(false) {};
+
+        CancellationToken(const CancellationToken&) = delete;
+        CancellationToken& operator=(const CancellationToken&) = delete;
+
+        /* --- getter / setter --- */
+        bool isCancelled() const {return cancelled.load(memory_order_relaxed);};
+
+        void cancel() {cancelled.store(true ,memory_order_relaxed);};
+        void reset () {cancelled.store(false,memory_order_relaxed);};
+
+    private:
+        atomic<bool> cancelled;
+};
+
+
+#endif // CANCELLATIONTOKEN_H
@@ -0,0 +1,88 @@
+#ifndef COLUMNARDATASET_H
+#define COLUMNARDATASET_H
+
+// STL
+#include <vector>
+#include <string>
+#include <cstddef>
+
+using namespace std;
+
+
+/**
+ * @brief The ColumnarDataSet class - a binary, memory-mappable file format for data sets
+ *
+ * A data set consists of numInputs input columns followed by numOutputs expected output
+ * columns of doubles. The file (native byte order) is laid out as
+ *
+ *     file header   : magic "FADATA01", version, number of rows, columns and input columns
+ *     column header : per column its name, the offset of its values within the file and the
+ *                     minimum, maximum, mean and standard deviation of its values
+ *     columns       : the values of every column, each column starting at a multiple of
+ *                     getAlignment() bytes
+ *
+ * Opening a data set maps the file into memory and only reads the headers, the values are
+ * accessed in place by getColumnData() without any parsing or copying. The statistics in
+ * the header are calculated once when the file is written.
+ *
+ * For the headerless columnar files of StreamingEvaluator::RAW_BINARY, openRaw() maps the
+ * file in the same way, without names and statistics.
+ *
+ */
+class ColumnarDataSet {
+    public:
+        struct Column {
+            string name;
+            double minimum;
+            double maximum;
+            double mean;
+            double standardDeviation;
+
+            Column() : minimum(0), maximum(0), mean(0), standardDeviation(0) {};
+        };
+
+        /* --- constructors / destructors --- */
+        ColumnarDataSet();
+        ~ColumnarDataSet();
+
+        ColumnarDataSet(const ColumnarDataSet&) = delete;
+        ColumnarDataSet& operator=(const ColumnarDataSet&) = delete;
+
+        /* --- opening / closing --- */
+        bool open   (const string& path_);
+        bool openRaw(const string& path_, int numInputs_, int numOutputs_);
+        void close  ();
+
+        /* --- getter / setter --- */
+        bool          isOpen       () const {return mapped != nullptr;};
+        size_t        getNumRows   () const {return numRows   ;};
+        int           getNumColumns() const {return (int)columns.size();};
+        int           getNumInputs () const {return numInputs ;};
+        int           getNumOutputs() const {return getNumColumns() - numInputs;};
+        const Column& getColumn    (int index_) const {return columns[index_];};
+        const double* getColumnData(int index_) const {return columnData[index_];};
+
+        static size_t getAlignment() {return 4096;};
+
+        /* --- access to the pages of the file --- */
+        void advise(size_t firstRow_, size_t numRows_, int advice_) const;
+
+        /* --- writing / converting --- */
+        static bool write(const string& path_, const vector<string>& columnNames_, int numInputs_,
+                          const vector<vector<double>>& columns_);
+        static bool convertFromCSV(const string& csvPath_, const string& path_, int numInputs_);
+        static bool convertToCSV  (const string& path_, const string& csvPath_);
+
+    private:
+        const char*           mapped;
+        size_t                mappedSize;
+        size_t                numRows;
+        int                   numInputs;
+        vector<Column>        columns;
+        vector<const double*> columnData;
+
+        bool map(const string& path_);
+};
+
+
+#endif // COLUMNARDATASET_H
@@ -0,0 +1,104 @@
+#ifndef CSVIO_H
+#define CSVIO_H
+
+// STL
+#include <vector>
+#include <string>
+#include <fstream>
+#include <functional>
+
+using namespace std;
+
+
+/**
+ * @brief The CsvWriter class - buffered, locale-independent writing of csv-files
+ *
+ * Writing rows by ofstream << value << endl flushes the file on every line and formats the
+ * values with 6 significant digits and the decimal separator of the current locale. The
+ * CsvWriter collects the rows in a big buffer, which is written in large blocks, and formats
+ * every value with the fewest significant digits (15, 16 or 17) which read back to exactly
+ * the same double, always with '.' as decimal separator.
+ *
+ * writeRows() formats a block of rows on several threads.
+ *
+ */
+class CsvWriter {
+    public:
+        /* --- constructors / destructors --- */
+        explicit CsvWriter(const string& path_, size_t bufferSize_ = 1 << 20);
+        ~CsvWriter();
+
+        CsvWriter(const CsvWriter&) = delete;
+        CsvWriter& operator=(const CsvWriter&) = delete;
+
+        /* --- getter / setter --- */
+        bool isOpen       () const {return oFile.is_open();};
+        int  getNumThreads() const {return numThreads    ;};
+
+        void setNumThreads(int val_) {numThreads = val_;};
+
+        /* --- writing --- */
+        void writeHeader(const vector<string>& columnNames_);
+        void writeRow   (const double* values_, int numValues_);
+        void writeRow   (const vector<double>& values_);
+        void writeRows  (const double* values_, size_t numRows_, int numColumns_);
+        bool flush();
+        bool close();
+
+        static int formatDouble(double value_, char* buffer_);
+
+    private:
+        ofstream     oFile;
+        vector<char> buffer;
+        size_t       used;
+        bool         failed;
+        int          numThreads;
+
+        void append(const char* text_, size_t length_);
+};
+
+
+/**
+ * @brief The CsvReader class - fast, locale-independent reading of csv-files with numeric values
+ *
+ * The whole file is read at once and split into one part per thread at line boundaries. The
+ * parts are parsed in parallel and concatenated afterwards. The values are converted by a
+ * parser which handles the common case (at most 19 significant digits, small exponents)
+ * exactly by integer arithmetic and falls back to strtod in the "C" locale otherwise.
+ *
+ * A non-numeric first line holds the column names. Empty lines are skipped, every other line
+ * has to contain the same number of values.
+ *
+ */
+class CsvReader {
+    public:
+        /* --- constructors / destructors --- */
+        CsvReader();
+
+        /* --- getter / setter --- */
+        int                   getNumThreads () const {return numThreads ;};
+        int                   getNumColumns () const {return numColumns ;};
+        size_t                getNumRows    () const {return numColumns > 0 ? values.size() / numColumns : 0;};
+        const vector<string>& getColumnNames() const {return columnNames;};
+        const vector<double>& getValues     () const {return values     ;};
+
+        void setNumThreads(int val_) {numThreads = val_;};
+
+        /* --- reading --- */
+        bool read      (const string& path_);
+        bool readBlocks(const string& path_, size_t rowsPerBlock_, const function<bool(const double* values_, size_t numRows_)>& block_);
+
+        vector<double>         getColumn(int index_) const;
+        vector<vector<double>> getRows  (int firstColumn_, int numColumns_) const;
+
+        static const char* parseDouble(const char* position_, const char* end_, double& value_);
+
+    private:
+        int            numThreads;
+        int            numColumns;
+        vector<string> columnNames;
+        vector<double> values;
+};
+
+
+#endif // CSVIO_H
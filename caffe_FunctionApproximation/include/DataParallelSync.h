@@ -0,0 +1,86 @@
+#ifndef DATAPARALLELSYNC_H
+#define DATAPARALLELSYNC_H
+
+// STL
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+// caffe
+#include "caffe/caffe.hpp"
+#include "caffe/solver.hpp"
+
+using namespace caffe;
+using namespace std;
+
+
+/**
+ * @brief The DataParallelSync class - data-parallel training of one solver on several threads
+ *
+ * The nets of function approximations are small, therefore the matrix products of one
+ * iteration are too small to be parallelized by the BLAS library. Instead the samples of an
+ * iteration are split into shards which are processed by replicas of the net:
+ *   - replica 0 is the net of the solver, it is run by the thread calling Step / Solve
+ *   - replicas 1 .. getNumReplicas()-1 are own nets, each run by an own worker thread,
+ *     which share the weights (not the gradients) with the net of the solver
+ *
+ * The sync is registered as callback of the solver. When an iteration starts (on_start) the
+ * workers run forward and backward on their shards, while the solver does the same on shard 0.
+ * When the gradients are ready (on_gradients_ready) they are summed by a binary tree : in round
+ * k replica r (r a multiple of 2^(k+1)) adds the gradients of replica r + 2^k, therefore the sum
+ * is complete after log2(N) rounds and all replicas take part in it. Every replica waits for its
+ * partner by spinning on an atomic counter, no lock is taken. Afterwards the solver updates the
+ * shared weights with the summed gradients. Between the iterations the workers sleep on a
+ * condition variable, therefore they do not take any core while the solver is not stepping.
+ *
+ * The gradients of every replica are weighted by the share of its samples in the iteration,
+ * therefore the summed gradient equals the gradient of all samples processed by one net.
+ *
+ * NOTICE : the input BLOBs of every replica (see getReplica) have to be filled before every
+ *          iteration, the sync does not load any data
+ * NOTICE : the workers spin while waiting for their partners, therefore the number of replicas
+ *          should not exceed the number of cores
+ *
+ */
+class DataParallelSync : public Solver<double>::Callback {
+    public:
+        /* --- constructors / destructors --- */
+        DataParallelSync(Solver<double>* solver_, int numReplicas_);
+        ~DataParallelSync();
+
+        DataParallelSync(const DataParallelSync&) = delete;
+        DataParallelSync& operator=(const DataParallelSync&) = delete;
+
+        /* --- getter / setter --- */
+        int          getNumReplicas() const {return numReplicas;};
+        Net<double>* getReplica    (int replica_);
+
+    protected:
+        /* --- solver callbacks --- */
+        void on_start();
+        void on_gradients_ready();
+
+    private:
+        Solver<double>*                  solver;
+        int                              numReplicas;
+        vector<caffe::shared_ptr<Net<double> > > replicas;
+        vector<thread>                   workers;
+        vector<double>                   weights;
+        // number of the current iteration, the workers start when it is increased
+        atomic<long>                     generation;
+        // per replica : number of the iteration whose gradients of the subtree are summed
+        unique_ptr<atomic<long>[]>       reduced;
+        atomic<bool>                     stopping;
+        // wakes the idle workers when an iteration starts or the sync is destroyed
+        mutex                            generationMutex;
+        condition_variable               generationChanged;
+
+        /* --- miscellaneous --- */
+        void work  (int replica_);
+        void reduce(int replica_, long generation_);
+};
+
+
+#endif // DATAPARALLELSYNC_H
@@ -0,0 +1,92 @@
+#ifndef DATASOURCE_H
+#define DATASOURCE_H
+
+// STL
+#include <vector>
+#include <random>
+// own
+#include "Matrix.h"
+
+using namespace std;
+
+
+/**
+ * @brief The DataSource class - interface of all sources of training samples
+ *
+ * ANN::train takes its samples from a DataSource batch by batch. Every call of nextBatch()
+ * writes the next batchSize_ samples into the given buffers :
+ *   - inputValues_  : batchSize_ * getNumInputs()  values, one row per sample
+ *   - outputValues_ : batchSize_ * getNumOutputs() values, one row per sample
+ *
+ * A source either holds a finite number of samples (getNumSamples() > 0) and starts over
+ * once all samples have been delivered (the next epoch), or it is unbounded
+ * (getNumSamples() == 0) and generates new samples for every batch. rewind() lets the next
+ * batch of a finite source start a new epoch, e.g. after a pass which only collected statistics.
+ *
+ */
+class DataSource {
+    public:
+        /* --- constructors / destructors --- */
+        virtual ~DataSource() {};
+
+        /* --- getter / setter --- */
+        virtual int                getNumInputs () const = 0;
+        virtual int                getNumOutputs() const = 0;
+        virtual unsigned long long getNumSamples() const = 0;
+
+        /* --- reading samples --- */
+        virtual void nextBatch(int batchSize_, double* inputValues_, double* outputValues_) = 0;
+        virtual void rewind() {};
+};
+
+
+/**
+ * @brief The InMemoryDataSource class - a DataSource for samples which are kept in main memory
+ *
+ * The samples are copied into two contiguous arrays. If shuffling is enabled (default), the
+ * order of the samples is permuted randomly at the beginning of every epoch. A batch which
+ * reaches the end of an epoch is completed by the first samples of the next epoch, therefore
+ * every batch has the requested size.
+ *
+ */
+class InMemoryDataSource : public DataSource {
+    public:
+        /* --- constructors / destructors --- */
+        InMemoryDataSource(const vector<double>& inputValues_, const vector<double>& outputValues_);
+        InMemoryDataSource(const vector<vector<double>>& inputValues_, const vector<double>& outputValues_);
+        InMemoryDataSource(const vector<vector<double>>& inputValues_, const vector<vector<double>>& outputValues_);
+        InMemoryDataSource(const MatrixView& inputValues_, const MatrixView& outputValues_);
+
+        /* --- getter / setter --- */
+        int                getNumInputs () const {return numInputs ;};
+        int                getNumOutputs() const {return numOutputs;};
+        unsigned long long getNumSamples() const {return numSamples;};
+        bool               getShuffle   () const {return shuffle   ;};
+
+        void setShuffle(bool val_) {shuffle = val_;};
+        void setSeed   (unsigned int val_) {generator.seed(val_);};
+
+        /* --- reading samples --- */
+        void nextBatch(int batchSize_, double* inputValues_, double* outputValues_);
+        void rewind   () {position = 0;};
+
+        /* --- miscellaneous --- */
+        InMemoryDataSource holdOut(double fraction_, unsigned int seed_ = 0);
+
+    private:
+        int    numInputs;
+        int    numOutputs;
+        size_t numSamples;
+        vector<double> inputValues;
+        vector<double> outputValues;
+        // order of the samples within the current epoch
+        vector<size_t> order;
+        size_t         position;
+        bool           shuffle;
+        mt19937        generator;
+
+        void startEpoch();
+};
+
+
+#endif // DATASOURCE_H
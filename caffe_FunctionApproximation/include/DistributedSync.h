@@ -0,0 +1,61 @@
+#ifndef DISTRIBUTEDSYNC_H
+#define DISTRIBUTEDSYNC_H
+
+// STL
+#include <vector>
+// caffe
+#include "caffe/caffe.hpp"
+#include "caffe/solver.hpp"
+// own
+#include "RingAllReduce.h"
+
+using namespace caffe;
+using namespace std;
+
+
+/**
+ * @brief The DistributedSync class - synchronizes the solvers of the ranks of a distributed training job
+ *
+ * Every rank trains its own solver on its own samples. The sync is registered as callback of
+ * the solver and sums the gradients of all ranks (RingAllReduce) before the weights are
+ * updated, therefore all ranks do identical updates and their weights stay equal. When the
+ * sync is created, the weights of rank 0 are copied to all ranks.
+ *
+ * The gradients of every rank are weighted by the number of samples of its iteration,
+ * therefore the summed gradient equals the gradient of all samples of all ranks.
+ *
+ * NOTICE : if the exchange with the other ranks fails, an error is printed, the gradients of
+ *          the rank are used unchanged and isValid() returns false
+ *
+ */
+class DistributedSync : public Solver<double>::Callback {
+    public:
+        /* --- constructors / destructors --- */
+        DistributedSync(Solver<double>* solver_, RingAllReduce& ring_);
+
+        DistributedSync(const DistributedSync&) = delete;
+        DistributedSync& operator=(const DistributedSync&) = delete;
+
+        /* --- getter / setter --- */
+        bool isValid      () const {return valid     ;};
+        int  getNumSamples() const {return numSamples;};
+
+        void setNumSamples(int val_) {numSamples = val_;};
+
+    protected:
+        /* --- solver callbacks --- */
+        void on_start() {};
+        void on_gradients_ready();
+
+    private:
+        Solver<double>* solver;
+        RingAllReduce&  ring;
+        bool            valid;
+        // samples of an iteration of this rank (0 : the samples of the input BLOB of the solver)
+        int             numSamples;
+        // gradients of all learnable parameters followed by the number of samples
+        vector<double>  buffer;
+};
+
+
+#endif // DISTRIBUTEDSYNC_H
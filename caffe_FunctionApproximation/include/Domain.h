@@ -0,0 +1,51 @@
+#ifndef DOMAIN_H
+#define DOMAIN_H
+
+// STL
+#include <vector>
+
+using namespace std;
+
+
+/**
+ * @brief The Domain struct - an axis-aligned box within the input space of a net
+ *
+ * A domain is described by a lower and an upper bound for every input dimension.
+ * It is used to describe the range of input values a net is trained, evaluated
+ * or verified on, e.g. [-2,2] x [-2,2] for the multi-input tests.
+ *
+ */
+struct Domain {
+    vector<double> lowerBounds;
+    vector<double> upperBounds;
+
+    Domain() {};
+    Domain(const vector<double>& lowerBounds_, const vector<double>& upperBounds_)
+        : lowerBounds(lowerBounds_), upperBounds(upperBounds_) {};
+
+    int    dimension()        const {return (int)lowerBounds.size();};
+    double width(int index_)  const {return upperBounds[index_] - lowerBounds[index_];};
+
+    vector<double> center() const {
+        vector<double> result(lowerBounds.size());
+        for (unsigned int i = 0; i < lowerBounds.size(); i++) {
+            result[i] = 0.5 * (lowerBounds[i] + upperBounds[i]);
+        }
+        return result;
+    }
+
+    bool contains(const vector<double>& point_) const {
+        if (point_.size() != lowerBounds.size()) {
+            return false;
+        }
+        for (unsigned int i = 0; i < point_.size(); i++) {
+            if (point_[i] < lowerBounds[i] || point_[i] > upperBounds[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+
+#endif // DOMAIN_H
@@ -0,0 +1,90 @@
+#ifndef EARLYSTOPPING_H
+#define EARLYSTOPPING_H
+
+// STL
+#include <vector>
+#include <iostream>
+// caffe
+#include "caffe/caffe.hpp"
+#include "caffe/solver.hpp"
+
+using namespace caffe;
+using namespace std;
+
+
+/**
+ * @brief The EarlyStopping class - stops the training of a solver when the error on validation samples stops improving
+ *
+ * The validation error is the loss of a validation net on samples which are not trained.
+ * The validation net is built from the net of the solver prototxt (see SolverNet) in the TEST phase and shares
+ * the weights with the net of the solver, therefore an evaluation costs one forward pass and
+ * no copy of the weights. Its input BLOBs (see getValidationNet) have to be filled once with
+ * the validation samples.
+ *
+ * shouldStop() is meant to be called after every iteration of the solver (e.g. by the action
+ * function of the solver). Every getInterval() iterations it evaluates the validation error and
+ * keeps a copy of the weights with the lowest error so far. It requests to stop if
+ *   - the validation error is at most getTargetError() (target reached), or
+ *   - the validation error has not improved for getPatience() evaluations (plateau)
+ * After training restoreBestWeights() copies the best weights back into the net of the solver.
+ *
+ * NOTICE : a target error <= 0 or a patience <= 0 disables the corresponding criterion
+ * NOTICE : the validation error is measured in the normalized units of the training (see
+ *          ANN::setNormalization), as the validation samples are normalized like the
+ *          training samples
+ *
+ */
+class EarlyStopping {
+    public:
+        struct Report {
+            int    numEvaluations;
+            int    bestIteration;
+            double bestError;
+            double lastError;
+            bool   targetReached;
+            bool   stoppedEarly;    // the training has been stopped before max_iter
+
+            Report() : numEvaluations(0), bestIteration(0), bestError(0), lastError(0), targetReached(false), stoppedEarly(false) {};
+
+            void print(ostream& oStream_) const;
+        };
+
+        /* --- constructors / destructors --- */
+        EarlyStopping(Solver<double>* solver_);
+
+        EarlyStopping(const EarlyStopping&) = delete;
+        EarlyStopping& operator=(const EarlyStopping&) = delete;
+
+        /* --- getter / setter --- */
+        int           getInterval     () const {return interval   ;};
+        int           getPatience     () const {return patience   ;};
+        double        getTargetError  () const {return targetError;};
+        const Report& getReport       () const {return report     ;};
+        Net<double>*  getValidationNet()       {return validationNet.get();};
+
+        void setInterval   (int    val_) {interval    = val_;};
+        void setPatience   (int    val_) {patience    = val_;};
+        void setTargetError(double val_) {targetError = val_;};
+
+        /* --- validation --- */
+        double validate();
+        bool   shouldStop();
+        void   restoreBestWeights();
+
+    private:
+        Solver<double>*                     solver;
+        caffe::shared_ptr<Net<double> >     validationNet;
+        int                                 interval;
+        int                                 patience;
+        double                              targetError;
+        Report                              report;
+        // weights of the evaluation with the lowest validation error
+        vector<double>                      bestWeights;
+        // iteration of the last evaluation (-1 : not evaluated yet)
+        int                                 lastIteration;
+        // evaluations since the last improvement of the validation error
+        int                                 numWithoutImprovement;
+};
+
+
+#endif // EARLYSTOPPING_H
@@ -0,0 +1,84 @@
+#ifndef GENERATORDATASOURCE_H
+#define GENERATORDATASOURCE_H
+
+// STL
+#include <vector>
+#include <thread>
+#include <memory>
+#include <functional>
+// own
+#include "DataSource.h"
+#include "Domain.h"
+#include "BoundedQueue.h"
+
+using namespace std;
+
+
+/**
+ * @brief The GeneratorDataSource class - an unbounded DataSource which generates fresh samples
+ *
+ * Instead of materializing a data set, e.g. by sampling sin(x) on a grid, the samples are
+ * generated while training : producer threads draw uniformly distributed random input values
+ * within the domain and calculate the expected output values by the target function. Every
+ * batch consists of samples the net has never seen before and no memory is needed for a data
+ * set, only for a few chunks of samples in flight.
+ *
+ * The producer threads are started by the first call of nextBatch(). Every producer uses its
+ * own random generator, seeded by the seed of the source and the index of the producer.
+ *
+ * NOTICE : the target function is called from several threads at the same time and
+ *          therefore has to be thread-safe
+ * NOTICE : getNumSamples() returns 0 (unbounded), ANN::train needs a batch size to use it
+ *
+ */
+class GeneratorDataSource : public DataSource {
+    public:
+        /* --- constructors / destructors --- */
+        GeneratorDataSource(const Domain& domain_, const function<vector<double>(const vector<double>&)>& targetFunction_,
+                            int numOutputs_ = 1);
+        ~GeneratorDataSource();
+
+        GeneratorDataSource(const GeneratorDataSource&) = delete;
+        GeneratorDataSource& operator=(const GeneratorDataSource&) = delete;
+
+        /* --- getter / setter --- */
+        int                getNumInputs () const {return domain.dimension();};
+        int                getNumOutputs() const {return numOutputs        ;};
+        unsigned long long getNumSamples() const {return 0                 ;};
+        int                getNumThreads() const {return numThreads        ;};
+        int                getChunkSize () const {return chunkSize         ;};
+
+        void setNumThreads(int val_) {numThreads = val_;};
+        void setChunkSize (int val_) {chunkSize  = (val_ > 0) ? val_ : 1;};
+        void setSeed      (unsigned long long val_) {seed = val_;};
+
+        /* --- reading samples --- */
+        void nextBatch(int batchSize_, double* inputValues_, double* outputValues_);
+
+    private:
+        struct Chunk {
+            size_t         numSamples;
+            vector<double> inputValues;
+            vector<double> outputValues;
+
+            Chunk() : numSamples(0) {};
+        };
+
+        Domain domain;
+        function<vector<double>(const vector<double>&)> targetFunction;
+        int    numOutputs;
+        int    numThreads;
+        int    chunkSize;
+        unsigned long long seed;
+        // generated samples which have not been used completely yet
+        unique_ptr<BoundedQueue<Chunk>> generatedChunks;
+        vector<thread> producers;
+        Chunk  currentChunk;
+        size_t positionInChunk;
+
+        void start();
+        void produce(int producerIndex_);
+};
+
+
+#endif // GENERATORDATASOURCE_H
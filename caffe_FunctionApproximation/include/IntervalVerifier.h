@@ -0,0 +1,98 @@
+#ifndef INTERVALVERIFIER_H
+#define INTERVALVERIFIER_H
+
+// STL
+#include <vector>
+#include <functional>
+// own
+#include "MLP.h"
+#include "Domain.h"
+
+using namespace std;
+
+
+/**
+ * @brief The IntervalVerifier class - certifies the maximum error of a net over a domain
+ *
+ * Checking a net on a dense grid of samples (as done in main.cpp) is expensive and gives no
+ * guarantee for the values between the samples. The IntervalVerifier uses interval bound
+ * propagation instead : the whole box of input values is propagated through the
+ * InnerProduct/activation stack, which results in guaranteed lower and upper bounds of
+ * every output neuron over the box.
+ *
+ * Together with bounds of the reference function this gives an upper bound of the
+ * approximation error over the box. Boxes whose bound is loose are split adaptively
+ * (branch and bound), until the maximum error is enclosed within the requested tolerance :
+ *
+ *     lowerBound <= max |ann(x) - reference(x)| <= upperBound    for all x within the domain
+ *
+ * The lower bound is the largest error actually observed at the centers of the boxes,
+ * the upper bound is the largest bound of all boxes which have not been split any further.
+ *
+ * The reference function is bounded over a box either by
+ *   - a Lipschitz constant L : |reference(x) - reference(y)| <= L * max_i |x_i - y_i|
+ *   - a user-defined interval extension, which returns bounds of every output over a box
+ * The observed errors (and therefore the lower bound) always need the reference function itself.
+ *
+ * NOTICE : the bounds are calculated in ordinary floating point arithmetic without directed
+ *          rounding, therefore they are exact up to rounding errors of the order of 1e-15
+ *
+ */
+class IntervalVerifier {
+    public:
+        struct Interval {
+            double lower;
+            double upper;
+
+            Interval() : lower(0), upper(0) {};
+            Interval(double lower_, double upper_) : lower(lower_), upper(upper_) {};
+        };
+
+        struct Result {
+            bool           certified;   // true if upperBound - lowerBound <= tolerance
+            double         lowerBound;  // largest observed error
+            double         upperBound;  // guaranteed bound of the error
+            vector<double> worstInput;  // input value of the largest observed error
+            int            numBoxes;    // number of boxes which have been evaluated
+
+            Result() : certified(false), lowerBound(0), upperBound(0), numBoxes(0) {};
+        };
+
+        /* --- constructors / destructors --- */
+        explicit IntervalVerifier(const MLP& mlp_);
+
+        /* --- getter / setter --- */
+        double getTolerance() const {return tolerance;};
+        int    getMaxBoxes () const {return maxBoxes ;};
+
+        void setTolerance(double val_) {tolerance = val_;};
+        void setMaxBoxes (int    val_) {maxBoxes  = val_;};
+        void setReferenceFunction(const function<vector<double>(const vector<double>&)>& referenceFunction_, double lipschitzConstant_);
+        void setReferenceBounds  (const function<vector<Interval>(const Domain&)>& referenceBounds_) {referenceBounds = referenceBounds_;};
+
+        /* --- verification --- */
+        vector<Interval> propagate(const Domain& box_) const;
+        Result certifyMaxError(const Domain& domain_) const;
+
+    private:
+        // a box together with the bound of the error on it
+        struct Box {
+            Domain domain;
+            double errorBound;
+
+            bool operator<(const Box& other_) const {return errorBound < other_.errorBound;};
+        };
+
+        const MLP& mlp;
+        double tolerance;
+        int    maxBoxes;
+        double lipschitzConstant;
+        function<vector<double>(const vector<double>&)> referenceFunction;
+        function<vector<Interval>(const Domain&)>       referenceBounds;
+
+        Box evaluateBox(const Domain& box_, Result& result_) const;
+
+};
+
+
+#endif // INTERVALVERIFIER_H
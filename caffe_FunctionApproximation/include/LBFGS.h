@@ -0,0 +1,97 @@
+#ifndef LBFGS_H
+#define LBFGS_H
+
+// STL
+#include <vector>
+#include <deque>
+#include <functional>
+#include <iostream>
+
+using namespace std;
+
+
+/**
+ * @brief The LBFGS class - limited-memory BFGS minimization of a smooth function
+ *
+ * L-BFGS approximates the inverse Hessian of the function by the last getHistorySize() pairs
+ * of steps s = x_{k+1} - x_k and gradient changes y = g_{k+1} - g_k (two-loop recursion),
+ * therefore it needs only O(historySize * n) memory and converges much faster than gradient
+ * descent without any learning rate. The step length along the search direction is found by
+ * a line search which satisfies the strong Wolfe conditions
+ *
+ *     f(x + t * d) <= f(x) + c1 * t * g^T d           (sufficient decrease)
+ *     |g(x + t * d)^T d| <= c2 * |g^T d|              (curvature)
+ *
+ * (bracketing followed by zooming with safeguarded cubic interpolation, Nocedal & Wright,
+ * algorithms 3.5 and 3.6), which guarantees s^T y > 0, i.e. a positive definite approximation.
+ *
+ * The function is given as objective, which returns the function value at x_ and writes the
+ * gradient into gradient_. The minimization is deterministic.
+ *
+ */
+class LBFGS {
+    public:
+        typedef function<double(const vector<double>& x_, vector<double>& gradient_)> Objective;
+
+        struct Report {
+            int    numIterations;
+            int    numEvaluations;
+            double initialLoss;
+            double loss;
+            double gradientNorm;    // maximum norm
+            double seconds;
+            bool   converged;
+
+            Report() : numIterations(0), numEvaluations(0), initialLoss(0), loss(0), gradientNorm(0), seconds(0), converged(false) {};
+
+            void print(ostream& oStream_) const;
+        };
+
+        /* --- constructors / destructors --- */
+        LBFGS();
+
+        /* --- getter / setter --- */
+        int    getHistorySize      () const {return historySize      ;};
+        int    getMaxIterations    () const {return maxIterations    ;};
+        double getGradientTolerance() const {return gradientTolerance;};
+        double getTolerance        () const {return tolerance        ;};
+
+        void setHistorySize      (int    val_) {historySize       = val_;};
+        void setMaxIterations    (int    val_) {maxIterations     = val_;};
+        void setGradientTolerance(double val_) {gradientTolerance = val_;};
+        void setTolerance        (double val_) {tolerance         = val_;};
+
+        /* --- minimization --- */
+        bool minimize(vector<double>& x_, const Objective& objective_, Report& report_);
+
+    private:
+        struct Point {
+            double         t;          // step length
+            double         value;      // f(x + t * d)
+            double         slope;      // g(x + t * d)^T d
+            vector<double> x;
+            vector<double> gradient;
+        };
+
+        int    historySize;
+        int    maxIterations;
+        // minimization stops if the maximum norm of the gradient is below gradientTolerance
+        double gradientTolerance;
+        // minimization stops if an iteration changes the function value by less than tolerance * |f|
+        double tolerance;
+        // parameters of the strong Wolfe conditions
+        double c1;
+        double c2;
+        int    maxLineSearchEvaluations;
+
+        /* --- miscellaneous --- */
+        bool lineSearch(const Point& start_, const vector<double>& direction_, double initialStep_,
+                        const Objective& objective_, Point& result_, int& numEvaluations_) const;
+        void evaluate(const Point& start_, const vector<double>& direction_, double t_,
+                      const Objective& objective_, Point& point_) const;
+        static double interpolate(const Point& a_, const Point& b_);
+        static double dot(const vector<double>& a_, const vector<double>& b_);
+};
+
+
+#endif // LBFGS_H
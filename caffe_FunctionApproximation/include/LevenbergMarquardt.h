@@ -0,0 +1,94 @@
+#ifndef LEVENBERGMARQUARDT_H
+#define LEVENBERGMARQUARDT_H
+
+// STL
+#include <vector>
+#include <iostream>
+// own
+#include "MLP.h"
+#include "Matrix.h"
+
+using namespace std;
+
+
+/**
+ * @brief The LevenbergMarquardt class - second-order least-squares training of small MLPs
+ *
+ * The nets of function approximations have only a few hundred weights, therefore the
+ * Jacobian J of the residuals (output - expected output of every sample and output) with
+ * respect to all weights is cheap enough to be used directly. Every iteration solves the
+ * damped normal equations
+ *
+ *     (J^T J + damping * diag(J^T J)) * step = -J^T r
+ *
+ * which interpolates between a Gauss-Newton step (small damping) and a short gradient descent
+ * step (big damping). A step which reduces the loss is accepted and the damping is decreased,
+ * otherwise the step is rejected and the damping is increased. Close to a minimum the steps
+ * converge quadratically, therefore a few hundred iterations replace hundreds of thousands of
+ * SGD iterations.
+ *
+ * J^T J and J^T r are accumulated sample by sample (J is never stored), the rows of J are
+ * computed by backpropagation through the InnerProduct/activation stack (see MLP). The samples
+ * are split into one part per thread.
+ *
+ * The loss is the loss of caffe's EuclideanLoss layer : sum of the squared residuals / (2 * samples).
+ *
+ */
+class LevenbergMarquardt {
+    public:
+        struct Report {
+            int    numIterations;
+            double initialLoss;
+            double loss;
+            double damping;
+            double seconds;
+            bool   converged;
+
+            Report() : numIterations(0), initialLoss(0), loss(0), damping(0), seconds(0), converged(false) {};
+
+            void print(ostream& oStream_) const;
+        };
+
+        /* --- constructors / destructors --- */
+        LevenbergMarquardt();
+
+        /* --- getter / setter --- */
+        int    getMaxIterations  () const {return maxIterations  ;};
+        double getInitialDamping () const {return initialDamping ;};
+        double getDampingFactor  () const {return dampingFactor  ;};
+        double getMaxDamping     () const {return maxDamping     ;};
+        double getTolerance      () const {return tolerance      ;};
+        int    getNumThreads     () const {return numThreads     ;};
+
+        void setMaxIterations (int    val_) {maxIterations  = val_;};
+        void setInitialDamping(double val_) {initialDamping = val_;};
+        void setDampingFactor (double val_) {dampingFactor  = val_;};
+        void setMaxDamping    (double val_) {maxDamping     = val_;};
+        void setTolerance     (double val_) {tolerance      = val_;};
+        void setNumThreads    (int    val_) {numThreads     = val_;};
+
+        /* --- training --- */
+        bool train(MLP& mlp_, const MatrixView& inputValues_, const MatrixView& expectedOutputValues_, Report& report_);
+
+    private:
+        int    maxIterations;
+        double initialDamping;
+        // the damping is multiplied (rejected step) or divided (accepted step) by dampingFactor
+        double dampingFactor;
+        double maxDamping;
+        // training stops if an accepted step reduces the loss by less than tolerance * loss
+        double tolerance;
+        // 0 : all available cores
+        int    numThreads;
+
+        /* --- miscellaneous --- */
+        int    resolveNumThreads() const;
+        double loss(const MLP& mlp_, const MatrixView& inputValues_, const MatrixView& expectedOutputValues_) const;
+        double normalEquations(const MLP& mlp_, const MatrixView& inputValues_, const MatrixView& expectedOutputValues_,
+                               vector<double>& hessian_, vector<double>& gradient_) const;
+        static double accumulate(const MLP& mlp_, const MatrixView& inputValues_, const MatrixView& expectedOutputValues_,
+                                 vector<double>& hessian_, vector<double>& gradient_);
+};
+
+
+#endif // LEVENBERGMARQUARDT_H
@@ -0,0 +1,28 @@
+#ifndef LINEARALGEBRA_H
+#define LINEARALGEBRA_H
+
+// STL
+#include <vector>
+
+using namespace std;
+
+
+/**
+ * @brief The LinearAlgebra class - dense linear algebra for the small matrices of function approximation nets
+ *
+ * The weight matrices of the nets used here have only a few hundred entries, therefore simple
+ * and robust algorithms are sufficient and no additional library is needed.
+ *
+ * All matrices are stored row-major in a vector<double>, i.e. element (row, column) is at
+ * matrix[row * numColumns + column].
+ *
+ */
+class LinearAlgebra {
+    public:
+        static void singularValueDecomposition(const vector<double>& matrix_, int numRows_, int numColumns_,
+                                               vector<double>& u_, vector<double>& singularValues_, vector<double>& v_);
+        static bool solveCholesky(vector<double>& matrix_, int size_, vector<double>& rightHandSide_);
+};
+
+
+#endif // LINEARALGEBRA_H
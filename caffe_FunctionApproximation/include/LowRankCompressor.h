@@ -0,0 +1,93 @@
+#ifndef LOWRANKCOMPRESSOR_H
+#define LOWRANKCOMPRESSOR_H
+
+// STL
+#include <vector>
+#include <string>
+#include <iostream>
+// own
+#include "ANN.h"
+#include "MLP.h"
+
+using namespace std;
+
+
+/**
+ * @brief The LowRankCompressor class - replaces InnerProduct layers by low-rank products after training
+ *
+ * A trained InnerProduct layer with the n x m weight matrix W needs n * m multiply-adds per sample.
+ * If W is well approximated by its truncated singular value decomposition
+ *
+ *     W ~ U_k * (S_k * V_k^T)        (U_k : n x k, S_k * V_k^T : k x m)
+ *
+ * the layer can be replaced by two InnerProduct layers with k * (n + m) multiply-adds, which is
+ * cheaper for k < n * m / (n + m). The first of both layers has no bias, the second one keeps the
+ * bias and the activation of the original layer.
+ *
+ * compress() chooses for every hidden layer the smallest rank which keeps the root mean square error
+ * on the given samples within the error budget. The input and the output layer as well as layers
+ * for which no rank saves work or keeps the error within the budget stay unchanged. Afterwards the
+ * compressed net is written as
+ *     <outputPrefix>_without_loss.prototxt
+ *     <outputPrefix>_with_loss.prototxt   (only if the ANN has a solver prototxt)
+ *     <outputPrefix>.caffemodel
+ *     <outputPrefix>.caffemodel.normalizer (only if the ANN has been trained with normalization)
+ * and (optionally) fine-tuned for a few iterations by the SGD solver of the ANN. The files load
+ * into ANN like any other trained net.
+ *
+ * NOTICE : the samples are given in the original value range (like for ANN::forward), the
+ *          normalizers of the ANN are applied by compress()
+ *
+ */
+class LowRankCompressor {
+    public:
+        struct LayerReport {
+            string    name;
+            int       numInputs;
+            int       numOutputs;
+            int       rank;        // 0 if the layer has not been factorized
+            long long flopsBefore; // multiply-adds per sample
+            long long flopsAfter;
+            double    error;       // root mean square error after treating this layer
+        };
+
+        struct Report {
+            vector<LayerReport> layers;
+            long long flopsBefore;
+            long long flopsAfter;
+            double    errorBefore;
+            double    errorAfterFactorization;
+            double    errorAfterFineTuning;   // negative if no fine-tuning has been done
+
+            Report() : flopsBefore(0), flopsAfter(0), errorBefore(0), errorAfterFactorization(0), errorAfterFineTuning(-1) {};
+
+            void print(ostream& oStream_) const;
+        };
+
+        /* --- constructors / destructors --- */
+        explicit LowRankCompressor(ANN& ann_);
+
+        /* --- getter / setter --- */
+        double getErrorBudget         () const {return errorBudget         ;};
+        int    getFineTuningIterations() const {return fineTuningIterations;};
+
+        void setErrorBudget         (double val_) {errorBudget          = val_;};
+        void setFineTuningIterations(int    val_) {fineTuningIterations = val_;};
+
+        /* --- compression --- */
+        bool compress(const vector<vector<double>>& inputValues_, const vector<vector<double>>& expectedOutputValues_,
+                      const string& outputPrefix_, Report& report_);
+
+    private:
+        ANN&   ann;
+        double errorBudget;
+        int    fineTuningIterations;
+
+        double rootMeanSquareError(const MLP& mlp_, const vector<vector<double>>& inputValues_,
+                                   const vector<vector<double>>& expectedOutputValues_) const;
+        bool writeNetStructure(const string& sourcePath_, const string& targetPath_, const vector<LayerReport>& layers_) const;
+
+};
+
+
+#endif // LOWRANKCOMPRESSOR_H
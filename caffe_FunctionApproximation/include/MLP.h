@@ -0,0 +1,90 @@
+#ifndef MLP_H
+#define MLP_H
+
+// STL
+#include <vector>
+#include <string>
+// caffe
+#include "caffe/caffe.hpp"
+#include "caffe/net.hpp"
+// own
+#include "Normalizer.h"
+
+using namespace caffe;
+using namespace std;
+
+
+/**
+ * @brief The MLP class - a native copy of the InnerProduct/activation stack of a caffe net
+ *
+ * The nets used for function approximation are plain multilayer perceptrons : a chain of
+ * InnerProduct layers, each optionally followed by an activation layer. MLP extracts the
+ * weights of such a net into plain arrays, so that they can be analyzed or evaluated
+ * without the overhead of caffe (e.g. for verification or on many threads at once).
+ *
+ * Supported activations are TanH and ReLU (including LeakyReLU, i.e. ReLU with a
+ * non-negative negative_slope). All of them are monotonically non-decreasing, ReLU layers
+ * with a negative slope are refused.
+ *
+ * The weights of every layer are stored in caffe's layout : row-major with one row per
+ * output neuron, i.e. weights[outputNeuron * numInputs + inputNeuron].
+ *
+ * A net trained with normalization (see ANN::setNormalization) works on normalized values.
+ * Loaded together with the normalizers of the ANN, the normalization is folded into the
+ * weights, therefore the MLP (and every tool working on it) takes and returns the original
+ * values like ANN::forward.
+ *
+ */
+class MLP {
+    public:
+        enum Activation {
+            LINEAR,
+            TANH,
+            RELU
+        };
+
+        struct DenseLayer {
+            string         name;
+            int            numInputs;
+            int            numOutputs;
+            vector<double> weights;
+            vector<double> biases;
+            Activation     activation;
+            double         negativeSlope; // slope of RELU for negative values (LeakyReLU)
+
+            DenseLayer() : numInputs(0), numOutputs(0), activation(LINEAR), negativeSlope(0) {};
+        };
+
+        /* --- constructors / destructors --- */
+        MLP() {};
+
+        /* --- getter / setter --- */
+        int getNumInputs () const {return layers.empty() ? 0 : layers.front().numInputs ;};
+        int getNumOutputs() const {return layers.empty() ? 0 : layers.back().numOutputs;};
+        const vector<DenseLayer>& getLayers() const {return layers;};
+        int            getNumParameters() const;
+        vector<double> getParameters   () const;
+        bool           setParameters   (const vector<double>& parameters_);
+
+        /* --- building --- */
+        bool loadFromNet(Net<double>* net_);
+        bool loadFromNet(Net<double>* net_, const Normalizer& inputNormalizer_, const Normalizer& outputNormalizer_);
+        bool writeToNet(Net<double>* net_) const;
+        bool addLayer(const DenseLayer& layer_);
+        bool addNormalization(const Normalizer& inputNormalizer_, const Normalizer& outputNormalizer_);
+
+        /* --- pushing values forward (from input to output) --- */
+        void forward(const double* inputValues_, double* outputValues_) const;
+        void forward(const double* inputValues_, int numSamples_, double* outputValues_) const;
+        vector<double> forward(const vector<double>& inputValues_) const;
+
+        /* --- miscellaneous --- */
+        static double activate(Activation activation_, double value_, double negativeSlope_ = 0);
+
+    private:
+        vector<DenseLayer> layers;
+
+};
+
+
+#endif // MLP_H
@@ -0,0 +1,78 @@
+#ifndef MAPPEDDATASOURCE_H
+#define MAPPEDDATASOURCE_H
+
+// STL
+#include <vector>
+#include <string>
+#include <random>
+// own
+#include "DataSource.h"
+#include "ColumnarDataSet.h"
+
+using namespace std;
+
+
+/**
+ * @brief The MappedDataSource class - a DataSource for data sets which do not fit into main memory
+ *
+ * The samples are read from a memory-mapped binary file (see ColumnarDataSet), either
+ *   - a data set file with header, which describes the input and output columns, or
+ *   - a file in the layout of StreamingEvaluator::RAW_BINARY : a headerless columnar file of
+ *     doubles (native byte order), all values of column 0 first, followed by all values of
+ *     column 1 and so on. The first numInputs_ columns are the input values, the following
+ *     numOutputs_ columns the expected output values.
+ *
+ * Shuffling a permutation of all samples would need 8 bytes per sample and read the file in
+ * a completely random order. Instead the samples are grouped into blocks of getBlockSize()
+ * consecutive samples. Every epoch visits the blocks in a new random order and the samples
+ * of a block in a new random order. The next block is announced to the kernel (read ahead)
+ * when a block is started and the pages of a finished block are released, therefore the
+ * resident memory stays at a few blocks, independent of the size of the file.
+ *
+ * NOTICE : if the file can not be mapped an error is printed and isOpen() returns false
+ *
+ */
+class MappedDataSource : public DataSource {
+    public:
+        /* --- constructors / destructors --- */
+        explicit MappedDataSource(const string& path_);
+        MappedDataSource(const string& path_, int numInputs_, int numOutputs_);
+
+        MappedDataSource(const MappedDataSource&) = delete;
+        MappedDataSource& operator=(const MappedDataSource&) = delete;
+
+        /* --- getter / setter --- */
+        bool               isOpen       () const {return dataSet.isOpen();};
+        int                getNumInputs () const {return dataSet.getNumInputs ();};
+        int                getNumOutputs() const {return dataSet.getNumOutputs();};
+        unsigned long long getNumSamples() const {return dataSet.getNumRows   ();};
+        bool               getShuffle   () const {return shuffle   ;};
+        int                getBlockSize () const {return blockSize ;};
+
+        void setShuffle  (bool val_) {shuffle = val_;};
+        void setSeed     (unsigned int val_) {generator.seed(val_);};
+        void setBlockSize(int val_) {blockSize = (val_ > 0) ? val_ : 1; blockOrder.clear(); blockPosition = 0; rowPosition = 0; rowOrder.clear();};
+
+        /* --- reading samples --- */
+        void nextBatch(int batchSize_, double* inputValues_, double* outputValues_);
+        void rewind   ();
+
+    private:
+        ColumnarDataSet dataSet;
+        bool            shuffle;
+        mt19937         generator;
+        // blocks of consecutive samples
+        int            blockSize;
+        vector<size_t> blockOrder;
+        size_t         blockPosition;
+        size_t         currentBlock;
+        vector<int>    rowOrder;
+        size_t         rowPosition;
+
+        void startEpoch();
+        void startBlock();
+        void adviseBlock(size_t block_, int advice_);
+};
+
+
+#endif // MAPPEDDATASOURCE_H
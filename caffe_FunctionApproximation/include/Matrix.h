@@ -0,0 +1,103 @@
+#ifndef MATRIX_H
+#define MATRIX_H
+
+// STL
+#include <vector>
+#include <cstddef>
+
+using namespace std;
+
+
+/**
+ * @brief The MatrixView class - non-owning, read-only view of a row-major matrix of doubles
+ *
+ * A view describes numRows * numColumns contiguous values, value (row, column) is at
+ * data()[row * numColumns + column]. It is cheap to copy and can be created for any buffer
+ * (a Matrix, a vector<double>, the data of a blob, a memory-mapped file), therefore the
+ * values are never copied only to be passed to a function.
+ *
+ * NOTICE : the view does not keep the buffer alive, the buffer has to outlive the view
+ *
+ */
+class MatrixView {
+    public:
+        /* --- constructors / destructors --- */
+        MatrixView() : values(nullptr), numRows(0), numColumns(0) {};
+        MatrixView(const double* values_, size_t numRows_, int numColumns_) : values(values_), numRows(numRows_), numColumns(numColumns_) {};
+        explicit MatrixView(const vector<double>& values_, int numColumns_ = 1)
+            : values(values_.data()), numRows(numColumns_ > 0 ? values_.size() / numColumns_ : 0), numColumns(numColumns_) {};
+
+        /* --- getter / setter --- */
+        size_t        getNumRows   () const {return numRows                     ;};
+        int           getNumColumns() const {return numColumns                  ;};
+        size_t        getSize      () const {return numRows * numColumns        ;};
+        bool          isEmpty      () const {return getSize() == 0              ;};
+        const double* data         () const {return values                      ;};
+        const double* row          (size_t row_) const {return values + row_ * numColumns;};
+        double        operator()   (size_t row_, int column_) const {return values[row_ * numColumns + column_];};
+
+        /* --- miscellaneous --- */
+        MatrixView rows(size_t firstRow_, size_t numRows_) const {return MatrixView(row(firstRow_),numRows_,numColumns);};
+
+    private:
+        const double* values;
+        size_t        numRows;
+        int           numColumns;
+};
+
+
+/**
+ * @brief The Matrix class - owning row-major matrix of doubles in one aligned block of memory
+ *
+ * Samples stored as vector<vector<double>> need one heap allocation per sample and are
+ * scattered over the heap. A Matrix holds all values in one block, aligned to getAlignment()
+ * bytes (a cache line, enough for all SIMD instructions), therefore a batch of samples can be
+ * copied into a blob by one memcpy and transformed in place (see Transforms).
+ *
+ * A Matrix converts implicitly into a MatrixView, therefore it can be passed to all
+ * functions which take views.
+ *
+ */
+class Matrix {
+    public:
+        /* --- constructors / destructors --- */
+        Matrix();
+        Matrix(size_t numRows_, int numColumns_, double value_ = 0.0);
+        explicit Matrix(const MatrixView& view_);
+        explicit Matrix(const vector<vector<double>>& rows_);
+        Matrix(const Matrix& other_);
+        Matrix(Matrix&& other_);
+        ~Matrix();
+
+        Matrix& operator=(const Matrix& other_);
+        Matrix& operator=(Matrix&& other_);
+
+        /* --- getter / setter --- */
+        size_t        getNumRows   () const {return numRows             ;};
+        int           getNumColumns() const {return numColumns          ;};
+        size_t        getSize      () const {return numRows * numColumns;};
+        bool          isEmpty      () const {return getSize() == 0      ;};
+        double*       data         ()       {return values              ;};
+        const double* data         () const {return values              ;};
+        double*       row          (size_t row_)       {return values + row_ * numColumns;};
+        const double* row          (size_t row_) const {return values + row_ * numColumns;};
+        double&       operator()   (size_t row_, int column_)       {return values[row_ * numColumns + column_];};
+        double        operator()   (size_t row_, int column_) const {return values[row_ * numColumns + column_];};
+
+        static size_t getAlignment() {return 64;};
+
+        /* --- miscellaneous --- */
+        void                   resize (size_t numRows_, int numColumns_);
+        MatrixView             view   () const {return MatrixView(values,numRows,numColumns);};
+        vector<vector<double>> toRows () const;
+        operator MatrixView() const {return view();};
+
+    private:
+        double* values;
+        size_t  numRows;
+        int     numColumns;
+        size_t  capacity;
+};
+
+
+#endif // MATRIX_H
@@ -0,0 +1,119 @@
+#ifndef NORMALIZER_H
+#define NORMALIZER_H
+
+// STL
+#include <vector>
+#include <string>
+#include <iostream>
+// own
+#include "Matrix.h"
+
+using namespace std;
+
+
+/**
+ * @brief The Normalizer class - per-feature normalization with fitted statistics
+ *
+ * A Normalizer is fitted once to the values of a data set and afterwards maps values of
+ * every feature (column) into a range which suits the activation functions of the net :
+ *   - Z_SCORE : (x - mean) / standardDeviation
+ *   - MIN_MAX : [minimum, maximum] is mapped linearly onto [-1, 1]
+ *
+ * The statistics (count, mean, sum of squared deviations, minimum, maximum) are collected
+ * in one streaming pass by Welford's algorithm. Large blocks of values are split into one
+ * part per thread, the partial statistics are merged afterwards (Chan et al.). Further
+ * blocks can be added by update(), therefore data which does not fit into main memory can
+ * be fitted batch by batch.
+ *
+ * Both mappings are affine per feature : transform(x) = x * getFactor() + getSummand() and
+ * inverseTransform(y) = y * getInverseFactor() + getOffset(), therefore they can be folded
+ * into the weights of a net (see MLP::addNormalization).
+ *
+ * As the statistics are kept, inverseTransform() needs nothing but the transformed values.
+ * save() / load() persist the statistics in a small text file. ANN keeps the normalizers of
+ * the inputs and the outputs in one file next to the caffemodel (see ANN::setNormalization).
+ *
+ * NOTICE : features without variance (standardDeviation == 0 or minimum == maximum) are
+ *          only shifted, not scaled
+ *
+ */
+class Normalizer {
+    public:
+        enum Method {
+            NONE,
+            Z_SCORE,
+            MIN_MAX
+        };
+
+        /* --- constructors / destructors --- */
+        explicit Normalizer(Method method_ = Z_SCORE);
+
+        /* --- getter / setter --- */
+        Method             getMethod           () const {return method           ;};
+        int                getNumFeatures      () const {return statistics.size();};
+        int                getNumThreads       () const {return numThreads       ;};
+        unsigned long long getCount            () const {return statistics.empty() ? 0 : statistics[0].count;};
+        bool               isFitted            () const {return getCount() > 0   ;};
+        double             getMean             (int feature_) const {return statistics[feature_].mean   ;};
+        double             getMinimum          (int feature_) const {return statistics[feature_].minimum;};
+        double             getMaximum          (int feature_) const {return statistics[feature_].maximum;};
+        double             getStandardDeviation(int feature_) const;
+        double             getFactor           (int feature_) const {return (method == NONE) ? 1.0 : factors       [feature_];};
+        double             getSummand          (int feature_) const {return (method == NONE) ? 0.0 : summands      [feature_];};
+        double             getInverseFactor    (int feature_) const {return (method == NONE) ? 1.0 : inverseFactors[feature_];};
+        double             getOffset           (int feature_) const {return (method == NONE) ? 0.0 : offsets       [feature_];};
+
+        void setMethod    (Method val_) {method     = val_; updateCoefficients();};
+        void setNumThreads(int    val_) {numThreads = val_;};
+
+        /* --- fitting --- */
+        void reset ();
+        void fit   (const vector<double>& values_);
+        void fit   (const vector<vector<double>>& rows_);
+        void fit   (const double* rows_, size_t numRows_, int numFeatures_);
+        void fit   (const MatrixView& rows_);
+        void update(const double* rows_, size_t numRows_, int numFeatures_);
+        void merge (const Normalizer& other_);
+
+        /* --- transforming --- */
+        void transform       (double* rows_, size_t numRows_) const;
+        void inverseTransform(double* rows_, size_t numRows_) const;
+        void transform       (Matrix& rows_) const;
+        void inverseTransform(Matrix& rows_) const;
+
+        vector<double>         transform       (const vector<double>& values_) const;
+        vector<double>         inverseTransform(const vector<double>& values_) const;
+        vector<vector<double>> transform       (const vector<vector<double>>& rows_) const;
+        vector<vector<double>> inverseTransform(const vector<vector<double>>& rows_) const;
+
+        /* --- persistence --- */
+        bool save (const string& path_) const;
+        bool load (const string& path_);
+        bool write(ostream& oStream_) const;
+        bool read (istream& iStream_);
+
+    private:
+        struct Statistics {
+            unsigned long long count;
+            double             mean;
+            double             sumOfSquaredDeviations;
+            double             minimum;
+            double             maximum;
+        };
+
+        Method             method;
+        vector<Statistics> statistics;
+        int                numThreads;
+        // per feature : transform(x) = (x - offset) * factor = x * factor + summand
+        vector<double>     offsets;
+        vector<double>     factors;
+        vector<double>     inverseFactors;
+        vector<double>     summands;
+
+        static void accumulate(const double* rows_, size_t numRows_, int numFeatures_, vector<Statistics>& statistics_);
+        static void combine   (Statistics& statistics_, const Statistics& other_);
+        void        updateCoefficients();
+};
+
+
+#endif // NORMALIZER_H
@@ -0,0 +1,83 @@
+#ifndef PIECEWISELINEAREVALUATOR_H
+#define PIECEWISELINEAREVALUATOR_H
+
+// STL
+#include <vector>
+// own
+#include "MLP.h"
+#include "Domain.h"
+
+using namespace std;
+
+
+/**
+ * @brief The PiecewiseLinearEvaluator class - evaluates ReLU nets by a lookup of linear regions
+ *
+ * A net which only consists of InnerProduct layers with ReLU, LeakyReLU or no activation is a
+ * continuous piecewise linear function : the domain decomposes into convex regions on which
+ * every neuron is either active or inactive, and on every region the whole net collapses into
+ * a single affine map
+ *
+ *     ann(x) = slope * x + offset
+ *
+ * build() enumerates these regions once for a 1-dimensional or 2-dimensional domain. Afterwards
+ * evaluate() only has to find the region containing the input value and apply its affine map,
+ * the net itself is not needed anymore.
+ *
+ * The regions are found layer by layer : every region is split along the line (the point in
+ * one dimension) on which the pre-activation of a ReLU neuron changes its sign.
+ *   - 1 dimension  : regions are intervals, the lookup is a binary search
+ *   - 2 dimensions : regions are convex polygons, the lookup uses a uniform grid of cells which
+ *                    stores the candidate regions of every cell
+ *
+ * NOTICE : nets with TanH layers are not piecewise linear, build() refuses them
+ *
+ */
+class PiecewiseLinearEvaluator {
+    public:
+        /* --- constructors / destructors --- */
+        PiecewiseLinearEvaluator();
+
+        /* --- getter / setter --- */
+        int  getNumRegions() const {return (int)regions.size();};
+        int  getMaxRegions() const {return maxRegions;};
+        void setMaxRegions(int val_) {maxRegions = val_;};
+
+        /* --- building --- */
+        bool build(const MLP& mlp_, const Domain& domain_);
+
+        /* --- evaluation --- */
+        bool evaluate(const double* inputValue_, double* outputValue_) const;
+        void evaluate(const double* inputValues_, int numSamples_, double* outputValues_) const;
+        vector<double> evaluate(const vector<double>& inputValue_) const;
+
+    private:
+        // convex region together with the affine map of the net on it
+        struct Region {
+            vector<double> vertices;  // 1D : {left, right}, 2D : {x0,y0, x1,y1, ...} counter-clockwise
+            vector<double> slope;     // numOutputs x numInputs, row-major
+            vector<double> offset;    // numOutputs
+            double         boundingBox[4];
+        };
+
+        int            numInputs;
+        int            numOutputs;
+        int            maxRegions;
+        Domain         domain;
+        vector<Region> regions;
+        // 1D : left bounds of the regions in ascending order
+        vector<double> leftBounds;
+        // 2D : candidate regions of every grid cell
+        int                 numCellsPerDimension;
+        vector<vector<int>> cells;
+
+        bool splitRegion(const Region& region_, const double* gradient_, double constant_,
+                         Region& positive_, Region& negative_) const;
+        void buildLookup();
+        int  findRegion(const double* inputValue_) const;
+        double violation(const Region& region_, const double* inputValue_) const;
+
+};
+
+
+#endif // PIECEWISELINEAREVALUATOR_H
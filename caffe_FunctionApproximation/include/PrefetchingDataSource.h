@@ -0,0 +1,74 @@
+#ifndef PREFETCHINGDATASOURCE_H
+#define PREFETCHINGDATASOURCE_H
+
+// STL
+#include <vector>
+#include <thread>
+#include <memory>
+// own
+#include "DataSource.h"
+#include "BoundedQueue.h"
+
+using namespace std;
+
+
+/**
+ * @brief The PrefetchingDataSource class - reads the batches of another DataSource in a background thread
+ *
+ * While the solver works on the current batch, a background thread already reads the next
+ * batches from the wrapped source (e.g. a MappedDataSource which has to wait for the disk).
+ * The batches are read into a fixed number of buffers (two by default : double buffering)
+ * which are passed back and forth between both threads, therefore reading overlaps with
+ * computing without allocating memory per batch.
+ *
+ * The background thread is started by the first call of nextBatch(), every buffer holds as many
+ * samples as requested by this call. The buffers are handed out as one stream of samples,
+ * therefore later calls may request other numbers of samples (e.g. the unequal shards of
+ * data-parallel training) without restarting the thread or skipping samples.
+ *
+ * NOTICE : while the PrefetchingDataSource exists, the wrapped source must not be used directly
+ *
+ */
+class PrefetchingDataSource : public DataSource {
+    public:
+        /* --- constructors / destructors --- */
+        explicit PrefetchingDataSource(DataSource& source_, int numBuffers_ = 2);
+        ~PrefetchingDataSource();
+
+        PrefetchingDataSource(const PrefetchingDataSource&) = delete;
+        PrefetchingDataSource& operator=(const PrefetchingDataSource&) = delete;
+
+        /* --- getter / setter --- */
+        int                getNumInputs () const {return source.getNumInputs ();};
+        int                getNumOutputs() const {return source.getNumOutputs();};
+        unsigned long long getNumSamples() const {return source.getNumSamples();};
+
+        /* --- reading samples --- */
+        void nextBatch(int batchSize_, double* inputValues_, double* outputValues_);
+        void rewind   ();
+
+    private:
+        struct Batch {
+            vector<double> inputValues;
+            vector<double> outputValues;
+        };
+
+        DataSource& source;
+        int         numBuffers;
+        int         batchSize;
+        thread      producer;
+        // empty buffers go to the background thread, filled buffers come back
+        unique_ptr<BoundedQueue<Batch>> emptyBatches;
+        unique_ptr<BoundedQueue<Batch>> filledBatches;
+        // filled buffer which is partly handed out
+        Batch       currentBatch;
+        bool        hasCurrentBatch;
+        int         positionInBatch;
+
+        void start(int batchSize_);
+        void stop();
+        void produce();
+};
+
+
+#endif // PREFETCHINGDATASOURCE_H
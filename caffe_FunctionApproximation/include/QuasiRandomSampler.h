@@ -0,0 +1,81 @@
+#ifndef QUASIRANDOMSAMPLER_H
+#define QUASIRANDOMSAMPLER_H
+
+// STL
+#include <vector>
+#include <functional>
+// own
+#include "Domain.h"
+
+using namespace std;
+
+
+/**
+ * @brief The QuasiRandomSampler class - low-discrepancy point sets within a domain
+ *
+ * A full grid with k points per dimension needs k^d samples, which is unaffordable for
+ * d >= 3. Random samples avoid the exponential growth, but leave gaps and clusters.
+ * Low-discrepancy sequences fill the domain much more evenly with the same number of
+ * points, therefore a net reaches the same accuracy with far fewer training samples and
+ * errors are measured more reliably with fewer evaluation samples.
+ *
+ * Supported sequences :
+ *   - SOBOL  : digital (t,s)-sequence in base 2 with the direction numbers of Joe and Kuo,
+ *              up to getMaxSobolDimension() dimensions; the first 2^m points are stratified
+ *              in every dimension
+ *   - HALTON : radical inverse of the index in the i-th prime base for dimension i,
+ *              any number of dimensions
+ *
+ * If scrambling is enabled, the sequences are randomized reproducibly by the seed : Sobol points
+ * by a random linear matrix scrambling and a random digital shift, Halton points by random
+ * permutations of the digits. Scrambling keeps the equidistribution, but removes the
+ * correlations between dimensions of high prime bases (Halton) and the points on the
+ * lower bounds of the domain.
+ *
+ * The points are enumerated by an index, point(index_) is independent of all other points,
+ * therefore sets can be generated in parallel and in batches.
+ *
+ */
+class QuasiRandomSampler {
+    public:
+        enum Sequence {
+            SOBOL,
+            HALTON
+        };
+
+        /* --- constructors / destructors --- */
+        QuasiRandomSampler(const Domain& domain_, Sequence sequence_ = SOBOL, bool scrambled_ = false,
+                           unsigned long long seed_ = 0);
+
+        /* --- getter / setter --- */
+        bool     isValid    () const {return valid    ;};
+        Sequence getSequence() const {return sequence ;};
+        bool     getScrambled() const {return scrambled;};
+
+        static int getMaxSobolDimension();
+
+        /* --- sampling --- */
+        void point(unsigned long long index_, double* point_) const;
+        vector<double> point(unsigned long long index_) const;
+        vector<vector<double>> sample(unsigned long long numSamples_, unsigned long long firstIndex_ = 0) const;
+        void sample(unsigned long long numSamples_, const function<double(const vector<double>&)>& targetFunction_,
+                    vector<vector<double>>& inputValues_, vector<double>& expectedOutputValues_) const;
+
+    private:
+        Domain   domain;
+        Sequence sequence;
+        bool     scrambled;
+        bool     valid;
+        // SOBOL  : 32 direction numbers and the digital shift per dimension
+        vector<vector<unsigned int>> directionNumbers;
+        vector<unsigned int>         shifts;
+        // HALTON : base and digit permutations per dimension
+        vector<unsigned int>                 bases;
+        vector<vector<vector<unsigned int>>> digitPermutations;
+
+        void initSobol (unsigned long long seed_);
+        void initHalton(unsigned long long seed_);
+};
+
+
+#endif // QUASIRANDOMSAMPLER_H
@@ -0,0 +1,89 @@
+#ifndef RINGALLREDUCE_H
+#define RINGALLREDUCE_H
+
+// STL
+#include <vector>
+#include <string>
+#include <functional>
+
+using namespace std;
+
+
+/**
+ * @brief The RingAllReduce class - sums buffers of doubles over the processes of a training job
+ *
+ * The getWorldSize() processes (ranks) of a job are connected by TCP to a ring : every rank
+ * connects to its successor (rank + 1) and accepts the connection of its predecessor. The
+ * address of rank r is addresses_[r] ("host:port"), every rank listens on its own address only
+ * (an empty host, e.g. ":23400", listens on all interfaces). The processes can run on one
+ * machine (loopback addresses) or on several machines.
+ *
+ * allReduce sums a buffer of n values in 2 * (N - 1) steps. The buffer is split into N chunks,
+ *   1. reduce-scatter : in every step every rank sends one chunk to its successor and adds the
+ *      chunk received from its predecessor, afterwards every rank holds the sum of one chunk
+ *   2. all-gather     : the summed chunks are passed around the ring once
+ * therefore every rank sends and receives 2 * (N - 1) / N * n values, independent of N.
+ * Sending and receiving overlap (poll), therefore the ring can not deadlock on full buffers.
+ *
+ * NOTICE : the values are sent in native byte order, all machines have to use the same
+ * NOTICE : if the ring can not be connected within the timeout, an error is printed and
+ *          isOpen() returns false
+ *
+ */
+class RingAllReduce {
+    public:
+        /* --- constructors / destructors --- */
+        RingAllReduce(int rank_, const vector<string>& addresses_, int timeoutSeconds_ = 60);
+        ~RingAllReduce();
+
+        RingAllReduce(const RingAllReduce&) = delete;
+        RingAllReduce& operator=(const RingAllReduce&) = delete;
+
+        /* --- getter / setter --- */
+        bool isOpen           () const {return open          ;};
+        int  getRank          () const {return rank          ;};
+        int  getWorldSize     () const {return worldSize     ;};
+        int  getTimeoutSeconds() const {return timeoutSeconds;};
+
+        void setTimeoutSeconds(int val_) {timeoutSeconds = val_;};
+
+        /* --- communication --- */
+        bool allReduce(double* values_, size_t numValues_);
+        bool broadcast(string& data_, int root_ = 0);
+        bool barrier  ();
+
+        /* --- miscellaneous --- */
+        static vector<string> localAddresses(int worldSize_, int basePort_);
+        static int            freeLocalPorts(int numPorts_);
+
+    private:
+        int  rank;
+        int  worldSize;
+        int  timeoutSeconds;
+        bool open;
+        // socket to the successor (sending) and to the predecessor (receiving)
+        int  nextSocket;
+        int  previousSocket;
+
+        bool connectRing(const vector<string>& addresses_);
+        bool exchange(const char* sendBuffer_, size_t sendBytes_, char* receiveBuffer_, size_t receiveBytes_);
+};
+
+
+/**
+ * @brief The DistributedLauncher class - starts the ranks of a training job as processes on this machine
+ *
+ * Every rank is a child process (fork) which connects a RingAllReduce over the loopback
+ * addresses 127.0.0.1:basePort_ + rank and runs worker_ with it. A base port of 0 takes
+ * free ports (see RingAllReduce::freeLocalPorts). Jobs over several machines
+ * start one process per rank themselves and construct the RingAllReduce with the addresses
+ * of all machines.
+ *
+ */
+class DistributedLauncher {
+    public:
+        static bool run(int worldSize_, int basePort_, const function<bool(RingAllReduce&)>& worker_);
+};
+
+
+#endif // RINGALLREDUCE_H
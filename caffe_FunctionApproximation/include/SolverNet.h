@@ -0,0 +1,33 @@
+#ifndef SOLVERNET_H
+#define SOLVERNET_H
+
+// caffe
+#include "caffe/caffe.hpp"
+#include "caffe/util/upgrade_proto.hpp"
+
+using namespace caffe;
+using namespace std;
+
+
+/**
+ * @brief The SolverNet class - resolves the net of a solver prototxt
+ *
+ * The net of a solver prototxt may be given in several ways : as a file (net, train_net) or
+ * inline (net_param, train_net_param). Nets which are built next to the net of a solver
+ * (replicas of data-parallel training, the L-BFGS net, the validation net of early stopping)
+ * resolve it like Solver::InitTrainNet, i.e. train_net_param, train_net, net_param and net
+ * are tried in this order, and the state of the net gets the phase of the net and (for TRAIN)
+ * the train_state of the solver.
+ *
+ * NOTICE : the TEST net is resolved from net_param or net, test_net and test_net_param are not
+ *          used, as the validation samples are fed into the input BLOBs of the trained net
+ *
+ */
+class SolverNet {
+    public:
+        /* --- resolving --- */
+        static NetParameter netParameter(const SolverParameter& param_, Phase phase_);
+};
+
+
+#endif // SOLVERNET_H
@@ -0,0 +1,101 @@
+#ifndef STREAMINGEVALUATOR_H
+#define STREAMINGEVALUATOR_H
+
+// STL
+#include <vector>
+#include <string>
+#include <functional>
+#include <iostream>
+#include <fstream>
+// own
+#include "ANN.h"
+#include "BoundedQueue.h"
+#include "CsvIO.h"
+#include "Matrix.h"
+#include "ColumnarDataSet.h"
+
+using namespace std;
+
+
+/**
+ * @brief The StreamingEvaluator class - evaluates an ANN on input files of arbitrary size
+ *
+ * ANN::forward needs all input values at once and returns all output values at once.
+ * For input files which are larger than the main memory the StreamingEvaluator reads the
+ * input file chunk by chunk, propagates every chunk through the net and appends the results
+ * to the output file right away. Reading, propagating and writing run on separate threads
+ * which are connected by bounded queues, therefore the memory usage only depends on the
+ * chunk size and not on the size of the input file.
+ *
+ * Every row of the input file consists of numInputs input values, optionally followed by
+ * numExpectedColumns expected output values. Every row of the output file has the layout
+ * of the files in results/ :
+ *
+ *     input_0, ..., input_n, expected_0, ..., expected_m, ann_0, ..., ann_k
+ *
+ * If the input file contains no expected values, but a reference function has been set,
+ * the expected values are calculated by the reference function. If neither is available
+ * the expected columns are left out.
+ *
+ * Supported input formats :
+ *   - CSV        : one sample per line, values separated by commas, a non-numeric first
+ *                  line (header) is skipped
+ *   - RAW_BINARY : headerless columnar file of doubles (native byte order), all values of
+ *                  column 0 first, followed by all values of column 1 and so on
+ * An opened ColumnarDataSet is streamed by ranges of rows of its mapped columns, the outputs
+ * of the data set are the expected values.
+ *
+ * The samples of a chunk are stored as a Matrix (one row per sample) and passed to
+ * ANN::forward as a MatrixView, therefore a chunk needs three allocations, independent of
+ * the chunk size.
+ *
+ */
+class StreamingEvaluator {
+    public:
+        enum InputFormat {
+            CSV,
+            RAW_BINARY
+        };
+
+        /* --- constructors / destructors --- */
+        StreamingEvaluator(ANN& ann_, int numInputs_, int numExpectedColumns_ = 0, int chunkSize_ = 4096);
+
+        /* --- getter / setter --- */
+        int getNumInputs         () const {return numInputs         ;};
+        int getNumExpectedColumns() const {return numExpectedColumns;};
+        int getChunkSize         () const {return chunkSize         ;};
+
+        void setChunkSize        (int val_) {chunkSize = (val_ > 0) ? val_ : 1;};
+        void setReferenceFunction(const function<vector<double>(const vector<double>&)>& val_) {referenceFunction = val_;};
+
+        /* --- evaluation --- */
+        bool evaluate(const string& inputPath_, InputFormat inputFormat_, const string& outputPath_);
+        bool evaluate(const ColumnarDataSet& dataSet_, const string& outputPath_);
+
+    private:
+        // one work package of the pipeline, one row per sample (expectedValues is empty if
+        // there are no expected values)
+        struct Chunk {
+            Matrix inputValues;
+            Matrix expectedValues;
+            Matrix outputValues;
+        };
+
+        ANN& ann;
+        int  numInputs;
+        int  numExpectedColumns;
+        int  chunkSize;
+        function<vector<double>(const vector<double>&)> referenceFunction;
+
+        /* --- pipeline stages --- */
+        bool runPipeline  (const function<bool(BoundedQueue<Chunk>&)>& read_, const string& outputPath_);
+        bool readCSV      (const string& inputPath_, BoundedQueue<Chunk>& parsedChunks_);
+        bool readRawBinary(const string& inputPath_, BoundedQueue<Chunk>& parsedChunks_);
+        bool readColumnar (const ColumnarDataSet& dataSet_, BoundedQueue<Chunk>& parsedChunks_);
+        bool writeCSV     (CsvWriter& oFile_, BoundedQueue<Chunk>& evaluatedChunks_);
+        void completeChunk(Chunk& chunk_);
+
+};
+
+
+#endif // STREAMINGEVALUATOR_H
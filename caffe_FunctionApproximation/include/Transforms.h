@@ -0,0 +1,47 @@
+#ifndef TRANSFORMS_H
+#define TRANSFORMS_H
+
+// STL
+#include <cstddef>
+
+using namespace std;
+
+
+/**
+ * @brief The Transforms class - in-place element-wise transforms of flat buffers
+ *
+ * All buffers are stored row-major, i.e. value (row, column) is at values_[row * numColumns_ + column],
+ * and every column has its own parameters (one factor / offset per column). A buffer with
+ * numColumns_ == 1 applies the same parameter to all values.
+ *
+ * The values are transformed in place, no copy of the buffer is made. The per-column parameters
+ * are repeated into a block of a few hundred values, which is applied to the buffer block by
+ * block with SIMD instructions (AVX if the compiler targets it, SSE2 otherwise). Buffers with
+ * more than 2^18 values are split at row boundaries into one part per thread.
+ *
+ * NOTICE : no fused multiply-add is used, therefore the results are identical to the scalar
+ *          expressions of multiplyAdd, scale, divide and shift. zTransform and inverseZTransform
+ *          are applied as multiplyAdd, zTransform may differ from the quotient in the last bit
+ *
+ */
+class Transforms {
+    public:
+        /* --- getter / setter --- */
+        static int  getNumThreads() {return numThreads;};
+        static void setNumThreads(int val_) {numThreads = val_;};
+
+        /* --- transforms --- */
+        static void multiplyAdd      (double* values_, size_t numRows_, int numColumns_, const double* factors_, const double* summands_);
+        static void scale            (double* values_, size_t numRows_, int numColumns_, const double* factors_);
+        static void divide           (double* values_, size_t numRows_, int numColumns_, const double* divisors_);
+        static void shift            (double* values_, size_t numRows_, int numColumns_, const double* offsets_);
+        static void zTransform       (double* values_, size_t numRows_, int numColumns_, const double* means_, const double* standardDeviations_);
+        static void inverseZTransform(double* values_, size_t numRows_, int numColumns_, const double* means_, const double* standardDeviations_);
+
+    private:
+        // 0 : all available cores
+        static int numThreads;
+};
+
+
+#endif // TRANSFORMS_H
@@ -1,7 +1,30 @@
 #define CATCH_CONFIG_MAIN  // This tells Catch to provide a main() - only do this in one cpp file
 #include "catch.hpp"
 
+#include <chrono>
+#include <thread>
+
 #include "ANN.h"
+#include "StreamingEvaluator.h"
+#include "IntervalVerifier.h"
+#include "AccuracyEvaluator.h"
+#include "PiecewiseLinearEvaluator.h"
+#include "LinearAlgebra.h"
+#include "DataSource.h"
+#include "MappedDataSource.h"
+#include "PrefetchingDataSource.h"
+#include "GeneratorDataSource.h"
+#include "QuasiRandomSampler.h"
+#include "AdaptiveTrainer.h"
+#include "ColumnarDataSet.h"
+#include "CsvIO.h"
+#include "Normalizer.h"
+#include "Transforms.h"
+#include "Matrix.h"
+#include "RingAllReduce.h"
+#include "LevenbergMarquardt.h"
+#include "LBFGS.h"
+#include "LowRankCompressor.h"
 
 using namespace std;
 
@@ -128,6 +151,1214 @@ TEST_CASE ("transformations, scaling") {
     }
 }
 
+TEST_CASE("Streaming evaluation") {
+    // very_simple_net only consists of a TanH-layer, therefore ann(x) == tanh(x)
+    ANN ann("../caffe_FunctionApproximation/prototxt/very_simple_net.prototxt");
+
+    vector<double> inputValues;
+    double d = -2.0;
+    while (d <= 2.0) {
+        inputValues.push_back(d);
+        d += 0.01;
+    }
+
+    StreamingEvaluator evaluator(ann,1,0,64);
+    evaluator.setReferenceFunction([](const vector<double>& x_) { return vector<double>(1,tanh(x_[0])); });
+
+    SECTION("csv input") {
+        ofstream iFile("streaming_input.csv");
+        iFile << "x" << endl;
+        for (unsigned int i = 0; i < inputValues.size(); i++) {
+            iFile << inputValues[i] << "\n";
+        }
+        iFile.close();
+
+        REQUIRE(evaluator.evaluate("streaming_input.csv",StreamingEvaluator::CSV,"streaming_output.csv"));
+    }
+
+    SECTION("raw binary input") {
+        ofstream iFile("streaming_input.bin",ios::binary);
+        iFile.write(reinterpret_cast<const char*>(inputValues.data()),inputValues.size() * sizeof(double));
+        iFile.close();
+
+        REQUIRE(evaluator.evaluate("streaming_input.bin",StreamingEvaluator::RAW_BINARY,"streaming_output.csv"));
+    }
+
+    SECTION("columnar data set input") {
+        REQUIRE(ColumnarDataSet::write("streaming_input.fad",{"x"},1,{inputValues}));
+        ColumnarDataSet dataSet;
+        REQUIRE(dataSet.open("streaming_input.fad"));
+
+        REQUIRE(evaluator.evaluate(dataSet,"streaming_output.csv"));
+    }
+
+    // every line of the output has the layout x,tanh(x),ann(x)
+    ifstream oFile("streaming_output.csv");
+    string line;
+    unsigned int numLines = 0;
+    while (getline(oFile,line)) {
+        double x, expected, annOut;
+        char separator;
+        stringstream sstr(line);
+        sstr >> x >> separator >> expected >> separator >> annOut;
+        REQUIRE(nearlyEqual(expected,annOut,0.0001));
+        REQUIRE(nearlyEqual(tanh(x),annOut,0.0001));
+        numLines++;
+    }
+    REQUIRE(numLines == inputValues.size());
+}
+
+
+TEST_CASE("Interval bound propagation") {
+    // ann(x) = tanh(x + bias)
+    MLP mlp;
+    MLP::DenseLayer layer;
+    layer.numInputs  = 1;
+    layer.numOutputs = 1;
+    layer.weights    = {1.0};
+    layer.biases     = {0.0};
+    layer.activation = MLP::TANH;
+
+    SECTION("bounds contain all sampled outputs") {
+        layer.biases = {0.3};
+        REQUIRE(mlp.addLayer(layer));
+
+        IntervalVerifier verifier(mlp);
+        Domain box({-0.5},{1.5});
+        vector<IntervalVerifier::Interval> bounds = verifier.propagate(box);
+        REQUIRE(bounds.size() == 1);
+        for (double x = -0.5; x <= 1.5; x += 0.01) {
+            REQUIRE(bounds[0].lower <= mlp.forward(vector<double>(1,x))[0]);
+            REQUIRE(bounds[0].upper >= mlp.forward(vector<double>(1,x))[0]);
+        }
+    }
+
+    SECTION("certify maximum error against reference function") {
+        // the error is largest at x = -bias/2 : tanh(bias/2) - tanh(-bias/2)
+        layer.biases = {0.1};
+        REQUIRE(mlp.addLayer(layer));
+
+        IntervalVerifier verifier(mlp);
+        verifier.setTolerance(0.001);
+        verifier.setReferenceFunction([](const vector<double>& x_) { return vector<double>(1,tanh(x_[0])); },1.0);
+
+        IntervalVerifier::Result result = verifier.certifyMaxError(Domain({-2.0},{2.0}));
+        double maxError = 2 * tanh(0.05);
+        REQUIRE(result.certified);
+        REQUIRE(result.lowerBound <= maxError + 1e-12);
+        REQUIRE(result.upperBound >= maxError);
+        REQUIRE(result.upperBound - result.lowerBound <= 0.001);
+    }
+    SECTION("a missing or wrong-sized reference is never certified") {
+        REQUIRE(mlp.addLayer(layer));
+
+        IntervalVerifier verifier(mlp);
+        IntervalVerifier::Result result = verifier.certifyMaxError(Domain({-2.0},{2.0}));
+        REQUIRE(!result.certified);
+        REQUIRE(std::isinf(result.upperBound));
+
+        verifier.setReferenceBounds([](const Domain&) { return vector<IntervalVerifier::Interval>(); });
+        result = verifier.certifyMaxError(Domain({-2.0},{2.0}));
+        REQUIRE(!result.certified);
+        REQUIRE(std::isinf(result.upperBound));
+
+        verifier.setReferenceFunction([](const vector<double>&) { return vector<double>(2,0.0); },1.0);
+        verifier.setReferenceBounds(nullptr);
+        result = verifier.certifyMaxError(Domain({-2.0},{2.0}));
+        REQUIRE(!result.certified);
+        REQUIRE(std::isinf(result.upperBound));
+    }
+}
+
+
+TEST_CASE("Parallel accuracy evaluation") {
+    // ann(x,y) = tanh(x + y), reference(x,y) = tanh(x + y) + 0.05 --> every error is 0.05
+    MLP mlp;
+    MLP::DenseLayer layer;
+    layer.numInputs  = 2;
+    layer.numOutputs = 1;
+    layer.weights    = {1.0, 1.0};
+    layer.biases     = {0.0};
+    layer.activation = MLP::TANH;
+    REQUIRE(mlp.addLayer(layer));
+
+    AccuracyEvaluator evaluator(mlp,[](const vector<double>& x_) { return vector<double>(1,tanh(x_[0] + x_[1]) + 0.05); });
+    evaluator.setNumThreads(4);
+    evaluator.setBatchSize(1000);
+    evaluator.setHistogram(10,0.1);
+
+    SECTION("grid") {
+        AccuracyEvaluator::Report report = evaluator.evaluate(Domain({-2.0,-2.0},{2.0,2.0}),10000,AccuracyEvaluator::GRID);
+        REQUIRE(report.numSamples == 10000);
+        REQUIRE(report.numErrors  == 10000);
+        REQUIRE(nearlyEqual(report.rootMeanSquareError,0.05,1e-9));
+        REQUIRE(nearlyEqual(report.maxError,0.05,1e-9));
+        REQUIRE(report.histogram.size() == 11);
+        REQUIRE(report.histogram[4] + report.histogram[5] == 10000);
+    }
+
+    SECTION("grid rounded down to k^dimension") {
+        AccuracyEvaluator::Report report = evaluator.evaluate(Domain({-2.0,-2.0},{2.0,2.0}),10200,AccuracyEvaluator::GRID);
+        REQUIRE(report.numSamples == 10000);
+        report = evaluator.evaluate(Domain({-2.0,-2.0},{2.0,2.0}),3,AccuracyEvaluator::GRID);
+        REQUIRE(report.numSamples == 0);
+    }
+
+    SECTION("uniform random") {
+        AccuracyEvaluator::Report report = evaluator.evaluate(Domain({-2.0,-2.0},{2.0,2.0}),12345,AccuracyEvaluator::UNIFORM_RANDOM);
+        REQUIRE(report.numSamples == 12345);
+        REQUIRE(nearlyEqual(report.meanAbsoluteError,0.05,1e-9));
+        REQUIRE(Domain({-2.0,-2.0},{2.0,2.0}).contains(report.worstInput));
+    }
+
+    SECTION("sobol") {
+        AccuracyEvaluator::Report report = evaluator.evaluate(Domain({-2.0,-2.0},{2.0,2.0}),4096,AccuracyEvaluator::SOBOL);
+        REQUIRE(report.numSamples == 4096);
+        REQUIRE(nearlyEqual(report.rootMeanSquareError,0.05,1e-9));
+    }
+
+    SECTION("sobol beyond 2^32 samples") {
+        AccuracyEvaluator::Report report = evaluator.evaluate(Domain({-2.0,-2.0},{2.0,2.0}),(1ULL << 32) + 1,AccuracyEvaluator::SOBOL);
+        REQUIRE(report.numSamples == 0);
+    }
+
+    SECTION("non-finite errors") {
+        // the reference is NaN for x > 1 --> a quarter of the grid points
+        AccuracyEvaluator nanEvaluator(mlp,[](const vector<double>& x_) {
+            return vector<double>(1,x_[0] > 1.0 ? nan("") : tanh(x_[0] + x_[1]) + 0.05);
+        });
+        nanEvaluator.setNumThreads(4);
+        nanEvaluator.setBatchSize(1000);
+        AccuracyEvaluator::Report report = nanEvaluator.evaluate(Domain({-2.0,-2.0},{2.0,2.0}),10000,AccuracyEvaluator::GRID);
+        REQUIRE(report.numNonFiniteErrors > 0);
+        REQUIRE(report.numNonFiniteErrors < report.numErrors);
+        REQUIRE(isinf(report.maxError));
+        REQUIRE(report.worstInput[0] > 1.0);
+        REQUIRE(nearlyEqual(report.rootMeanSquareError,0.05,1e-9));
+        REQUIRE(report.histogram.back() == report.numNonFiniteErrors);
+    }
+}
+
+
+TEST_CASE("Region-wise linear evaluation of ReLU nets") {
+    MLP mlp;
+    MLP::DenseLayer hiddenLayer;
+    hiddenLayer.activation = MLP::RELU;
+    MLP::DenseLayer outputLayer;
+
+    SECTION("1 input : |x| = relu(x) + relu(-x)") {
+        hiddenLayer.numInputs  = 1;
+        hiddenLayer.numOutputs = 2;
+        hiddenLayer.weights    = {1.0, -1.0};
+        hiddenLayer.biases     = {0.0, 0.0};
+        outputLayer.numInputs  = 2;
+        outputLayer.numOutputs = 1;
+        outputLayer.weights    = {1.0, 1.0};
+        outputLayer.biases     = {0.0};
+        REQUIRE(mlp.addLayer(hiddenLayer));
+        REQUIRE(mlp.addLayer(outputLayer));
+
+        PiecewiseLinearEvaluator evaluator;
+        REQUIRE(evaluator.build(mlp,Domain({-2.0},{2.0})));
+        REQUIRE(evaluator.getNumRegions() == 2);
+        for (double x = -2.0; x <= 2.0; x += 0.1) {
+            REQUIRE(nearlyEqual(evaluator.evaluate(vector<double>(1,x))[0],fabs(x),1e-12));
+        }
+        REQUIRE(evaluator.evaluate(vector<double>(1,2.5)).empty());
+    }
+
+    SECTION("2 inputs, LeakyReLU") {
+        hiddenLayer.numInputs     = 2;
+        hiddenLayer.numOutputs    = 3;
+        hiddenLayer.weights       = {1.0, -0.5, 0.3, 0.8, -0.7, -0.2};
+        hiddenLayer.biases        = {0.1, -0.2, 0.3};
+        hiddenLayer.negativeSlope = 0.01;
+        outputLayer.numInputs     = 3;
+        outputLayer.numOutputs    = 1;
+        outputLayer.weights       = {0.5, -1.0, 2.0};
+        outputLayer.biases        = {0.25};
+        REQUIRE(mlp.addLayer(hiddenLayer));
+        REQUIRE(mlp.addLayer(outputLayer));
+
+        PiecewiseLinearEvaluator evaluator;
+        REQUIRE(evaluator.build(mlp,Domain({-2.0,-2.0},{2.0,2.0})));
+        REQUIRE(evaluator.getNumRegions() > 1);
+        for (double x = -2.0; x <= 2.0; x += 0.1) {
+            for (double y = -2.0; y <= 2.0; y += 0.1) {
+                vector<double> input = {x, y};
+                REQUIRE(nearlyEqual(evaluator.evaluate(input)[0],mlp.forward(input)[0],1e-9));
+            }
+        }
+    }
+
+    SECTION("ReLU with a negative slope is refused") {
+        hiddenLayer.numInputs     = 1;
+        hiddenLayer.numOutputs    = 1;
+        hiddenLayer.weights       = {1.0};
+        hiddenLayer.biases        = {0.0};
+        hiddenLayer.negativeSlope = -0.5;
+        REQUIRE_FALSE(mlp.addLayer(hiddenLayer));
+        REQUIRE(mlp.getLayers().empty());
+    }
+
+    SECTION("TanH nets are refused") {
+        hiddenLayer.numInputs  = 1;
+        hiddenLayer.numOutputs = 1;
+        hiddenLayer.weights    = {1.0};
+        hiddenLayer.biases     = {0.0};
+        hiddenLayer.activation = MLP::TANH;
+        REQUIRE(mlp.addLayer(hiddenLayer));
+
+        PiecewiseLinearEvaluator evaluator;
+        REQUIRE_FALSE(evaluator.build(mlp,Domain({-2.0},{2.0})));
+    }
+}
+
+
+TEST_CASE("Singular value decomposition") {
+    // 3 x 4 matrix
+    vector<double> matrix = {
+        1.0, -2.0,  0.5, 3.0,
+        0.3,  1.5, -1.0, 2.0,
+       -4.0,  0.2,  0.7, 1.1
+    };
+    vector<double> u, singularValues, v;
+    LinearAlgebra::singularValueDecomposition(matrix,3,4,u,singularValues,v);
+
+    REQUIRE(singularValues.size() == 3);
+    REQUIRE(u.size() == 3 * 3);
+    REQUIRE(v.size() == 4 * 3);
+    REQUIRE(singularValues[0] >= singularValues[1]);
+    REQUIRE(singularValues[1] >= singularValues[2]);
+
+    // U * S * V^T reproduces the matrix
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 4; j++) {
+            double value = 0;
+            for (int k = 0; k < 3; k++) {
+                value += u[i * 3 + k] * singularValues[k] * v[j * 3 + k];
+            }
+            REQUIRE(nearlyEqual(value,matrix[i * 4 + j],1e-12));
+        }
+    }
+
+    // columns of V are orthonormal
+    for (int k1 = 0; k1 < 3; k1++) {
+        for (int k2 = 0; k2 < 3; k2++) {
+            double dot = 0;
+            for (int j = 0; j < 4; j++) {
+                dot += v[j * 3 + k1] * v[j * 3 + k2];
+            }
+            REQUIRE(nearlyEqual(dot,(k1 == k2) ? 1.0 : 0.0,1e-12));
+        }
+    }
+}
+
+TEST_CASE("In-memory data source") {
+    vector<vector<double>> inputValues;
+    vector<vector<double>> outputValues;
+    for (int i = 0; i < 10; i++) {
+        inputValues.push_back({double(i), double(-i)});
+        outputValues.push_back({double(2 * i)});
+    }
+    InMemoryDataSource dataSource(inputValues,outputValues);
+    REQUIRE(dataSource.getNumInputs()  == 2);
+    REQUIRE(dataSource.getNumOutputs() == 1);
+    REQUIRE(dataSource.getNumSamples() == 10);
+
+    SECTION("every epoch delivers every sample once") {
+        // batches of 4 samples --> the third batch of every epoch wraps into the next epoch
+        vector<double> inputs(4 * 2);
+        vector<double> outputs(4);
+        vector<int> count(10,0);
+        for (int batch = 0; batch < 5; batch++) {
+            dataSource.nextBatch(4,inputs.data(),outputs.data());
+            for (int i = 0; i < 4; i++) {
+                int sample = int(inputs[i * 2]);
+                REQUIRE(inputs[i * 2 + 1] == -sample);
+                REQUIRE(outputs[i] == 2 * sample);
+                count[sample]++;
+            }
+        }
+        // 20 samples = 2 epochs
+        for (int i = 0; i < 10; i++) {
+            REQUIRE(count[i] == 2);
+        }
+    }
+
+    SECTION("shuffling") {
+        vector<double> first(10 * 2), second(10 * 2), outputs(10);
+        dataSource.nextBatch(10,first.data(),outputs.data());
+        dataSource.nextBatch(10,second.data(),outputs.data());
+        REQUIRE(first != second);
+
+        InMemoryDataSource orderedDataSource(inputValues,outputValues);
+        orderedDataSource.setShuffle(false);
+        orderedDataSource.nextBatch(10,first.data(),outputs.data());
+        for (int i = 0; i < 10; i++) {
+            REQUIRE(first[i * 2] == i);
+        }
+    }
+
+    SECTION("rewinding starts a new epoch") {
+        vector<double> inputs(10 * 2), outputs(10);
+        dataSource.setShuffle(false);
+        dataSource.nextBatch(3,inputs.data(),outputs.data());
+        dataSource.rewind();
+        dataSource.nextBatch(10,inputs.data(),outputs.data());
+        for (int i = 0; i < 10; i++) {
+            REQUIRE(inputs[i * 2] == i);
+        }
+    }
+
+    SECTION("holding out validation samples") {
+        InMemoryDataSource validationDataSource = dataSource.holdOut(0.3);
+        REQUIRE(validationDataSource.getNumSamples() == 3);
+        REQUIRE(validationDataSource.getNumInputs()  == 2);
+        REQUIRE(dataSource.getNumSamples() == 7);
+
+        // every sample is in exactly one of both sources
+        vector<int> count(10,0);
+        vector<double> inputs(7 * 2), outputs(7);
+        dataSource.nextBatch(7,inputs.data(),outputs.data());
+        for (int i = 0; i < 7; i++) {
+            REQUIRE(outputs[i] == 2 * inputs[i * 2]);
+            count[int(inputs[i * 2])]++;
+        }
+        validationDataSource.nextBatch(3,inputs.data(),outputs.data());
+        for (int i = 0; i < 3; i++) {
+            REQUIRE(outputs[i] == 2 * inputs[i * 2]);
+            count[int(inputs[i * 2])]++;
+        }
+        for (int i = 0; i < 10; i++) {
+            REQUIRE(count[i] == 1);
+        }
+
+        // at least one sample is kept for training
+        REQUIRE(dataSource.holdOut(1.0).getNumSamples() == 6);
+        REQUIRE(dataSource.getNumSamples() == 1);
+    }
+}
+
+TEST_CASE("Memory-mapped data source") {
+    // columnar file : column x, column 2 * x, column 3 * x
+    int numSamples = 100;
+    {
+        ofstream oFile("mapped_input.bin",ios::binary);
+        for (int column = 1; column <= 3; column++) {
+            for (int i = 0; i < numSamples; i++) {
+                double value = column * i;
+                oFile.write(reinterpret_cast<const char*>(&value),sizeof(double));
+            }
+        }
+    }
+    MappedDataSource dataSource("mapped_input.bin",2,1);
+    REQUIRE(dataSource.isOpen());
+    REQUIRE(dataSource.getNumSamples() == numSamples);
+    dataSource.setBlockSize(7);
+
+    SECTION("every epoch delivers every sample once") {
+        vector<double> inputs(30 * 2);
+        vector<double> outputs(30);
+        vector<int> count(numSamples,0);
+        vector<double> order;
+        for (int batch = 0; batch < 10; batch++) {
+            dataSource.nextBatch(30,inputs.data(),outputs.data());
+            for (int i = 0; i < 30; i++) {
+                int sample = int(inputs[i * 2]);
+                REQUIRE(inputs[i * 2 + 1] == 2 * sample);
+                REQUIRE(outputs[i] == 3 * sample);
+                count[sample]++;
+                order.push_back(sample);
+            }
+        }
+        // 300 samples = 3 epochs
+        for (int i = 0; i < numSamples; i++) {
+            REQUIRE(count[i] == 3);
+        }
+        REQUIRE(!is_sorted(order.begin(),order.begin() + numSamples));
+    }
+
+    SECTION("prefetching keeps the order of the wrapped source") {
+        MappedDataSource referenceDataSource("mapped_input.bin",2,1);
+        referenceDataSource.setBlockSize(7);
+        PrefetchingDataSource prefetchingDataSource(dataSource);
+        REQUIRE(prefetchingDataSource.getNumSamples() == numSamples);
+
+        vector<double> inputs(16 * 2), referenceInputs(16 * 2);
+        vector<double> outputs(16), referenceOutputs(16);
+        for (int batch = 0; batch < 20; batch++) {
+            prefetchingDataSource.nextBatch(16,inputs.data(),outputs.data());
+            referenceDataSource.nextBatch(16,referenceInputs.data(),referenceOutputs.data());
+            REQUIRE(inputs == referenceInputs);
+            REQUIRE(outputs == referenceOutputs);
+        }
+    }
+
+    SECTION("prefetching batches of changing sizes") {
+        // e.g. the unequal shards of data-parallel training, no sample is skipped
+        MappedDataSource referenceDataSource("mapped_input.bin",2,1);
+        referenceDataSource.setBlockSize(7);
+        PrefetchingDataSource prefetchingDataSource(dataSource);
+
+        vector<double> inputs(40 * 2), referenceInputs(40 * 2);
+        vector<double> outputs(40), referenceOutputs(40);
+        vector<int> batchSizes = {16, 5, 5, 6, 40, 1, 16};
+        for (int repetition = 0; repetition < 5; repetition++) {
+            for (int batchSize : batchSizes) {
+                prefetchingDataSource.nextBatch(batchSize,inputs.data(),outputs.data());
+                referenceDataSource.nextBatch(batchSize,referenceInputs.data(),referenceOutputs.data());
+                REQUIRE(equal(inputs.begin(),inputs.begin() + batchSize * 2,referenceInputs.begin()));
+                REQUIRE(equal(outputs.begin(),outputs.begin() + batchSize,referenceOutputs.begin()));
+            }
+        }
+    }
+
+    SECTION("rewinding starts a new epoch") {
+        dataSource.setShuffle(false);
+        PrefetchingDataSource prefetchingDataSource(dataSource);
+        vector<double> inputs(30 * 2);
+        vector<double> outputs(30);
+        prefetchingDataSource.nextBatch(30,inputs.data(),outputs.data());
+        prefetchingDataSource.rewind();
+        prefetchingDataSource.nextBatch(30,inputs.data(),outputs.data());
+        for (int i = 0; i < 30; i++) {
+            REQUIRE(inputs[i * 2] == i);
+        }
+    }
+
+    SECTION("size of the file does not fit to the columns") {
+        MappedDataSource invalidDataSource("mapped_input.bin",3,4);
+        REQUIRE(!invalidDataSource.isOpen());
+    }
+}
+
+TEST_CASE("Generated data source") {
+    Domain domain({-2.0, 0.0},{2.0, 1.0});
+    GeneratorDataSource dataSource(domain,[](const vector<double>& x_) { return vector<double>{x_[0] * x_[1], x_[0] + x_[1]}; },2);
+    dataSource.setNumThreads(3);
+    dataSource.setChunkSize(50);
+    REQUIRE(dataSource.getNumInputs()  == 2);
+    REQUIRE(dataSource.getNumOutputs() == 2);
+    REQUIRE(dataSource.getNumSamples() == 0);
+
+    // batches span several chunks of several producers
+    vector<double> inputs(128 * 2);
+    vector<double> outputs(128 * 2);
+    vector<double> previousInputs;
+    for (int batch = 0; batch < 10; batch++) {
+        dataSource.nextBatch(128,inputs.data(),outputs.data());
+        for (int i = 0; i < 128; i++) {
+            vector<double> x = {inputs[i * 2], inputs[i * 2 + 1]};
+            REQUIRE(domain.contains(x));
+            REQUIRE(nearlyEqual(outputs[i * 2],     x[0] * x[1],1e-15));
+            REQUIRE(nearlyEqual(outputs[i * 2 + 1], x[0] + x[1],1e-15));
+        }
+        // every batch consists of fresh samples
+        REQUIRE(inputs != previousInputs);
+        previousInputs = inputs;
+    }
+}
+
+TEST_CASE("Quasi-random sampling") {
+    Domain unitCube(vector<double>(5,0.0),vector<double>(5,1.0));
+    int m = 8;
+    int numSamples = 1 << m;
+
+    for (int scrambled = 0; scrambled <= 1; scrambled++) {
+        QuasiRandomSampler sobol(unitCube,QuasiRandomSampler::SOBOL,scrambled == 1,42);
+        REQUIRE(sobol.isValid());
+        vector<vector<double>> points = sobol.sample(numSamples);
+        REQUIRE(points.size() == numSamples);
+
+        // the first 2^m points are stratified in every dimension
+        for (int i = 0; i < 5; i++) {
+            vector<int> count(numSamples,0);
+            for (int p = 0; p < numSamples; p++) {
+                REQUIRE(unitCube.contains(points[p]));
+                count[int(points[p][i] * numSamples)]++;
+            }
+            REQUIRE(count == vector<int>(numSamples,1));
+        }
+
+        // the first two dimensions form a (0,m,2)-net : every box of volume 2^-m contains one point
+        for (int a = 0; a <= m; a++) {
+            vector<int> count(numSamples,0);
+            for (int p = 0; p < numSamples; p++) {
+                count[int(points[p][0] * (1 << a)) * (1 << (m - a)) + int(points[p][1] * (1 << (m - a)))]++;
+            }
+            REQUIRE(count == vector<int>(numSamples,1));
+        }
+    }
+
+    SECTION("halton") {
+        QuasiRandomSampler halton(Domain({-1.0, 0.0, 2.0},{1.0, 3.0, 4.0}),QuasiRandomSampler::HALTON);
+        // base 2, 3, 5
+        REQUIRE(halton.point(1) == vector<double>({0.0, 1.0, 2.4}));
+        REQUIRE(nearlyEqual(halton.point(5)[0],0.25,1e-15));
+        REQUIRE(nearlyEqual(halton.point(5)[1],7.0 / 9.0 * 3.0,1e-14));
+
+        // scrambled points in base 3 are stratified for 3^k points
+        QuasiRandomSampler scrambledHalton(unitCube,QuasiRandomSampler::HALTON,true,7);
+        vector<int> count(81,0);
+        for (int p = 0; p < 81; p++) {
+            count[int(scrambledHalton.point(p)[1] * 81 + 1e-9)]++;
+        }
+        REQUIRE(count == vector<int>(81,1));
+    }
+
+    SECTION("training set") {
+        QuasiRandomSampler sobol(Domain({-2.0,-2.0},{2.0,2.0}));
+        vector<vector<double>> inputValues;
+        vector<double> expectedOutputValues;
+        sobol.sample(1024,[](const vector<double>& x_) { return x_[0] * x_[1]; },inputValues,expectedOutputValues);
+        REQUIRE(inputValues.size() == 1024);
+        REQUIRE(expectedOutputValues.size() == 1024);
+        REQUIRE(expectedOutputValues[100] == inputValues[100][0] * inputValues[100][1]);
+
+        // mean of x^2 * y^2 on [-2,2]^2 is 16/9
+        double mean = 0;
+        for (unsigned int i = 0; i < inputValues.size(); i++) {
+            mean += expectedOutputValues[i] * expectedOutputValues[i] / inputValues.size();
+        }
+        REQUIRE(nearlyEqual(mean,16.0 / 9.0,0.02));
+    }
+
+    SECTION("unsupported dimension") {
+        QuasiRandomSampler sobol(Domain(vector<double>(50,0.0),vector<double>(50,1.0)));
+        REQUIRE(!sobol.isValid());
+    }
+}
+
+TEST_CASE("Adaptive sampling") {
+    ANN ann("../caffe_FunctionApproximation/prototxt/extended_net_without_loss.prototxt",
+            "","../caffe_FunctionApproximation/prototxt/test_solver.prototxt");
+
+    AdaptiveTrainer trainer(ann,Domain({-3.0},{3.0}),[](const vector<double>& x_) { return sin(3.0 * x_[0]) / 2.0; });
+    trainer.setInitialSamples(64);
+    trainer.setSamplesPerRound(32);
+    trainer.setCandidatePoolSize(1024);
+    trainer.setIterationsPerRound(500);
+    trainer.setMaxRounds(4);
+    trainer.setMaxSamples(128);
+    trainer.setTargetMaxError(0.0);
+
+    AdaptiveTrainer::Report report;
+    REQUIRE(trainer.train(report));
+    REQUIRE(report.numRounds     == 4);
+    REQUIRE(report.numIterations == 2000);
+    // 64 initial samples + 2 * 32 added, then the budget is exhausted and samples are replaced
+    REQUIRE(report.numSamples    == 128);
+    REQUIRE(!report.converged);
+    REQUIRE(ann.getMaxIterations() == 0);
+    // every round continues from the weights of the previous one
+    REQUIRE(report.maxErrors.size() == 4);
+    REQUIRE(report.maxErrors.back() < report.maxErrors.front());
+    REQUIRE(report.maxErrors.back() == report.maxError);
+    for (unsigned int i = 0; i < trainer.getInputValues().size(); i++) {
+        REQUIRE(Domain({-3.0},{3.0}).contains(trainer.getInputValues()[i]));
+    }
+}
+
+TEST_CASE("Columnar data set") {
+    // x, y, x * y
+    vector<vector<double>> columns(3);
+    for (int i = 0; i < 1000; i++) {
+        double x = -2.0 + 0.004 * i;
+        double y = sin(0.1 * i);
+        columns[0].push_back(x);
+        columns[1].push_back(y);
+        columns[2].push_back(x * y);
+    }
+    REQUIRE(ColumnarDataSet::write("columnar.fad",{"x","y","x*y"},2,columns));
+
+    ColumnarDataSet dataSet;
+    REQUIRE(dataSet.open("columnar.fad"));
+    REQUIRE(dataSet.getNumRows()    == 1000);
+    REQUIRE(dataSet.getNumColumns() == 3);
+    REQUIRE(dataSet.getNumInputs()  == 2);
+    REQUIRE(dataSet.getNumOutputs() == 1);
+    REQUIRE(dataSet.getColumn(2).name == "x*y");
+    REQUIRE(dataSet.getColumn(0).minimum == -2.0);
+    REQUIRE(nearlyEqual(dataSet.getColumn(0).maximum,1.996,1e-12));
+    REQUIRE(nearlyEqual(dataSet.getColumn(0).mean,-0.002,1e-12));
+    // standard deviation of an arithmetic sequence : step * sqrt(n * (n + 1) / 12)
+    REQUIRE(nearlyEqual(dataSet.getColumn(0).standardDeviation,0.004 * sqrt(1000.0 * 1001.0 / 12.0),1e-9));
+    for (int j = 0; j < 3; j++) {
+        REQUIRE(reinterpret_cast<size_t>(dataSet.getColumnData(j)) % ColumnarDataSet::getAlignment() == 0);
+        REQUIRE(equal(columns[j].begin(),columns[j].end(),dataSet.getColumnData(j)));
+    }
+
+    SECTION("csv round trip") {
+        REQUIRE(ColumnarDataSet::convertToCSV("columnar.fad","columnar.csv"));
+        REQUIRE(ColumnarDataSet::convertFromCSV("columnar.csv","columnar_from_csv.fad",2));
+        ColumnarDataSet converted;
+        REQUIRE(converted.open("columnar_from_csv.fad"));
+        REQUIRE(converted.getNumRows() == 1000);
+        REQUIRE(converted.getColumn(1).name == "y");
+        for (int j = 0; j < 3; j++) {
+            REQUIRE(equal(columns[j].begin(),columns[j].end(),converted.getColumnData(j)));
+            REQUIRE(reinterpret_cast<size_t>(converted.getColumnData(j)) % ColumnarDataSet::getAlignment() == 0);
+            REQUIRE(nearlyEqual(converted.getColumn(j).mean,dataSet.getColumn(j).mean,1e-12));
+            REQUIRE(nearlyEqual(converted.getColumn(j).standardDeviation,dataSet.getColumn(j).standardDeviation,1e-12));
+        }
+    }
+
+    SECTION("data source") {
+        MappedDataSource dataSource("columnar.fad");
+        REQUIRE(dataSource.getNumInputs()  == 2);
+        REQUIRE(dataSource.getNumOutputs() == 1);
+        vector<double> inputs(100 * 2), outputs(100);
+        dataSource.nextBatch(100,inputs.data(),outputs.data());
+        for (int i = 0; i < 100; i++) {
+            REQUIRE(outputs[i] == inputs[i * 2] * inputs[i * 2 + 1]);
+        }
+    }
+
+    SECTION("invalid file") {
+        ofstream oFile("columnar_invalid.fad");
+        oFile << "x,y" << endl;
+        oFile.close();
+        ColumnarDataSet invalid;
+        REQUIRE(!invalid.open("columnar_invalid.fad"));
+        REQUIRE(!invalid.isOpen());
+    }
+
+    SECTION("number of rows beyond the file") {
+        REQUIRE(ColumnarDataSet::write("columnar_too_many_rows.fad",{"x","y","x*y"},2,columns));
+        // numRows follows magic, version and number of columns, numRows * 8 overflows
+        fstream file("columnar_too_many_rows.fad",ios::binary | ios::in | ios::out);
+        uint64_t numRows = (1ULL << 61) + 1;
+        file.seekp(16);
+        file.write(reinterpret_cast<const char*>(&numRows),sizeof(numRows));
+        file.close();
+        ColumnarDataSet invalid;
+        REQUIRE(!invalid.open("columnar_too_many_rows.fad"));
+    }
+}
+
+
+TEST_CASE("CSV reading and writing") {
+    mt19937_64 generator(7);
+    uniform_real_distribution<double> distribution(-1000.0,1000.0);
+    const int numRows = 40000;
+    vector<double> values;
+    for (int i = 0; i < numRows * 3; i++) {
+        double value = distribution(generator);
+        // mix long random values with short decimal ones
+        values.push_back((i % 4 == 0) ? round(value * 100.0) / 100.0 : value);
+    }
+    values[5] = 1e-300;
+    values[6] = -2.5e300;
+    values[7] = 0.0;
+
+    SECTION("shortest round trip") {
+        char buffer[32];
+        REQUIRE(string(buffer,CsvWriter::formatDouble(0.1,buffer)) == "0.1");
+        REQUIRE(string(buffer,CsvWriter::formatDouble(-1.5,buffer)) == "-1.5");
+        for (unsigned int i = 0; i < values.size(); i++) {
+            int length = CsvWriter::formatDouble(values[i],buffer);
+            double value;
+            REQUIRE(CsvReader::parseDouble(buffer,buffer + length,value) == buffer + length);
+            REQUIRE(value == values[i]);
+            REQUIRE(value == strtod(buffer,nullptr));
+        }
+    }
+
+    SECTION("parsing") {
+        const char* texts[] = {"42", "-0.001", "+3.25e2", "1E-5", "123456789012345678901234", "0.30000000000000004", "2.2250738585072014e-308", "7e"};
+        for (const char* text : texts) {
+            double value;
+            const char* end = CsvReader::parseDouble(text,text + strlen(text),value);
+            REQUIRE(value == strtod(text,nullptr));
+            REQUIRE(end == text + strlen(text) - (text[strlen(text) - 1] == 'e' ? 1 : 0));
+        }
+        double value;
+        const char* text = "x,1";
+        REQUIRE(CsvReader::parseDouble(text,text + 3,value) == text);
+    }
+
+    SECTION("file round trip") {
+        {
+            CsvWriter writer("csv_io.csv",4096);
+            REQUIRE(writer.isOpen());
+            writer.writeHeader({"a","b","c"});
+            writer.writeRows(values.data(),numRows,3);
+            REQUIRE(writer.close());
+        }
+
+        CsvReader reader;
+        reader.setNumThreads(1);
+        REQUIRE(reader.read("csv_io.csv"));
+        REQUIRE(reader.getNumColumns() == 3);
+        REQUIRE(reader.getNumRows() == (size_t)numRows);
+        REQUIRE(reader.getColumnNames() == vector<string>({"a","b","c"}));
+        REQUIRE(reader.getValues() == values);
+        REQUIRE(reader.getColumn(1)[3] == values[3 * 3 + 1]);
+        REQUIRE(reader.getRows(0,2)[3] == vector<double>({values[3 * 3],values[3 * 3 + 1]}));
+
+        CsvReader parallelReader;
+        parallelReader.setNumThreads(4);
+        REQUIRE(parallelReader.read("csv_io.csv"));
+        REQUIRE(parallelReader.getValues() == values);
+
+        // block by block, the last block is smaller
+        CsvReader blockReader;
+        vector<double> blockValues;
+        REQUIRE(blockReader.readBlocks("csv_io.csv",3000,[&](const double* values_, size_t numRows_) {
+            REQUIRE(numRows_ <= 3000);
+            blockValues.insert(blockValues.end(),values_,values_ + numRows_ * 3);
+            return true;
+        }));
+        REQUIRE(blockReader.getNumColumns() == 3);
+        REQUIRE(blockReader.getColumnNames() == vector<string>({"a","b","c"}));
+        REQUIRE(blockValues == values);
+    }
+
+    SECTION("decimal comma locale") {
+        // the output must not depend on the locale of the process
+        if (setlocale(LC_NUMERIC,"de_DE.UTF-8") != nullptr) {
+            char buffer[32];
+            REQUIRE(string(buffer,CsvWriter::formatDouble(0.25,buffer)) == "0.25");
+            // long mantissas are converted by strtod
+            const char* text = "0.30000000000000004";
+            double value;
+            REQUIRE(CsvReader::parseDouble(text,text + strlen(text),value) == text + strlen(text));
+            REQUIRE(value == 0.1 + 0.2);
+            setlocale(LC_NUMERIC,"C");
+        }
+    }
+
+    SECTION("invalid lines") {
+        ofstream oFile("csv_io_invalid.csv");
+        oFile << "x,y\n1,2\n\n3,4\r\n5\n";
+        oFile.close();
+        CsvReader reader;
+        REQUIRE(!reader.read("csv_io_invalid.csv"));
+        REQUIRE(!reader.readBlocks("csv_io_invalid.csv",2,[](const double*, size_t) { return true; }));
+    }
+}
+
+TEST_CASE("Normalization") {
+    mt19937_64 generator(3);
+    normal_distribution<double> distribution(5.0,2.0);
+    const int numRows = 200000;
+    vector<double> rows(numRows * 2);
+    for (int i = 0; i < numRows; i++) {
+        rows[i * 2]     = distribution(generator);
+        rows[i * 2 + 1] = -1000.0 + 0.01 * i;
+    }
+
+    Normalizer normalizer(Normalizer::Z_SCORE);
+    normalizer.setNumThreads(4);
+    normalizer.fit(rows.data(),numRows,2);
+    REQUIRE(normalizer.getCount() == (unsigned long long)numRows);
+
+    // two pass reference
+    for (int j = 0; j < 2; j++) {
+        double mean = 0.0;
+        for (int i = 0; i < numRows; i++) {
+            mean += rows[i * 2 + j];
+        }
+        mean /= numRows;
+        double sumOfSquares = 0.0;
+        for (int i = 0; i < numRows; i++) {
+            sumOfSquares += (rows[i * 2 + j] - mean) * (rows[i * 2 + j] - mean);
+        }
+        REQUIRE(nearlyEqual(normalizer.getMean(j),mean,1e-9));
+        REQUIRE(nearlyEqual(normalizer.getStandardDeviation(j),sqrt(sumOfSquares / (numRows - 1)),1e-9));
+    }
+    REQUIRE(normalizer.getMinimum(1) == -1000.0);
+    REQUIRE(nearlyEqual(normalizer.getMaximum(1),-1000.0 + 0.01 * (numRows - 1),1e-9));
+
+    SECTION("streaming and merging") {
+        Normalizer streamed(Normalizer::Z_SCORE);
+        Normalizer second  (Normalizer::Z_SCORE);
+        streamed.update(rows.data(),1000,2);
+        streamed.update(rows.data() + 1000 * 2,50000,2);
+        second.fit(rows.data() + 51000 * 2,numRows - 51000,2);
+        streamed.merge(second);
+        for (int j = 0; j < 2; j++) {
+            REQUIRE(nearlyEqual(streamed.getMean(j),normalizer.getMean(j),1e-9));
+            REQUIRE(nearlyEqual(streamed.getStandardDeviation(j),normalizer.getStandardDeviation(j),1e-9));
+        }
+    }
+
+    SECTION("transform and inverse transform") {
+        vector<double> transformed = normalizer.transform(rows);
+        REQUIRE(nearlyEqual(transformed[0],(rows[0] - normalizer.getMean(0)) / normalizer.getStandardDeviation(0),1e-12));
+        vector<double> restored = normalizer.inverseTransform(transformed);
+        for (int i = 0; i < numRows * 2; i++) {
+            REQUIRE(nearlyEqual(restored[i],rows[i],1e-9));
+        }
+
+        normalizer.setMethod(Normalizer::MIN_MAX);
+        vector<vector<double>> extremes = normalizer.transform(vector<vector<double>>({{normalizer.getMinimum(0),normalizer.getMinimum(1)},
+                                                                                      {normalizer.getMaximum(0),normalizer.getMaximum(1)}}));
+        REQUIRE(nearlyEqual(extremes[0][0],-1.0,1e-12));
+        REQUIRE(nearlyEqual(extremes[0][1],-1.0,1e-12));
+        REQUIRE(nearlyEqual(extremes[1][0], 1.0,1e-12));
+        REQUIRE(nearlyEqual(extremes[1][1], 1.0,1e-12));
+    }
+
+    SECTION("persistence") {
+        REQUIRE(normalizer.save("normalizer.txt"));
+        Normalizer loaded(Normalizer::NONE);
+        REQUIRE(loaded.load("normalizer.txt"));
+        REQUIRE(loaded.getMethod() == Normalizer::Z_SCORE);
+        REQUIRE(loaded.getCount() == normalizer.getCount());
+        REQUIRE(loaded.transform(rows) == normalizer.transform(rows));
+
+        ofstream oFile("normalizer_invalid.txt");
+        oFile << "normalizer z_score 1\n5 x 1 2 3\n";
+        oFile.close();
+        REQUIRE(!loaded.load("normalizer_invalid.txt"));
+        REQUIRE(loaded.getNumFeatures() == 2);
+    }
+
+    SECTION("folded into an MLP") {
+        // inputs : both features of rows, output : a third feature
+        Normalizer inputNormalizer(Normalizer::MIN_MAX);
+        Normalizer outputNormalizer(Normalizer::Z_SCORE);
+        inputNormalizer.fit(rows.data(),numRows,2);
+        outputNormalizer.fit(vector<double>({-3.0, 1.0, 4.0, 10.0}));
+
+        MLP::DenseLayer hidden;
+        hidden.numInputs  = 2;
+        hidden.numOutputs = 3;
+        hidden.weights    = {0.5, -1.0, 2.0, 0.25, -0.75, 1.5};
+        hidden.biases     = {0.1, -0.2, 0.3};
+        hidden.activation = MLP::TANH;
+        MLP::DenseLayer output;
+        output.numInputs  = 3;
+        output.numOutputs = 1;
+        output.weights    = {1.0, -2.0, 0.5};
+        output.biases     = {0.4};
+
+        for (MLP::Activation activation : {MLP::LINEAR, MLP::TANH}) {
+            output.activation = activation;
+            MLP mlp;
+            REQUIRE(mlp.addLayer(hidden));
+            REQUIRE(mlp.addLayer(output));
+            MLP normalizedMlp = mlp;
+            REQUIRE(normalizedMlp.addNormalization(inputNormalizer,outputNormalizer));
+            // an output activation needs an additional layer
+            REQUIRE(normalizedMlp.getLayers().size() == ((activation == MLP::LINEAR) ? 2u : 3u));
+
+            for (int i = 0; i < 1000; i++) {
+                vector<double> input(&rows[i * 2],&rows[i * 2 + 2]);
+                double expected = outputNormalizer.inverseTransform(mlp.forward(inputNormalizer.transform(input)))[0];
+                REQUIRE(nearlyEqual(normalizedMlp.forward(input)[0],expected,1e-9));
+            }
+        }
+    }
+
+    SECTION("constant feature") {
+        Normalizer constant;
+        constant.fit(vector<double>(10,3.0));
+        REQUIRE(constant.transform(vector<double>(1,3.0))[0] == 0.0);
+        REQUIRE(constant.inverseTransform(vector<double>(1,0.0))[0] == 3.0);
+    }
+}
+
+TEST_CASE("In-place transforms") {
+    mt19937_64 generator(11);
+    uniform_real_distribution<double> distribution(-10.0,10.0);
+
+    for (int numColumns : {1, 2, 3, 7, 300}) {
+        for (size_t numRows : {(size_t)1, (size_t)5, (size_t)1000, (size_t)100000}) {
+            vector<double> values(numRows * numColumns);
+            for (double& value : values) {
+                value = distribution(generator);
+            }
+            vector<double> factors(numColumns), summands(numColumns);
+            for (int c = 0; c < numColumns; c++) {
+                factors[c]  = distribution(generator);
+                summands[c] = distribution(generator);
+            }
+
+            // identical to the scalar expressions, also when split across threads
+            vector<double> transformed = values;
+            Transforms::multiplyAdd(transformed.data(),numRows,numColumns,factors.data(),summands.data());
+            vector<double> scaled = values;
+            Transforms::scale(scaled.data(),numRows,numColumns,factors.data());
+            vector<double> divided = values;
+            Transforms::divide(divided.data(),numRows,numColumns,factors.data());
+            vector<double> shifted = values;
+            Transforms::shift(shifted.data(),numRows,numColumns,summands.data());
+            size_t numMismatches = 0;
+            for (size_t r = 0; r < numRows; r++) {
+                for (int c = 0; c < numColumns; c++) {
+                    size_t i = r * numColumns + c;
+                    double product = values[i] * factors[c];
+                    numMismatches += (transformed[i] != product + summands[c]);
+                    numMismatches += (scaled[i]      != product);
+                    numMismatches += (divided[i]     != values[i] / factors[c]);
+                    numMismatches += (shifted[i]     != values[i] + summands[c]);
+                }
+            }
+            REQUIRE(numMismatches == 0);
+        }
+    }
+
+    SECTION("z-transformation") {
+        vector<double> values = {1.0, 10.0, 3.0, 20.0, 5.0, 30.0};
+        vector<double> means = {3.0, 20.0};
+        vector<double> standardDeviations = {2.0, 10.0};
+        vector<double> transformed = values;
+        Transforms::zTransform(transformed.data(),3,2,means.data(),standardDeviations.data());
+        REQUIRE(transformed == vector<double>({-1.0, -1.0, 0.0, 0.0, 1.0, 1.0}));
+        Transforms::inverseZTransform(transformed.data(),3,2,means.data(),standardDeviations.data());
+        REQUIRE(transformed == values);
+    }
+}
+
+TEST_CASE("Matrix") {
+    vector<vector<double>> rows = {{1.0, 2.0, 3.0}, {4.0, 5.0, 6.0}, {7.0, 8.0, 9.0}, {10.0, 11.0, 12.0}};
+    Matrix matrix(rows);
+    REQUIRE(matrix.getNumRows()    == 4);
+    REQUIRE(matrix.getNumColumns() == 3);
+    REQUIRE(reinterpret_cast<size_t>(matrix.data()) % Matrix::getAlignment() == 0);
+    REQUIRE(matrix(2,1) == 8.0);
+    REQUIRE(matrix.row(3)[2] == 12.0);
+    REQUIRE(matrix.toRows() == rows);
+
+    SECTION("views") {
+        MatrixView view = matrix;
+        REQUIRE(view.data() == matrix.data());
+        MatrixView lastRows = view.rows(2,2);
+        REQUIRE(lastRows.getNumRows() == 2);
+        REQUIRE(lastRows(0,0) == 7.0);
+        REQUIRE(Matrix(lastRows).toRows() == vector<vector<double>>(rows.begin() + 2,rows.end()));
+
+        vector<double> flat = {1.0, 2.0, 3.0, 4.0};
+        MatrixView flatView(flat,2);
+        REQUIRE(flatView.getNumRows() == 2);
+        REQUIRE(flatView(1,0) == 3.0);
+    }
+
+    SECTION("copy and move") {
+        Matrix copied = matrix;
+        copied(0,0) = -1.0;
+        REQUIRE(matrix(0,0) == 1.0);
+        REQUIRE(copied.data() != matrix.data());
+
+        const double* data = copied.data();
+        Matrix moved(std::move(copied));
+        REQUIRE(moved.data() == data);
+        REQUIRE(copied.isEmpty());
+
+        matrix = moved;
+        REQUIRE(matrix(0,0) == -1.0);
+        matrix.resize(2,3);
+        REQUIRE(matrix.data() != nullptr);
+        REQUIRE(matrix(1,2) == 6.0);
+    }
+
+    SECTION("data source and normalizer") {
+        Matrix outputs(4,1);
+        for (int i = 0; i < 4; i++) {
+            outputs(i,0) = matrix(i,0) + matrix(i,1) + matrix(i,2);
+        }
+        InMemoryDataSource dataSource(matrix,outputs);
+        dataSource.setShuffle(false);
+        REQUIRE(dataSource.getNumInputs()  == 3);
+        REQUIRE(dataSource.getNumSamples() == 4);
+        vector<double> inputValues(6), outputValues(2);
+        dataSource.nextBatch(2,inputValues.data(),outputValues.data());
+        REQUIRE(inputValues  == vector<double>({1.0, 2.0, 3.0, 4.0, 5.0, 6.0}));
+        REQUIRE(outputValues == vector<double>({6.0, 15.0}));
+
+        Normalizer normalizer(Normalizer::MIN_MAX);
+        normalizer.fit(matrix);
+        Matrix normalized = matrix;
+        normalizer.transform(normalized);
+        REQUIRE(nearlyEqual(normalized(0,0),-1.0,1e-12));
+        REQUIRE(nearlyEqual(normalized(3,2), 1.0,1e-12));
+        normalizer.inverseTransform(normalized);
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 3; j++) {
+                REQUIRE(nearlyEqual(normalized(i,j),rows[i][j],1e-12));
+            }
+        }
+    }
+}
+
+TEST_CASE("Ring all-reduce") {
+    for (int worldSize : {1, 2, 3, 5}) {
+        // every rank checks the results itself, the launcher collects the exit codes
+        bool success = DistributedLauncher::run(worldSize,0,[worldSize](RingAllReduce& ring_) {
+            for (size_t numValues : {(size_t)1, (size_t)4, (size_t)1001, (size_t)300000}) {
+                vector<double> values(numValues);
+                for (size_t i = 0; i < numValues; i++) {
+                    values[i] = i * (ring_.getRank() + 1);
+                }
+                if (!ring_.allReduce(values.data(),numValues)) {
+                    return false;
+                }
+                double factor = worldSize * (worldSize + 1) / 2;
+                for (size_t i = 0; i < numValues; i++) {
+                    if (values[i] != i * factor) {
+                        return false;
+                    }
+                }
+            }
+
+            string data = ring_.getRank() == 1 % worldSize ? "weights of rank 1" : "";
+            return ring_.broadcast(data,1 % worldSize) && data == "weights of rank 1" && ring_.barrier();
+        });
+        REQUIRE(success);
+    }
+
+    SECTION("a missing rank is reported") {
+        vector<string> addresses = RingAllReduce::localAddresses(2,RingAllReduce::freeLocalPorts(2));
+        RingAllReduce ring(0,addresses,1);
+        REQUIRE_FALSE(ring.isOpen());
+        double value = 1.0;
+        REQUIRE_FALSE(ring.allReduce(&value,1));
+    }
+}
+
+TEST_CASE("Levenberg-Marquardt training") {
+    // mlp(x,y) with 2 hidden tanh layers of 10 neurons and a linear output, random initial weights
+    mt19937_64 generator(5);
+    normal_distribution<double> distribution(0.0,0.5);
+    MLP mlp;
+    int sizes[] = {2, 10, 10, 1};
+    for (int l = 0; l < 3; l++) {
+        MLP::DenseLayer layer;
+        layer.numInputs  = sizes[l];
+        layer.numOutputs = sizes[l + 1];
+        layer.weights.resize(layer.numInputs * layer.numOutputs);
+        layer.biases.resize(layer.numOutputs);
+        for (double& weight : layer.weights) {
+            weight = distribution(generator);
+        }
+        for (double& bias : layer.biases) {
+            bias = distribution(generator);
+        }
+        layer.activation = (l < 2) ? MLP::TANH : MLP::LINEAR;
+        REQUIRE(mlp.addLayer(layer));
+    }
+    REQUIRE(mlp.getNumParameters() == 30 + 110 + 11);
+    vector<double> parameters = mlp.getParameters();
+    REQUIRE(mlp.setParameters(parameters));
+    REQUIRE(mlp.getParameters() == parameters);
+
+    // x * y on [-1,1]^2
+    Matrix inputValues(441,2), expectedOutputValues(441,1);
+    for (int i = 0; i < 21; i++) {
+        for (int j = 0; j < 21; j++) {
+            inputValues(i * 21 + j,0) = -1.0 + 0.1 * i;
+            inputValues(i * 21 + j,1) = -1.0 + 0.1 * j;
+            expectedOutputValues(i * 21 + j,0) = inputValues(i * 21 + j,0) * inputValues(i * 21 + j,1);
+        }
+    }
+
+    LevenbergMarquardt trainer;
+    trainer.setMaxIterations(150);
+    LevenbergMarquardt::Report report;
+    REQUIRE(trainer.train(mlp,inputValues,expectedOutputValues,report));
+    report.print(cout);
+    REQUIRE(report.loss < report.initialLoss);
+    REQUIRE(report.loss < 1e-5);
+
+    Matrix outputValues(441,1);
+    mlp.forward(inputValues.data(),441,outputValues.data());
+    int numMismatches = 0;
+    for (int i = 0; i < 441; i++) {
+        numMismatches += !nearlyEqual(outputValues(i,0),expectedOutputValues(i,0),0.01);
+    }
+    REQUIRE(numMismatches == 0);
+
+    SECTION("samples which do not fit to the MLP are rejected") {
+        REQUIRE_FALSE(trainer.train(mlp,MatrixView(inputValues.data(),441,1),expectedOutputValues,report));
+    }
+
+    SECTION("Cholesky solver") {
+        vector<double> matrix = {4.0, 2.0, 2.0, 3.0};
+        vector<double> rightHandSide = {2.0, 1.0};
+        REQUIRE(LinearAlgebra::solveCholesky(matrix,2,rightHandSide));
+        REQUIRE(nearlyEqual(rightHandSide[0],0.5,1e-12));
+        REQUIRE(nearlyEqual(rightHandSide[1],0.0,1e-12));
+        vector<double> indefinite = {1.0, 2.0, 2.0, 1.0};
+        REQUIRE_FALSE(LinearAlgebra::solveCholesky(indefinite,2,rightHandSide));
+    }
+}
+
+TEST_CASE("L-BFGS minimization") {
+    LBFGS optimizer;
+    LBFGS::Report report;
+
+    SECTION("Rosenbrock function") {
+        // f(x) = sum (1 - x_i)^2 + 100 * (x_{i+1} - x_i^2)^2, minimum 0 at (1, ..., 1)
+        LBFGS::Objective rosenbrock = [](const vector<double>& x_, vector<double>& gradient_) {
+            double value = 0;
+            fill(gradient_.begin(),gradient_.end(),0.0);
+            for (size_t i = 0; i + 1 < x_.size(); i++) {
+                double a = 1.0 - x_[i];
+                double b = x_[i + 1] - x_[i] * x_[i];
+                value += a * a + 100.0 * b * b;
+                gradient_[i]     += -2.0 * a - 400.0 * b * x_[i];
+                gradient_[i + 1] += 200.0 * b;
+            }
+            return value;
+        };
+        vector<double> x(10,-1.2);
+        REQUIRE(optimizer.minimize(x,rosenbrock,report));
+        report.print(cout);
+        REQUIRE(report.converged);
+        REQUIRE(report.loss < 1e-12);
+        for (double value : x) {
+            REQUIRE(nearlyEqual(value,1.0,1e-5));
+        }
+
+        // deterministic : the same start point gives the same iterations
+        vector<double> y(10,-1.2);
+        LBFGS::Report secondReport;
+        REQUIRE(optimizer.minimize(y,rosenbrock,secondReport));
+        REQUIRE(y == x);
+        REQUIRE(secondReport.numEvaluations == report.numEvaluations);
+    }
+
+    SECTION("ill-conditioned quadratic") {
+        // f(x) = 0.5 * sum 10^(i/5) * (x_i - i)^2 with a condition number of about 10^4
+        LBFGS::Objective quadratic = [](const vector<double>& x_, vector<double>& gradient_) {
+            double value = 0;
+            for (size_t i = 0; i < x_.size(); i++) {
+                double scale = pow(10.0,i / 5.0);
+                gradient_[i] = scale * (x_[i] - i);
+                value += 0.5 * scale * (x_[i] - i) * (x_[i] - i);
+            }
+            return value;
+        };
+        vector<double> x(20,0.0);
+        optimizer.setHistorySize(20);
+        optimizer.setGradientTolerance(1e-8);
+        REQUIRE(optimizer.getHistorySize() == 20);
+        REQUIRE(optimizer.minimize(x,quadratic,report));
+        REQUIRE(report.converged);
+        REQUIRE(report.numIterations < optimizer.getMaxIterations());
+        int numMismatches = 0;
+        for (size_t i = 0; i < x.size(); i++) {
+            numMismatches += !nearlyEqual(x[i],i,1e-6);
+        }
+        REQUIRE(numMismatches == 0);
+    }
+
+    SECTION("the start point is a minimum") {
+        LBFGS::Objective square = [](const vector<double>& x_, vector<double>& gradient_) {
+            gradient_[0] = 2.0 * x_[0];
+            return x_[0] * x_[0];
+        };
+        vector<double> x(1,0.0);
+        REQUIRE(optimizer.minimize(x,square,report));
+        REQUIRE(report.converged);
+        REQUIRE(report.numIterations == 0);
+        REQUIRE(x[0] == 0.0);
+    }
+}
+
 /*
 TEST_CASE( "Simple Forward Net scalar input Value -> tanh -> scalar output value" ) {
     ANN ann("../caffe_FunctionApproximation/prototxt/very_simple_net.prototxt");
@@ -396,20 +1627,19 @@ TEST_CASE("Multi-Dimensional function") {
             x += step;
         }
 
-        inputValues = ann.scaleVector(inputValues,2,true);
-        expectedResults = ann.scaleVector(expectedResults,10,true);
+        // x, y and x*y are mapped onto [-1,1] by normalizers fitted while training
+        ann.setNormalization(Normalizer::MIN_MAX);
         REQUIRE(ann.train(inputValues,expectedResults));
+        REQUIRE(ann.getInputNormalizer().getNumFeatures() == 2);
+        REQUIRE(nearlyEqual(ann.getOutputNormalizer().getMaximum(0),4.0,1e-9));
         SECTION( "propagate through trained network" ) {
             vector<vector<double>> annOut;
             annOut = ann.forward(inputValues);
 
-            expectedResults = ann.scaleVector(expectedResults,10,false);
-            annOut = ann.scaleVector(annOut,10,false);
-            inputValues = ann.scaleVector(inputValues,2,false);
-
-            ofstream oFile("x_mult_y.csv");
+            CsvWriter oFile("x_mult_y.csv");
+            oFile.writeHeader({"x","y","expected","annOut"});
             for (int i = 0; i < inputValues.size(); i++) {
-                oFile << inputValues[i][0] << "," << inputValues[i][1] << ","  << expectedResults[i] << "," << annOut[i][0] << endl;
+                oFile.writeRow({inputValues[i][0],inputValues[i][1],expectedResults[i],annOut[i][0]});
                 cout << "for : " << inputValues[i][0] << "," << inputValues[i][1] << " x+y : "  << expectedResults[i] << endl;
                 cout << "for : " << inputValues[i][0] << "," << inputValues[i][1] << " annOut : "  << annOut[i][0] << endl;
                 REQUIRE(nearlyEqual(expectedResults[i],annOut[i][0],1.0));
@@ -420,3 +1650,772 @@ TEST_CASE("Multi-Dimensional function") {
 
     }
 }
+
+
+TEST_CASE("Multi-output function") {
+    ANN ann("../caffe_FunctionApproximation/prototxt/multi_output_extended_net_without_loss.prototxt",
+            "","../caffe_FunctionApproximation/prototxt/multi_output_extended_net_test_solver.prototxt");
+
+    SECTION( "train for ann=(x*y, x+y)" ) {
+        vector<vector<double>> inputValues;
+        vector<vector<double>> expectedResults;
+
+        for (double x = -2.0; x <= 2.0; x += 0.1) {
+            for (double y = -2.0; y <= 2.0; y += 0.1) {
+                inputValues.push_back({x,y});
+                expectedResults.push_back({x*y,x+y});
+            }
+        }
+
+        // both outputs are learned by one net, the expected output data has two channels
+        ann.setNormalization(Normalizer::MIN_MAX);
+        REQUIRE(ann.train(inputValues,expectedResults));
+        REQUIRE(ann.getOutputNormalizer().getNumFeatures() == 2);
+
+        // a target with the wrong number of outputs is rejected
+        REQUIRE_FALSE(ann.train(inputValues,vector<double>(inputValues.size(),0.0)));
+
+        SECTION( "propagate through trained network" ) {
+            vector<vector<double>> annOut = ann.forward(inputValues);
+            REQUIRE(annOut.size() == inputValues.size());
+            for (unsigned int i = 0; i < inputValues.size(); i++) {
+                REQUIRE(annOut[i].size() == 2);
+                REQUIRE(nearlyEqual(expectedResults[i][0],annOut[i][0],1.0));
+                REQUIRE(nearlyEqual(expectedResults[i][1],annOut[i][1],1.0));
+            }
+        }
+    }
+}
+
+
+TEST_CASE("Data-parallel training") {
+    ANN ann("../caffe_FunctionApproximation/prototxt/multi_input_extended_net_without_loss.prototxt",
+            "","../caffe_FunctionApproximation/prototxt/multi_input_extended_net_test_solver.prototxt");
+
+    vector<vector<double>> inputValues;
+    vector<double> expectedResults;
+    for (double x = -2.0; x <= 2.0; x += 0.1) {
+        for (double y = -2.0; y <= 2.0; y += 0.1) {
+            inputValues.push_back({x,y});
+            expectedResults.push_back(x*y);
+        }
+    }
+
+    // every iteration of 100 samples is split into 4 shards of 25 samples
+    ann.setNormalization(Normalizer::MIN_MAX);
+    ann.setBatchSize(100);
+    ann.setNumThreads(4);
+    REQUIRE(ann.train(inputValues,expectedResults));
+
+    vector<vector<double>> annOut = ann.forward(inputValues);
+    for (unsigned int i = 0; i < inputValues.size(); i++) {
+        REQUIRE(nearlyEqual(expectedResults[i],annOut[i][0],1.0));
+    }
+}
+
+
+
+TEST_CASE("Asynchronous training") {
+    vector<vector<double>> inputValues;
+    vector<double> expectedResults;
+    for (double x = -2.0; x <= 2.0; x += 0.1) {
+        for (double y = -2.0; y <= 2.0; y += 0.1) {
+            inputValues.push_back({x,y});
+            expectedResults.push_back(x*y);
+        }
+    }
+
+    // both modes reach the accuracy with the same number of weight updates
+    for (bool asynchronous : {false, true}) {
+        ANN ann("../caffe_FunctionApproximation/prototxt/multi_input_extended_net_without_loss.prototxt",
+                "","../caffe_FunctionApproximation/prototxt/multi_input_extended_net_test_solver.prototxt");
+        ann.setNormalization(Normalizer::MIN_MAX);
+        ann.setBatchSize(64);
+        ann.setNumThreads(4);
+        ann.setMaxIterations(20000);
+        ann.setAsynchronous(asynchronous);
+
+        REQUIRE(ann.train(inputValues,expectedResults));
+
+        vector<vector<double>> annOut = ann.forward(inputValues);
+        double sumSquaredError = 0;
+        for (unsigned int i = 0; i < inputValues.size(); i++) {
+            sumSquaredError += (annOut[i][0] - expectedResults[i]) * (annOut[i][0] - expectedResults[i]);
+        }
+        double rootMeanSquareError = sqrt(sumSquaredError / inputValues.size());
+        if (asynchronous) {
+            REQUIRE(ann.getAsynchronousReport().numUpdates == 20000);
+        }
+        // the snapshot is named after the updates of all threads
+        string weightsPath = ann.getTrainedWeightsCaffemodelPath();
+        REQUIRE(weightsPath.size() > 22);
+        REQUIRE(weightsPath.compare(weightsPath.size() - 22,22,"_iter_20000.caffemodel") == 0);
+        REQUIRE(rootMeanSquareError < 1.0);
+    }
+}
+
+
+TEST_CASE("Distributed training") {
+    vector<vector<double>> inputValues;
+    vector<double> expectedResults;
+    for (double x = -2.0; x <= 2.0; x += 0.1) {
+        for (double y = -2.0; y <= 2.0; y += 0.1) {
+            inputValues.push_back({x,y});
+            expectedResults.push_back(x*y);
+        }
+    }
+
+    // two processes on this machine, every rank trains on every second sample
+    bool success = DistributedLauncher::run(2,0,[&inputValues, &expectedResults](RingAllReduce& ring_) {
+        vector<vector<double>> inputShard;
+        vector<double> expectedShard;
+        for (unsigned int i = ring_.getRank(); i < inputValues.size(); i += ring_.getWorldSize()) {
+            inputShard.push_back(inputValues[i]);
+            expectedShard.push_back(expectedResults[i]);
+        }
+
+        ANN ann("../caffe_FunctionApproximation/prototxt/multi_input_extended_net_without_loss.prototxt",
+                "","../caffe_FunctionApproximation/prototxt/multi_input_extended_net_test_solver.prototxt");
+        ann.setNormalization(Normalizer::MIN_MAX);
+        ann.setBatchSize(50);
+        ann.setMaxIterations(20000);
+        ann.setRing(&ring_);
+        return ann.train(inputShard,expectedShard) && ann.getTrainedWeightsCaffemodelPath() == "train_iter_20000.caffemodel";
+    });
+    REQUIRE(success);
+
+    // the weights saved by rank 0 approximate all samples
+    ANN ann("../caffe_FunctionApproximation/prototxt/multi_input_extended_net_without_loss.prototxt","train_iter_20000.caffemodel");
+    vector<vector<double>> annOut = ann.forward(inputValues);
+    for (unsigned int i = 0; i < inputValues.size(); i++) {
+        REQUIRE(nearlyEqual(expectedResults[i],annOut[i][0],1.0));
+    }
+}
+
+
+TEST_CASE("Adaptive optimizers") {
+    vector<vector<double>> inputValues;
+    vector<double> expectedResults;
+    for (double x = -2.0; x <= 2.0; x += 0.1) {
+        for (double y = -2.0; y <= 2.0; y += 0.1) {
+            inputValues.push_back({x,y});
+            expectedResults.push_back(x*y);
+        }
+    }
+
+    // convergence of all solver types after 20000 iterations (momentum SGD needs 450000)
+    map<string,string> solvers = {{"SGD"      ,"multi_input_extended_net_test_solver.prototxt"},
+                                  {"Nesterov" ,"multi_input_extended_net_nesterov_solver.prototxt"},
+                                  {"RMSProp"  ,"multi_input_extended_net_rmsprop_solver.prototxt"},
+                                  {"AdaDelta" ,"multi_input_extended_net_adadelta_solver.prototxt"},
+                                  {"Adam"     ,"multi_input_extended_net_adam_solver.prototxt"}};
+    map<string,double> rootMeanSquareErrors;
+    for (const pair<const string,string>& solver : solvers) {
+        ANN ann("../caffe_FunctionApproximation/prototxt/multi_input_extended_net_without_loss.prototxt",
+                "","../caffe_FunctionApproximation/prototxt/" + solver.second);
+        ann.setNormalization(Normalizer::MIN_MAX);
+        ann.setMaxIterations(20000);
+        REQUIRE(ann.train(inputValues,expectedResults));
+
+        vector<vector<double>> annOut = ann.forward(inputValues);
+        double sumSquaredError = 0;
+        for (unsigned int i = 0; i < inputValues.size(); i++) {
+            sumSquaredError += (annOut[i][0] - expectedResults[i]) * (annOut[i][0] - expectedResults[i]);
+        }
+        double rootMeanSquareError = sqrt(sumSquaredError / inputValues.size());
+        cout << solver.first << " : rms error after 20000 iterations " << rootMeanSquareError << endl;
+        rootMeanSquareErrors[solver.first] = rootMeanSquareError;
+        if (solver.first == "Adam" || solver.first == "RMSProp") {
+            REQUIRE(rootMeanSquareError < 0.2);
+        }
+    }
+    // at equal iterations the adaptive learning rates beat plain SGD
+    REQUIRE(rootMeanSquareErrors["Adam"]    < rootMeanSquareErrors["SGD"]);
+    REQUIRE(rootMeanSquareErrors["RMSProp"] < rootMeanSquareErrors["SGD"]);
+
+    SECTION("the type of the solver prototxt can be overridden") {
+        ANN ann("../caffe_FunctionApproximation/prototxt/multi_input_extended_net_without_loss.prototxt",
+                "","../caffe_FunctionApproximation/prototxt/multi_input_extended_net_rmsprop_solver.prototxt");
+        ann.setMaxIterations(100);
+        ann.setSolverType("AdaGrad");
+        REQUIRE(ann.train(inputValues,expectedResults));
+        ann.setSolverType("Unknown");
+        REQUIRE_FALSE(ann.train(inputValues,expectedResults));
+    }
+}
+
+
+TEST_CASE("Levenberg-Marquardt training of an ANN") {
+    ANN ann("../caffe_FunctionApproximation/prototxt/multi_input_extended_net_without_loss.prototxt",
+            "","../caffe_FunctionApproximation/prototxt/multi_input_extended_net_lm_solver.prototxt");
+
+    vector<vector<double>> inputValues;
+    vector<double> expectedResults;
+    for (double x = -2.0; x <= 2.0; x += 0.1) {
+        for (double y = -2.0; y <= 2.0; y += 0.1) {
+            inputValues.push_back({x,y});
+            expectedResults.push_back(x*y);
+        }
+    }
+
+    // a few hundred iterations instead of 450000 SGD iterations, saved as a standard caffemodel
+    ann.setNormalization(Normalizer::MIN_MAX);
+    REQUIRE(ann.train(inputValues,expectedResults));
+    REQUIRE(ann.getLevenbergMarquardtReport().numIterations <= 500);
+    REQUIRE(ann.getLevenbergMarquardtReport().loss < ann.getLevenbergMarquardtReport().initialLoss);
+
+    vector<vector<double>> annOut = ann.forward(inputValues);
+    for (unsigned int i = 0; i < inputValues.size(); i++) {
+        REQUIRE(nearlyEqual(expectedResults[i],annOut[i][0],0.1));
+    }
+}
+
+
+TEST_CASE("L-BFGS training of an ANN") {
+    ANN ann("../caffe_FunctionApproximation/prototxt/multi_input_extended_net_without_loss.prototxt",
+            "","../caffe_FunctionApproximation/prototxt/multi_input_extended_net_lbfgs_solver.prototxt");
+
+    vector<vector<double>> inputValues;
+    vector<double> expectedResults;
+    for (double x = -2.0; x <= 2.0; x += 0.1) {
+        for (double y = -2.0; y <= 2.0; y += 0.1) {
+            inputValues.push_back({x,y});
+            expectedResults.push_back(x*y);
+        }
+    }
+
+    // full batch, no learning rate : the same weights give the same loss on every run
+    ann.setNormalization(Normalizer::MIN_MAX);
+    REQUIRE(ann.getLBFGSHistorySize() == 10);
+    REQUIRE(ann.train(inputValues,expectedResults));
+    REQUIRE(ann.getLBFGSReport().numIterations <= 1000);
+    REQUIRE(ann.getLBFGSReport().loss < ann.getLBFGSReport().initialLoss);
+
+    vector<vector<double>> annOut = ann.forward(inputValues);
+    for (unsigned int i = 0; i < inputValues.size(); i++) {
+        REQUIRE(nearlyEqual(expectedResults[i],annOut[i][0],0.1));
+    }
+
+    SECTION("training continues from the trained weights") {
+        double loss = ann.getLBFGSReport().loss;
+        ann.setLBFGSHistorySize(20);
+        ann.setMaxIterations(50);
+        REQUIRE(ann.train(inputValues,expectedResults));
+        REQUIRE(nearlyEqual(ann.getLBFGSReport().initialLoss,loss,1e-9));
+        REQUIRE(ann.getLBFGSReport().loss <= loss);
+    }
+}
+
+
+TEST_CASE("Early stopping") {
+    vector<vector<double>> inputValues;
+    vector<double> expectedResults;
+    for (double x = -2.0; x <= 2.0; x += 0.1) {
+        for (double y = -2.0; y <= 2.0; y += 0.1) {
+            inputValues.push_back({x,y});
+            expectedResults.push_back(x*y);
+        }
+    }
+
+    ANN ann("../caffe_FunctionApproximation/prototxt/multi_input_extended_net_without_loss.prototxt",
+            "","../caffe_FunctionApproximation/prototxt/multi_input_extended_net_adam_solver.prototxt");
+    ann.setNormalization(Normalizer::MIN_MAX);
+    ann.setValidationFraction(0.2);
+    ann.setValidationInterval(500);
+
+    SECTION("target validation error") {
+        ann.setTargetValidationError(1e-3);
+        REQUIRE(ann.train(inputValues,expectedResults));
+        const EarlyStopping::Report& report = ann.getValidationReport();
+        REQUIRE(report.stoppedEarly);
+        REQUIRE(report.targetReached);
+        REQUIRE(report.bestError <= 1e-3);
+        // stopped at the first validation below the target, long before max_iter
+        REQUIRE(report.bestIteration < 20000);
+        REQUIRE(report.bestIteration % 500 == 0);
+
+        vector<vector<double>> annOut = ann.forward(inputValues);
+        for (unsigned int i = 0; i < inputValues.size(); i++) {
+            REQUIRE(nearlyEqual(expectedResults[i],annOut[i][0],0.2));
+        }
+    }
+
+    SECTION("plateau of the validation error") {
+        ann.setPatience(3);
+        ann.setMaxIterations(1000000);
+        REQUIRE(ann.train(inputValues,expectedResults));
+        const EarlyStopping::Report& report = ann.getValidationReport();
+        REQUIRE(report.stoppedEarly);
+        REQUIRE_FALSE(report.targetReached);
+        REQUIRE(report.bestError <= report.lastError);
+    }
+
+    SECTION("validation samples of an own data source") {
+        InMemoryDataSource dataSource(inputValues,expectedResults);
+        InMemoryDataSource validationDataSource = dataSource.holdOut(0.1,7);
+        ann.setMaxIterations(2000);
+        REQUIRE(ann.train(dataSource,&validationDataSource));
+        REQUIRE(ann.getValidationReport().numEvaluations == 5);
+
+        vector<vector<double>> tooManyInputs(inputValues.size(),{0.0,0.0,0.0});
+        InMemoryDataSource wrongDataSource(tooManyInputs,expectedResults);
+        REQUIRE_FALSE(ann.train(dataSource,&wrongDataSource));
+
+        // the report of the last training is cleared by the next one
+        REQUIRE(ann.train(dataSource));
+        REQUIRE(ann.getValidationReport().numEvaluations == 0);
+    }
+
+    SECTION("second-order solvers reject validation samples") {
+        InMemoryDataSource dataSource(inputValues,expectedResults);
+        InMemoryDataSource validationDataSource = dataSource.holdOut(0.1,7);
+        ann.setMaxIterations(10);
+        for (string solverType : {"LevenbergMarquardt", "LBFGS"}) {
+            ann.setSolverType(solverType);
+            REQUIRE_FALSE(ann.train(dataSource,&validationDataSource));
+        }
+    }
+}
+
+
+TEST_CASE("Time budget and cancellation") {
+    vector<vector<double>> inputValues;
+    vector<double> expectedResults;
+    for (double x = -2.0; x <= 2.0; x += 0.1) {
+        for (double y = -2.0; y <= 2.0; y += 0.1) {
+            inputValues.push_back({x,y});
+            expectedResults.push_back(x*y);
+        }
+    }
+
+    ANN ann("../caffe_FunctionApproximation/prototxt/multi_input_extended_net_without_loss.prototxt",
+            "","../caffe_FunctionApproximation/prototxt/multi_input_extended_net_adam_solver.prototxt");
+    ann.setNormalization(Normalizer::MIN_MAX);
+    // far more iterations than fit into the budget
+    ann.setMaxIterations(100000000);
+
+    SECTION("time budget") {
+        ann.setTimeBudget(2.0);
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        REQUIRE(ann.train(inputValues,expectedResults));
+        REQUIRE(chrono::duration<double>(chrono::steady_clock::now() - start).count() < 10.0);
+        REQUIRE(ann.getStopReason() == ANN::TIME_BUDGET);
+
+        // the weights trained within the budget are saved
+        REQUIRE(ann.getTrainedWeightsCaffemodelPath() != "");
+        vector<vector<double>> annOut = ann.forward(inputValues);
+        REQUIRE(annOut.size() == inputValues.size());
+    }
+
+    SECTION("cancellation from another thread") {
+        CancellationToken token;
+        ann.setCancellationToken(&token);
+        thread canceller([&token]() {
+            this_thread::sleep_for(chrono::milliseconds(500));
+            token.cancel();
+        });
+        REQUIRE(ann.train(inputValues,expectedResults));
+        canceller.join();
+        REQUIRE(ann.getStopReason() == ANN::CANCELLED);
+
+        // a cancelled token stops the next training before its first iteration
+        REQUIRE(ann.train(inputValues,expectedResults));
+        REQUIRE(ann.getStopReason() == ANN::CANCELLED);
+
+        token.reset();
+        ann.setMaxIterations(100);
+        REQUIRE(ann.train(inputValues,expectedResults));
+        REQUIRE(ann.getStopReason() == ANN::COMPLETED);
+    }
+
+    SECTION("asynchronous training") {
+        ann.setNumThreads(2);
+        ann.setAsynchronous(true);
+        ann.setTimeBudget(1.0);
+        REQUIRE(ann.train(inputValues,expectedResults));
+        REQUIRE(ann.getStopReason() == ANN::TIME_BUDGET);
+        REQUIRE(ann.getAsynchronousReport().numUpdates > 0);
+    }
+}
+
+
+TEST_CASE("Resuming from a solver state") {
+    vector<vector<double>> inputValues;
+    vector<double> expectedResults;
+    for (double x = -2.0; x <= 2.0; x += 0.1) {
+        for (double y = -2.0; y <= 2.0; y += 0.1) {
+            inputValues.push_back({x,y});
+            expectedResults.push_back(x*y);
+        }
+    }
+    string netPath    = "../caffe_FunctionApproximation/prototxt/multi_input_extended_net_without_loss.prototxt";
+    string solverPath = "../caffe_FunctionApproximation/prototxt/multi_input_extended_net_adam_solver.prototxt";
+
+    // common start weights
+    ANN ann(netPath,"",solverPath);
+    ann.setShuffle(false);
+    ann.setMaxIterations(100);
+    REQUIRE(ann.train(inputValues,expectedResults));
+    string startWeights = ann.getTrainedWeightsCaffemodelPath();
+
+    // 300 iterations at once
+    ANN uninterruptedAnn(netPath,startWeights,solverPath);
+    uninterruptedAnn.setShuffle(false);
+    uninterruptedAnn.setMaxIterations(300);
+    REQUIRE(uninterruptedAnn.train(inputValues,expectedResults));
+    vector<vector<double>> uninterruptedOut = uninterruptedAnn.forward(inputValues);
+
+    // 200 iterations, interrupted, resumed up to iteration 300 with the history of Adam
+    ANN resumedAnn(netPath,startWeights,solverPath);
+    resumedAnn.setShuffle(false);
+    resumedAnn.setMaxIterations(200);
+    REQUIRE(resumedAnn.train(inputValues,expectedResults));
+    REQUIRE(resumedAnn.getTrainedWeightsCaffemodelPath() == "adam_iter_200.caffemodel");
+
+    resumedAnn.setSolverStatePath("adam_iter_200.solverstate");
+    resumedAnn.setMaxIterations(300);
+    REQUIRE(resumedAnn.train(inputValues,expectedResults));
+    REQUIRE(resumedAnn.getTrainedWeightsCaffemodelPath() == "adam_iter_300.caffemodel");
+    REQUIRE(resumedAnn.getSolverStatePath() == "adam_iter_300.solverstate");
+
+    vector<vector<double>> resumedOut = resumedAnn.forward(inputValues);
+    for (unsigned int i = 0; i < inputValues.size(); i++) {
+        REQUIRE(nearlyEqual(uninterruptedOut[i][0],resumedOut[i][0],1e-9));
+    }
+
+    SECTION("a missing solver state is rejected") {
+        resumedAnn.setSolverStatePath("missing_iter_1.solverstate");
+        REQUIRE_FALSE(resumedAnn.train(inputValues,expectedResults));
+    }
+
+    SECTION("a HDF5 solver state is rejected") {
+        ofstream("adam_iter_300.solverstate.h5") << "HDF5";
+        resumedAnn.setSolverStatePath("adam_iter_300.solverstate.h5");
+        REQUIRE_FALSE(resumedAnn.train(inputValues,expectedResults));
+        REQUIRE(resumedAnn.getTrainedWeightsCaffemodelPath() == "adam_iter_300.caffemodel");
+    }
+
+    SECTION("a solver state of another solver type is rejected") {
+        resumedAnn.setSolverType("SGD");
+        resumedAnn.setMaxIterations(400);
+        REQUIRE_FALSE(resumedAnn.train(inputValues,expectedResults));
+        REQUIRE(resumedAnn.getTrainedWeightsCaffemodelPath() == "adam_iter_300.caffemodel");
+        REQUIRE(resumedAnn.getSolverStatePath() == "adam_iter_300.solverstate");
+    }
+}
+
+
+TEST_CASE("Forward after retraining to the same weights path") {
+    vector<vector<double>> inputValues;
+    vector<double> expectedResults;
+    for (double x = -2.0; x <= 2.0; x += 0.1) {
+        for (double y = -2.0; y <= 2.0; y += 0.1) {
+            inputValues.push_back({x,y});
+            expectedResults.push_back(x*y);
+        }
+    }
+    string netPath    = "../caffe_FunctionApproximation/prototxt/multi_input_extended_net_without_loss.prototxt";
+    string solverPath = "../caffe_FunctionApproximation/prototxt/multi_input_extended_net_adam_solver.prototxt";
+
+    ANN ann(netPath,"",solverPath);
+    ann.setMaxIterations(200);
+    REQUIRE(ann.train(inputValues,expectedResults));
+    string weightsPath = ann.getTrainedWeightsCaffemodelPath();
+    vector<vector<double>> firstOut = ann.forward(inputValues);
+
+    // the second training continues for 200 iterations and overwrites adam_iter_200.caffemodel
+    REQUIRE(ann.train(inputValues,expectedResults));
+    REQUIRE(ann.getTrainedWeightsCaffemodelPath() == weightsPath);
+    vector<vector<double>> secondOut = ann.forward(inputValues);
+
+    ANN reloadedAnn(netPath,weightsPath,solverPath);
+    vector<vector<double>> reloadedOut = reloadedAnn.forward(inputValues);
+    int numChanged = 0;
+    for (unsigned int i = 0; i < inputValues.size(); i++) {
+        numChanged += firstOut[i][0] != secondOut[i][0];
+        REQUIRE(secondOut[i][0] == reloadedOut[i][0]);
+    }
+    REQUIRE(numChanged > 0);
+}
+
+
+TEST_CASE("Low-rank compression") {
+    vector<vector<double>> inputValues;
+    vector<vector<double>> expectedOutputValues;
+    vector<double> expectedResults;
+    for (double x = -2.0; x <= 2.0; x += 0.1) {
+        for (double y = -2.0; y <= 2.0; y += 0.1) {
+            inputValues.push_back({x,y});
+            expectedOutputValues.push_back({x*y / 4.0});
+            expectedResults.push_back(x*y / 4.0);
+        }
+    }
+    ANN ann("../caffe_FunctionApproximation/prototxt/multi_input_extended_net_without_loss.prototxt",
+            "","../caffe_FunctionApproximation/prototxt/multi_input_extended_net_adam_solver.prototxt");
+    ann.setMaxIterations(20000);
+    REQUIRE(ann.train(inputValues,expectedResults));
+
+    auto rootMeanSquareError = [&](ANN& ann_) {
+        vector<vector<double>> annOut = ann_.forward(inputValues);
+        double sumSquaredError = 0;
+        for (unsigned int i = 0; i < inputValues.size(); i++) {
+            sumSquaredError += (annOut[i][0] - expectedResults[i]) * (annOut[i][0] - expectedResults[i]);
+        }
+        return sqrt(sumSquaredError / inputValues.size());
+    };
+    double errorBefore = rootMeanSquareError(ann);
+
+    LowRankCompressor compressor(ann);
+    compressor.setErrorBudget(errorBefore + 0.05);
+
+    SECTION("factorization") {
+        compressor.setFineTuningIterations(0);
+        LowRankCompressor::Report report;
+        REQUIRE(compressor.compress(inputValues,expectedOutputValues,"lowrank",report));
+
+        REQUIRE(nearlyEqual(report.errorBefore,errorBefore,1e-6));
+        REQUIRE(report.errorAfterFactorization <= compressor.getErrorBudget());
+        REQUIRE(report.errorAfterFineTuning < 0);
+        REQUIRE(report.flopsAfter < report.flopsBefore);
+        // only the hidden 10 x 10 layers are factorized
+        REQUIRE(report.layers.size() == 4);
+        REQUIRE(report.layers.front().rank == 0);
+        REQUIRE(report.layers.back().rank  == 0);
+
+        // the written files load into ANN and reproduce the error of the factorized MLP
+        ANN compressedAnn("lowrank_without_loss.prototxt","lowrank.caffemodel","");
+        REQUIRE(nearlyEqual(rootMeanSquareError(compressedAnn),report.errorAfterFactorization,1e-6));
+    }
+
+    SECTION("fine-tuning") {
+        compressor.setFineTuningIterations(2000);
+        LowRankCompressor::Report report;
+        REQUIRE(compressor.compress(inputValues,expectedOutputValues,"lowrank_tuned",report));
+
+        REQUIRE(report.errorAfterFactorization <= compressor.getErrorBudget());
+        REQUIRE(report.errorAfterFineTuning >= 0);
+        REQUIRE(report.flopsAfter < report.flopsBefore);
+
+        // the better of both weights is kept
+        ANN compressedAnn("lowrank_tuned_without_loss.prototxt","lowrank_tuned.caffemodel","");
+        double expectedError = min(report.errorAfterFactorization,report.errorAfterFineTuning);
+        REQUIRE(nearlyEqual(rootMeanSquareError(compressedAnn),expectedError,1e-6));
+
+        // the snapshot of the fine-tuning is removed
+        REQUIRE_FALSE(ifstream("lowrank_tuned_iter_2000.caffemodel").good());
+        REQUIRE_FALSE(ifstream("lowrank_tuned_iter_2000.caffemodel.normalizer").good());
+        REQUIRE_FALSE(ifstream("lowrank_tuned_iter_2000.solverstate").good());
+    }
+}
+
+TEST_CASE("MLP and low-rank compression of a normalized ANN") {
+    vector<vector<double>> inputValues;
+    vector<vector<double>> expectedOutputValues;
+    vector<double> expectedResults;
+    for (double x = -2.0; x <= 2.0; x += 0.1) {
+        for (double y = -2.0; y <= 2.0; y += 0.1) {
+            inputValues.push_back({x,y});
+            expectedOutputValues.push_back({x*y});
+            expectedResults.push_back(x*y);
+        }
+    }
+    // x*y reaches 4, which the tanh output only reaches in normalized units
+    ANN ann("../caffe_FunctionApproximation/prototxt/multi_input_extended_net_without_loss.prototxt",
+            "","../caffe_FunctionApproximation/prototxt/multi_input_extended_net_adam_solver.prototxt");
+    ann.setNormalization(Normalizer::MIN_MAX);
+    ann.setMaxIterations(20000);
+    REQUIRE(ann.train(inputValues,expectedResults));
+    vector<vector<double>> annOut = ann.forward(inputValues);
+
+    SECTION("the MLP takes and returns the original values") {
+        MLP mlp;
+        REQUIRE(mlp.loadFromNet(ann.loadNet(),ann.getInputNormalizer(),ann.getOutputNormalizer()));
+        for (unsigned int i = 0; i < inputValues.size(); i++) {
+            REQUIRE(nearlyEqual(mlp.forward(inputValues[i])[0],annOut[i][0],1e-9));
+        }
+
+        AccuracyEvaluator evaluator(mlp,[](const vector<double>& x_) { return vector<double>({x_[0] * x_[1]}); });
+        AccuracyEvaluator::Report report = evaluator.evaluate(Domain({-2.0,-2.0},{2.0,2.0}),10000,AccuracyEvaluator::SOBOL);
+        REQUIRE(report.rootMeanSquareError < 0.2);
+    }
+
+    SECTION("the compressed net keeps the normalizers") {
+        double sumSquaredError = 0;
+        for (unsigned int i = 0; i < inputValues.size(); i++) {
+            sumSquaredError += (annOut[i][0] - expectedResults[i]) * (annOut[i][0] - expectedResults[i]);
+        }
+        double errorBefore = sqrt(sumSquaredError / inputValues.size());
+
+        LowRankCompressor compressor(ann);
+        compressor.setErrorBudget(errorBefore + 0.1);
+        compressor.setFineTuningIterations(0);
+        LowRankCompressor::Report report;
+        REQUIRE(compressor.compress(inputValues,expectedOutputValues,"lowrank_normalized",report));
+        REQUIRE(nearlyEqual(report.errorBefore,errorBefore,1e-6));
+        REQUIRE(report.errorAfterFactorization <= compressor.getErrorBudget());
+        REQUIRE(ifstream("lowrank_normalized.caffemodel.normalizer").good());
+
+        ANN compressedAnn("lowrank_normalized_without_loss.prototxt","lowrank_normalized.caffemodel","");
+        vector<vector<double>> compressedOut = compressedAnn.forward(inputValues);
+        REQUIRE(compressedAnn.getOutputNormalizer().isFitted());
+        sumSquaredError = 0;
+        for (unsigned int i = 0; i < inputValues.size(); i++) {
+            sumSquaredError += (compressedOut[i][0] - expectedResults[i]) * (compressedOut[i][0] - expectedResults[i]);
+        }
+        REQUIRE(nearlyEqual(sqrt(sumSquaredError / inputValues.size()),report.errorAfterFactorization,1e-6));
+    }
+}
+
+TEST_CASE("Training from a binary data set on disk") {
+    // headerless columnar file : all x, all y, all x*y
+    vector<vector<double>> inputValues;
+    vector<double> expectedResults;
+    for (double x = -2.0; x <= 2.0; x += 0.1) {
+        for (double y = -2.0; y <= 2.0; y += 0.1) {
+            inputValues.push_back({x,y});
+            expectedResults.push_back(x*y);
+        }
+    }
+    {
+        ofstream oFile("x_mult_y.bin",ios::binary);
+        for (int column = 0; column < 3; column++) {
+            for (unsigned int i = 0; i < inputValues.size(); i++) {
+                double value = (column < 2) ? inputValues[i][column] : expectedResults[i];
+                oFile.write(reinterpret_cast<const char*>(&value),sizeof(double));
+            }
+        }
+    }
+
+    ANN ann("../caffe_FunctionApproximation/prototxt/multi_input_extended_net_without_loss.prototxt",
+            "","../caffe_FunctionApproximation/prototxt/multi_input_extended_net_adam_solver.prototxt");
+    ann.setNormalization(Normalizer::MIN_MAX);
+    auto rootMeanSquareError = [&]() {
+        vector<vector<double>> annOut = ann.forward(inputValues);
+        double sumSquaredError = 0;
+        for (unsigned int i = 0; i < inputValues.size(); i++) {
+            sumSquaredError += (annOut[i][0] - expectedResults[i]) * (annOut[i][0] - expectedResults[i]);
+        }
+        return sqrt(sumSquaredError / inputValues.size());
+    };
+
+    SECTION("full batch mode is rejected") {
+        REQUIRE_FALSE(ann.train("x_mult_y.bin",2,1));
+    }
+
+    SECTION("minibatches") {
+        ann.setBatchSize(64);
+        REQUIRE(ann.train("x_mult_y.bin",2,1));
+        REQUIRE(rootMeanSquareError() < 0.2);
+    }
+
+    SECTION("minibatches split into unequal shards") {
+        // 64 samples per iteration --> shards of 22, 21 and 21 samples
+        ann.setBatchSize(64);
+        ann.setNumThreads(3);
+        REQUIRE(ann.train("x_mult_y.bin",2,1));
+        REQUIRE(rootMeanSquareError() < 0.2);
+    }
+}
+
+TEST_CASE("Training with generated samples") {
+    ANN ann("../caffe_FunctionApproximation/prototxt/multi_input_extended_net_without_loss.prototxt",
+            "","../caffe_FunctionApproximation/prototxt/multi_input_extended_net_adam_solver.prototxt");
+    ann.setNormalization(Normalizer::MIN_MAX);
+    Domain domain({-2.0,-2.0},{2.0,2.0});
+    auto targetFunction = [](const vector<double>& x_) { return vector<double>({x_[0] * x_[1]}); };
+
+    SECTION("full batch mode is rejected") {
+        // an unbounded source has no full batch
+        REQUIRE_FALSE(ann.train(domain,targetFunction));
+    }
+
+    SECTION("minibatches") {
+        // every iteration draws 64 fresh samples
+        ann.setBatchSize(64);
+        REQUIRE(ann.train(domain,targetFunction));
+
+        vector<vector<double>> inputValues;
+        for (double x = -2.0; x <= 2.0; x += 0.1) {
+            for (double y = -2.0; y <= 2.0; y += 0.1) {
+                inputValues.push_back({x,y});
+            }
+        }
+        vector<vector<double>> annOut = ann.forward(inputValues);
+        double sumSquaredError = 0;
+        for (unsigned int i = 0; i < inputValues.size(); i++) {
+            double error = annOut[i][0] - inputValues[i][0] * inputValues[i][1];
+            sumSquaredError += error * error;
+        }
+        REQUIRE(sqrt(sumSquaredError / inputValues.size()) < 0.2);
+    }
+}
+
+TEST_CASE("Training and forward with a columnar data set") {
+    // 101 x 101 rows : two full chunks of 4096 rows and a partial last chunk of 2009 rows
+    vector<vector<double>> columns(3);
+    for (int i = 0; i <= 100; i++) {
+        for (int j = 0; j <= 100; j++) {
+            double x = -2.0 + 0.04 * i;
+            double y = -2.0 + 0.04 * j;
+            columns[0].push_back(x);
+            columns[1].push_back(y);
+            columns[2].push_back(x * y);
+        }
+    }
+    REQUIRE(ColumnarDataSet::write("x_mult_y.fad",{"x","y","x*y"},2,columns));
+
+    ANN ann("../caffe_FunctionApproximation/prototxt/multi_input_extended_net_without_loss.prototxt",
+            "","../caffe_FunctionApproximation/prototxt/multi_input_extended_net_adam_solver.prototxt");
+    ann.setNormalization(Normalizer::MIN_MAX);
+    REQUIRE_FALSE(ann.train("x_mult_y.fad"));
+    ann.setBatchSize(64);
+    REQUIRE(ann.train("x_mult_y.fad"));
+
+    ColumnarDataSet dataSet;
+    REQUIRE(dataSet.open("x_mult_y.fad"));
+    vector<double> outputValues;
+    REQUIRE(ann.forward(dataSet,outputValues));
+    REQUIRE(outputValues.size() == columns[0].size());
+
+    Matrix inputValues(columns[0].size(),2);
+    for (unsigned int i = 0; i < columns[0].size(); i++) {
+        inputValues.data()[i * 2]     = columns[0][i];
+        inputValues.data()[i * 2 + 1] = columns[1][i];
+    }
+    Matrix matrixOutputValues = ann.forward(inputValues);
+    REQUIRE(matrixOutputValues.getNumRows() == columns[0].size());
+
+    double sumSquaredError = 0;
+    for (unsigned int i = 0; i < columns[0].size(); i++) {
+        REQUIRE(nearlyEqual(outputValues[i],matrixOutputValues.data()[i],1e-12));
+        sumSquaredError += (outputValues[i] - columns[2][i]) * (outputValues[i] - columns[2][i]);
+    }
+    REQUIRE(sqrt(sumSquaredError / columns[0].size()) < 0.2);
+}
+
+TEST_CASE("Minibatch training") {
+    vector<vector<double>> inputValues;
+    vector<double> expectedResults;
+    for (double x = -2.0; x <= 2.0; x += 0.1) {
+        for (double y = -2.0; y <= 2.0; y += 0.1) {
+            inputValues.push_back({x,y});
+            expectedResults.push_back(x*y);
+        }
+    }
+    string netPath    = "../caffe_FunctionApproximation/prototxt/multi_input_extended_net_without_loss.prototxt";
+    string solverPath = "../caffe_FunctionApproximation/prototxt/multi_input_extended_net_adam_solver.prototxt";
+
+    // 64 shuffled samples per iteration instead of all 1681 samples
+    ANN ann(netPath,"",solverPath);
+    ann.setNormalization(Normalizer::MIN_MAX);
+    ann.setBatchSize(64);
+    REQUIRE(ann.getShuffle());
+    REQUIRE(ann.train(inputValues,expectedResults));
+
+    vector<vector<double>> annOut = ann.forward(inputValues);
+    double sumSquaredError = 0;
+    for (unsigned int i = 0; i < inputValues.size(); i++) {
+        sumSquaredError += (annOut[i][0] - expectedResults[i]) * (annOut[i][0] - expectedResults[i]);
+    }
+    REQUIRE(sqrt(sumSquaredError / inputValues.size()) < 0.2);
+}
@@ -12,6 +12,14 @@
  * constructor of class ANN
  *  1. sets processing mode (CPU / GPU) depending on previous define CPU_ONLY
  *  2. sets the given paths in private attributes
+ *  3. sets full batch training (see setBatchSize) with the solver type of the solver prototxt (see setSolverType)
+ *  4. disables the normalization of values (see setNormalization)
+ *  5. trains on one thread (see setNumThreads), synchronously if more threads are set (see setAsynchronous)
+ *  6. trains in one process (see setRing)
+ *  7. keeps 10 curvature pairs for the solver type "LBFGS" (see setLBFGSHistorySize)
+ *  8. trains without validation (see setValidationFraction), once set it is evaluated every
+ *     1000 iterations and training stops after 10 validations without improvement
+ *  9. trains without time budget and cancellation token (see setTimeBudget, setCancellationToken)
  */
 ANN::ANN(const string& netStructurePrototxtPath_, const string& trainedWeightsCaffemodelPath_, const string &solverParametersPrototxtPath_) {
     // set processing source
@@ -25,7 +33,26 @@ ANN::ANN(const string& netStructurePrototxtPath_, const string& trainedWeightsCa
     setNetStructurePrototxtPath(netStructurePrototxtPath_);
     setTrainedWeightsCaffemodelPath(trainedWeightsCaffemodelPath_);
     setSolverParametersPrototxtPath(solverParametersPrototxtPath_);
-
+    setSolverStatePath("");
+
+    // train on the full data set per iteration by default
+    setBatchSize(0);
+    setShuffle(true);
+    setMaxIterations(0);
+    setSolverType("");
+    setNormalization(Normalizer::NONE);
+    setNumThreads(1);
+    setAsynchronous(false);
+    setRing(nullptr);
+    setLBFGSHistorySize(10);
+    setValidationFraction(0);
+    setValidationInterval(1000);
+    setPatience(10);
+    setTargetValidationError(0);
+    setTimeBudget(0);
+    setCancellationToken(nullptr);
+    stopRequested = false;
+    stopReason    = COMPLETED;
 }
 
 /* --- pushing values forward (from input to output) --- */
@@ -39,14 +66,9 @@ ANN::ANN(const string& netStructurePrototxtPath_, const string& trainedWeightsCa
  */
 double ANN::forward(double inputValue_) {
 
-    // load network-structure from prototxt-file
-    net = new Net<double>(getNetStructurePrototxtPath(),caffe::TEST);
-
-    // load weights
-    string trainedWeightsCaffemodelPath_l = getTrainedWeightsCaffemodelPath();
-    if (trainedWeightsCaffemodelPath_l != "") {
-        net->CopyTrainedLayersFrom(trainedWeightsCaffemodelPath_l);
-    }
+    // load network-structure and weights
+    // --> the net is only rebuilt if one of the paths has changed since the last call
+    loadNet();
 
     // create BLOB for input layer - data
     Blob<double>* inputLayer = net->input_blobs()[0];
@@ -67,6 +89,7 @@ double ANN::forward(double inputValue_) {
     net->Reshape();
 
     // insert inputValue into inputLayer
+    normalizeInputs(&inputValue_,1,1);
     setDataOfBLOB(inputLayer,0,0,0,0,inputValue_);
 
     // propagate inputValue through layers
@@ -76,7 +99,9 @@ double ANN::forward(double inputValue_) {
     Blob<double>* outputLayer = net->output_blobs()[0];
 
     // return the only value in output Layer
-    return getDataOfBLOB(outputLayer,0,0,0,0);
+    double result = getDataOfBLOB(outputLayer,0,0,0,0);
+    denormalizeOutputs(&result,1,1);
+    return result;
 }
 
 /**
@@ -88,15 +113,9 @@ double ANN::forward(double inputValue_) {
  */
 vector<double> ANN::forward(vector<double> inputValues_) {
 
-    // load network-structure from prototxt-file
-    net = new Net<double>(getNetStructurePrototxtPath(),caffe::TEST);
-
-    // load weights
-    string trainedWeightsCaffemodelPath_l = getTrainedWeightsCaffemodelPath();
-    if (trainedWeightsCaffemodelPath_l != "") {
-        trainedWeightsCaffemodelPath_l = "/home/anon/Desktop/PrivateProjects/Programming/C++/Caffe_Deep_Learning_Framework/Caffe_FunctionApproximation/build-caffe_FunctionApproximation-Unnamed-Debug/train_iter_450000.caffemodel";
-        net->CopyTrainedLayersFrom(trainedWeightsCaffemodelPath_l);
-    }
+    // load network-structure and weights
+    // --> the net is only rebuilt if one of the paths has changed since the last call
+    loadNet();
 
     // create BLOB for input layer
     Blob<double>* inputLayer = net->input_blobs()[0];
@@ -120,89 +139,137 @@ vector<double> ANN::forward(vector<double> inputValues_) {
     for (unsigned int i = 0; i < inputValues_.size(); i++) {
         setDataOfBLOB(inputLayer,i,0,0,0,inputValues_[i]);
     }
+    normalizeInputs(inputLayer->mutable_cpu_data(),num,1);
 
     // propagate inputValue through layers
     net->Forward();
 
     // create BLOB for outputLayer
     Blob<double>* outputLayer = net->output_blobs()[0];
-    cout << "num : " << outputLayer->num() << endl;
-    cout << "channels : " << outputLayer->channels() << endl;
-    cout << "height : " << outputLayer->height() << endl;
-    cout << "width : " << outputLayer->width() << endl;
-
 
     // copy values in output Layer to 1-dimensional-vector of values
     vector<double> result;
     for (int i = 0; i < outputLayer->num(); i++) {
         result.push_back(getDataOfBLOB(outputLayer,i,0,0,0));
     }
+    denormalizeOutputs(result.data(),result.size(),1);
 
     // return vector of values
     return result;
 }
 
+/**
+ * @brief ANN::forward propagates a vector of samples (one vector of input values per sample) through the net
+ * @param inputValues_ input values per sample, every sample has to have the same number of values
+ * @return returns the output values per sample (one value per output neuron)
+ *
+ * The samples are copied into one Matrix and propagated by forward(const MatrixView&).
+ */
 vector<vector<double> > ANN::forward(vector<vector<double> > inputValues_) {
+    return forward(Matrix(inputValues_)).toRows();
+}
 
-    // load network-structure from prototxt-file
-    net = new Net<double>(getNetStructurePrototxtPath(),caffe::TEST);
-
-    // load weights
-    string trainedWeightsCaffemodelPath_l = getTrainedWeightsCaffemodelPath();
-    if (trainedWeightsCaffemodelPath_l != "") { // TODO
-        trainedWeightsCaffemodelPath_l = "/home/anon/Desktop/PrivateProjects/Programming/C++/Caffe_Deep_Learning_Framework/Caffe_FunctionApproximation/build-caffe_FunctionApproximation-Unnamed-Debug/train_iter_450000.caffemodel";
-        net->CopyTrainedLayersFrom(trainedWeightsCaffemodelPath_l);
+/**
+ * @brief ANN::forward propagates all rows of inputValues_ (one row of input values per sample) through the net
+ * @param inputValues_ input values, one row per sample
+ * @return returns the output values, one row of output neurons per sample
+ *
+ * The rows are copied into the input blob by one copy of the whole block, the output blob
+ * is copied into the result in the same way. The input blob is only reshaped if the number
+ * of rows or columns has changed since the last call.
+ */
+Matrix ANN::forward(const MatrixView& inputValues_) {
+    if (inputValues_.isEmpty()) {
+        return Matrix();
     }
 
+    // load network-structure and weights
+    // --> the net is only rebuilt if one of the paths has changed since the last call
+    loadNet();
+
     // create BLOB for input layer
     Blob<double>* inputLayer = net->input_blobs()[0];
 
-    // set dimesions of input layer
-    // --> for normal caffe works with images, therefore the data
-    // --> typically is 4 dimensional
-    // --> numberOfImages * numberOfColorChannels * numberOfPixelsInDirectionOfHeight * numberOfPixelsInDirectionOfWidth
-    // --> in this case we use 1-dimensional data, therefore the data-dimension is 1*1*1*1
-    int num      = inputValues_.size();
-    int channels = inputValues_[0].size();
-    int height   = 1;
-    int width    = 1;
-    vector<int> dimensionsOfInputData = {num,channels,height,width};
-    inputLayer->Reshape(dimensionsOfInputData);
-
-    // forward dimension change to all layers.
-    net->Reshape();
-
-    // insert inputValue into inputLayer
-
-    // iterate all neurons for every inputData-dataset
-    for (unsigned int inputDataSetIndex = 0; inputDataSetIndex < inputValues_.size(); inputDataSetIndex++) {
-        for (unsigned int inputNeuronIndex = 0; inputNeuronIndex < inputValues_[inputDataSetIndex].size(); inputNeuronIndex++) {
-            setDataOfBLOB(inputLayer,inputDataSetIndex,inputNeuronIndex,0,0,inputValues_[inputDataSetIndex][inputNeuronIndex]);
-        }
+    // set dimensions of input layer : numberOfSamples*numberOfInputs*1*1
+    int num      = inputValues_.getNumRows();
+    int channels = inputValues_.getNumColumns();
+    if (inputLayer->num() != num || inputLayer->channels() != channels || inputLayer->count() != num * channels) {
+        vector<int> dimensionsOfInputData = {num,channels,1,1};
+        inputLayer->Reshape(dimensionsOfInputData);
+        net->Reshape();
     }
 
+    // insert all rows into inputLayer at once
+    double* inputData = inputLayer->mutable_cpu_data();
+    copy(inputValues_.data(),inputValues_.data() + inputValues_.getSize(),inputData);
+    normalizeInputs(inputData,num,channels);
 
     // propagate inputValue through layers
     net->Forward();
 
-    // create BLOB for outputLayer
+    // copy output layer into the result
     Blob<double>* outputLayer = net->output_blobs()[0];
-    cout << "num : " << outputLayer->num() << endl;
-    cout << "channels : " << outputLayer->channels() << endl;
-    cout << "height : " << outputLayer->height() << endl;
-    cout << "width : " << outputLayer->width() << endl;
+    Matrix result(outputLayer->num(),outputLayer->count() / outputLayer->num());
+    copy(outputLayer->cpu_data(),outputLayer->cpu_data() + outputLayer->count(),result.data());
+    denormalizeOutputs(result.data(),result.getNumRows(),result.getNumColumns());
+    return result;
+}
+
+/**
+ * @brief ANN::forward propagates the input columns of a data set through the net
+ * @param dataSet_      opened data set, its getNumInputs() input columns are propagated
+ * @param outputValues_ the output values, one row of output neurons per row of the data set
+ * @return returns true if all rows have been propagated, otherwise false
+ *
+ * The rows are propagated in chunks of 4096 rows, which are copied directly from the
+ * memory-mapped columns into the input blob. Therefore neither the data set is parsed nor
+ * all rows are held in the input blob at once.
+ */
+bool ANN::forward(const ColumnarDataSet& dataSet_, vector<double>& outputValues_) {
+    outputValues_.clear();
+    if (!dataSet_.isOpen()) {
+        cout << "Error : the data set is not open" << endl;
+        return false;
+    }
 
+    // load network-structure and weights
+    // --> the net is only rebuilt if one of the paths has changed since the last call
+    loadNet();
 
-    // copy values in output Layer to 1-dimensional-vector of values
-    vector<vector<double>> result (outputLayer->num(), std::vector<double>(outputLayer->channels()));
-    for (int outputDataSetIndex = 0; outputDataSetIndex < outputLayer->num(); outputDataSetIndex++) {
-        for(int outputNeuronIndex = 0; outputNeuronIndex < outputLayer->channels(); outputNeuronIndex++) {
-            result[outputDataSetIndex][outputNeuronIndex] =getDataOfBLOB(outputLayer,outputDataSetIndex,outputNeuronIndex,0,0);
+    // create BLOB for input layer
+    Blob<double>* inputLayer = net->input_blobs()[0];
+
+    const int chunkSize = 4096;
+    int    numInputs = dataSet_.getNumInputs();
+    size_t numRows   = dataSet_.getNumRows();
+    for (size_t firstRow = 0; firstRow < numRows; firstRow += chunkSize) {
+        int num = (int)min<size_t>(chunkSize,numRows - firstRow);
+
+        // set dimensions of input layer only if they change (last chunk)
+        if (inputLayer->num() != num || inputLayer->channels() != numInputs) {
+            vector<int> dimensionsOfInputData = {num,numInputs,1,1};
+            inputLayer->Reshape(dimensionsOfInputData);
+            net->Reshape();
         }
-    }
 
-    // return vector of values
-    return result;
+        // gather the rows of the chunk from the columns
+        double* inputData = inputLayer->mutable_cpu_data();
+        for (int j = 0; j < numInputs; j++) {
+            const double* column = dataSet_.getColumnData(j) + firstRow;
+            for (int i = 0; i < num; i++) {
+                inputData[i * numInputs + j] = column[i];
+            }
+        }
+        normalizeInputs(inputData,num,numInputs);
+
+        // propagate inputValue through layers
+        net->Forward();
+
+        Blob<double>* outputLayer = net->output_blobs()[0];
+        outputValues_.insert(outputValues_.end(),outputLayer->cpu_data(),outputLayer->cpu_data() + outputLayer->count());
+        denormalizeOutputs(&outputValues_[outputValues_.size() - outputLayer->count()],num,outputLayer->count() / num);
+    }
+    return true;
 }
 
 /* --- train / optimize weights --- */
@@ -213,308 +280,1073 @@ vector<vector<double> > ANN::forward(vector<vector<double> > inputValues_) {
  * @param expectedOutputValues_ vector of output values
  * @return returns true if training has succesfully ended, otherwise false
  *
- * The train function executes a learning to the net by doing the following steps :
- *   1. create a solver object which encapsulate and controls the net solverParametersPrototxtPath-file
- *   2. load the input data and the expected output data to the net
- *   3. execute solver_->Solve, which
- *        3.1 automatically loops through the input data
- *        3.2 propagates the input data through the net,
- *        3.3 calculates the current loss of the output
- *        3.4 calculates deltas for every weight, depending on the loss
- *        3.5 calculates new weights
- *        3.6 outputs preliminary results and the final result of the trained weights
- *            into *.caffemodel - files
+ * The samples are wrapped into an InMemoryDataSource (shuffled every epoch if
+ * getShuffle() is true) and passed to train(DataSource&).
  *
  * NOTICE : the size of inputValues and expected output values has to be equal
  *          otherwise the function stops and returns false
- * NOTICE : the file, which is located at getSolverParametersPrototxtPath has to be a valid
- *          google-protobuf file which can be used to specify a caffe-solver, otherwise the
- *          function stops and returns true
  *
  */
 bool ANN::train (vector<double> inputValues_, vector<double> expectedOutputValues_) {
     if (inputValues_.size() != expectedOutputValues_.size()) {
         cout << "Error : inputValues_ and expectedOutputValues_ have different lengths" << endl;
         return false;
-    } else {
-        SolverParameter param;
-        switch (Caffe::mode()) {
-          case Caffe::CPU:
-            param.set_solver_mode(SolverParameter_SolverMode_CPU);
-            break;
-          case Caffe::GPU:
-            param.set_solver_mode(SolverParameter_SolverMode_GPU);
-            break;
-          default:
-            LOG(FATAL) << "Unknown Caffe mode: " << Caffe::mode();
-        }
+    }
 
-        // --- read solver parameters from file ---
+    InMemoryDataSource dataSource(inputValues_,expectedOutputValues_);
+    return trainInMemory(dataSource);
+}
 
-        // read file into string
-        std::ifstream iFile;
-        iFile.open(getSolverParametersPrototxtPath());
-        stringstream sstr;
-        sstr << iFile.rdbuf();
-        string str;
-        str = sstr.str();
+/**
+ * @brief ANN::train trains the network with the given inputs and expected outputs
+ * @param inputValues_ vector of input values per sample (one value per input neuron)
+ * @param expectedOutputValues_ vector of output values
+ * @return returns true if training has succesfully ended, otherwise false
+ *
+ * NOTICE : the size of inputValues and expected output values has to be equal
+ *          otherwise the function stops and returns false
+ */
+bool ANN::train(vector<vector<double> > inputValues_, vector<double> expectedOutputValues_) {
+    if (inputValues_.size() != expectedOutputValues_.size()) {
+        cout << "Error : inputValues_ and expectedOutputValues_ have different lengths" << endl;
+        return false;
+    }
 
-        // create solver parameter by string
-        if (!google::protobuf::TextFormat::ParseFromString(str, &param)) {
-            cout << "Error : solver prototxt file is not valid" << endl;
-            return false;
-        } else {
+    InMemoryDataSource dataSource(inputValues_,expectedOutputValues_);
+    return trainInMemory(dataSource);
+}
 
-            // create solver by parameter
-            solver_.reset(new SGDSolver<double>(param));
+/**
+ * @brief ANN::train trains the network with the given inputs and expected outputs
+ * @param inputValues_ vector of input values per sample (one value per input neuron)
+ * @param expectedOutputValues_ vector of output values per sample (one value per output neuron)
+ * @return returns true if training has succesfully ended, otherwise false
+ *
+ * All outputs are trained together by one net, i.e. the last layer before the loss layer
+ * has to have one neuron per output value.
+ *
+ * NOTICE : the size of inputValues and expected output values has to be equal
+ *          otherwise the function stops and returns false
+ */
+bool ANN::train(vector<vector<double> > inputValues_, vector<vector<double> > expectedOutputValues_) {
+    if (inputValues_.size() != expectedOutputValues_.size()) {
+        cout << "Error : inputValues_ and expectedOutputValues_ have different lengths" << endl;
+        return false;
+    }
 
-            // load weights
-            string trainedWeightsCaffemodelPath_l = getTrainedWeightsCaffemodelPath();
-            if (trainedWeightsCaffemodelPath_l != "") {
-                solver_->net()->CopyTrainedLayersFrom(trainedWeightsCaffemodelPath_l);
-            }
+    InMemoryDataSource dataSource(inputValues_,expectedOutputValues_);
+    return trainInMemory(dataSource);
+}
 
-            // --- load input data and expected output data into solver_->net ---
+/**
+ * @brief ANN::train trains the network with the given inputs and expected outputs
+ * @param inputValues_          input values, one row per sample
+ * @param expectedOutputValues_ expected output values, one row per sample
+ * @return returns true if training has succesfully ended, otherwise false
+ *
+ * Both matrices are copied once into an InMemoryDataSource (see train(vector<double>, vector<double>)).
+ *
+ * NOTICE : both matrices have to have the same number of rows, otherwise the function
+ *          stops and returns false
+ */
+bool ANN::train(const MatrixView& inputValues_, const MatrixView& expectedOutputValues_) {
+    if (inputValues_.getNumRows() != expectedOutputValues_.getNumRows()) {
+        cout << "Error : inputValues_ and expectedOutputValues_ have different numbers of rows" << endl;
+        return false;
+    }
 
-            // create BLOB for inputlayer - input data
-            Blob<double>* inputDataBLOB = solver_->net()->input_blobs()[0];
+    InMemoryDataSource dataSource(inputValues_,expectedOutputValues_);
+    return trainInMemory(dataSource);
+}
 
-            // create BLOB for inputlayer - expected output data
-            Blob<double>* expectedOutputDataBLOB = solver_->net()->input_blobs()[1];
+/**
+ * @brief ANN::train trains the network with the samples of a data set file
+ * @param dataSetPath_ path of a data set file with header (see ColumnarDataSet)
+ * @return returns true if training has succesfully ended, otherwise false
+ *
+ * The numbers of input and output columns are taken from the header of the data set. Like
+ * the headerless variant below the file is memory-mapped and read by a background thread.
+ *
+ * NOTICE : a batch size has to be set before (setBatchSize), otherwise the function prints an
+ *          error and returns false
+ */
+bool ANN::train(const string& dataSetPath_) {
+    if (getBatchSize() <= 0) {
+        cout << "Error : training from a data set file needs a batch size (setBatchSize)" << endl;
+        return false;
+    }
+    MappedDataSource mappedDataSource(dataSetPath_);
+    if (!mappedDataSource.isOpen()) {
+        return false;
+    }
+    mappedDataSource.setShuffle(getShuffle());
 
-            // set dimesions of input layer
-            // --> for normal caffe works with images, therefore the data
-            // --> typically is 4 dimensional
-            // --> numberOfImages * numberOfColorChannels * numberOfPixelsInDirectionOfHeight * numberOfPixelsInDirectionOfWidth
-            // --> in this case we use 1-dimensional data, therefore the data-dimension is numberOfInputValues*1*1*1
-            int num      = inputValues_.size();
-            int channels = 1;
-            int height   = 1;
-            int width    = 1;
-            vector<int> dimensionsOfData = {num,channels,height,width};
+    PrefetchingDataSource prefetchingDataSource(mappedDataSource);
+    return train(prefetchingDataSource);
+}
 
-            // set dimensions of input data
-            inputDataBLOB->Reshape(dimensionsOfData);
+/**
+ * @brief ANN::train trains the network with the samples of a binary data set on disk
+ * @param binaryDataSetPath_ path of a headerless columnar binary file (see MappedDataSource)
+ * @param numInputs_         number of input columns
+ * @param numOutputs_        number of expected output columns
+ * @return returns true if training has succesfully ended, otherwise false
+ *
+ * The file is memory-mapped instead of being read into memory, and the shuffled minibatches
+ * are read by a background thread while the solver works on the previous one. Therefore the
+ * data set may be much bigger than the main memory.
+ *
+ * NOTICE : a batch size has to be set before (setBatchSize), full batch mode would load the
+ *          whole file into the input blob. Otherwise the function prints an error and returns false
+ */
+bool ANN::train(const string& binaryDataSetPath_, int numInputs_, int numOutputs_) {
+    if (getBatchSize() <= 0) {
+        cout << "Error : training from a data set file needs a batch size (setBatchSize)" << endl;
+        return false;
+    }
+    MappedDataSource mappedDataSource(binaryDataSetPath_,numInputs_,numOutputs_);
+    if (!mappedDataSource.isOpen()) {
+        return false;
+    }
+    mappedDataSource.setShuffle(getShuffle());
 
-            // set dimensions of expected output data
-            expectedOutputDataBLOB->Reshape(dimensionsOfData);
+    PrefetchingDataSource prefetchingDataSource(mappedDataSource);
+    return train(prefetchingDataSource);
+}
 
-            // forward dimension-change to all layers
-            solver_->net()->Reshape();
+/**
+ * @brief ANN::train trains the network with samples of targetFunction_ which are generated while training
+ * @param domain_         box the input values are drawn from
+ * @param targetFunction_ function which is to approximate, has to be thread-safe
+ * @param numOutputs_     number of values returned by targetFunction_
+ * @return returns true if training has succesfully ended, otherwise false
+ *
+ * No data set is materialized : every minibatch consists of fresh random samples which are
+ * generated by background threads (see GeneratorDataSource) while the solver works.
+ *
+ * NOTICE : a batch size has to be set (setBatchSize), otherwise the function stops and returns false
+ */
+bool ANN::train(const Domain& domain_, const function<vector<double>(const vector<double>&)>& targetFunction_, int numOutputs_) {
+    GeneratorDataSource generatorDataSource(domain_,targetFunction_,numOutputs_);
+    return train(generatorDataSource);
+}
 
-            // insert input values and expected output values into
-            // BLOBs of input layer and output layer
-            for (unsigned int i = 0; i < inputValues_.size(); i++) {
-                setDataOfBLOB(inputDataBLOB,i,0,0,0,inputValues_[i]);
-                setDataOfBLOB(expectedOutputDataBLOB,i,0,0,0,expectedOutputValues_[i]);
-            }
+/**
+ * @brief ANN::train trains the network with the samples delivered by dataSource_
+ * @param dataSource_           source of input values and expected output values
+ * @param validationDataSource_ source of validation samples for early stopping (nullptr : no validation)
+ * @return returns true if training has succesfully ended, otherwise false
+ *
+ * The train function executes a learning to the net by doing the following steps :
+ *   1. create a solver object which encapsulate and controls the net solverParametersPrototxtPath-file
+ *   2. load the input data and the expected output data to the net
+ *        2.1 full batch mode (getBatchSize() == 0) : all samples are loaded once
+ *        2.2 minibatch mode  (getBatchSize() >  0) : the next getBatchSize() samples
+ *            are loaded before every iteration
+ *   3. execute the iterations of the solver, each of them
+ *        3.1 propagates the input data through the net,
+ *        3.2 calculates the current loss of the output
+ *        3.3 calculates deltas for every weight, depending on the loss
+ *        3.4 calculates new weights
+ *   4. output the final result of the trained weights into a *.caffemodel - file
+ *
+ * In full batch mode every iteration runs on the whole data set, therefore one iteration
+ * costs as much as an epoch and all samples have to fit into the input blob at once.
+ * In minibatch mode an iteration only costs getBatchSize() samples, which gives many more
+ * weight updates per second on big data sets. Data sources without a fixed number of
+ * samples (getNumSamples() == 0) can only be used in minibatch mode.
+ *
+ * If a normalization is set (setNormalization), the input values and the expected output
+ * values are normalized before they are loaded into the BLOBs (see fitNormalizers). The
+ * fitted normalizers are saved next to the trained weights and forward() applies them
+ * automatically. Training which continues from weights with saved normalizers keeps them.
+ *
+ * The solver is created by the solver registry of caffe for the type of the solver prototxt
+ * (e.g. type: "Adam"), unless it is overridden by setSolverType(). The adaptive solvers
+ * (AdaGrad, RMSProp, AdaDelta, Adam) scale the step of every weight by the history of its
+ * gradients and typically need far fewer iterations than SGD with momentum, with a fixed
+ * learning rate policy.
+ *
+ * The solver type "LevenbergMarquardt" trains the InnerProduct/activation stack of the net
+ * by the second-order method of LevenbergMarquardt instead of a caffe solver (see
+ * trainLevenbergMarquardt), which needs only a few hundred iterations. The solver type "LBFGS"
+ * minimizes the loss of the full data set by L-BFGS with a line search (see trainLBFGS), which
+ * needs neither a learning rate nor a learning rate policy.
+ *
+ * The number of iterations is max_iter of the solver prototxt, unless it is overridden by
+ * setMaxIterations(). Training continues from the weights at getTrainedWeightsCaffemodelPath(),
+ * which is set to the trained weights afterwards, therefore consecutive calls continue training.
+ *
+ * If a solver state is set (setSolverStatePath), e.g. a *.solverstate snapshot of an interrupted
+ * training, training resumes from it with the full state of the solver : the weights, the
+ * iteration (training continues up to max_iter, not for max_iter more iterations) and the
+ * history of the solver (momentum, adaptive learning rates), therefore the learning rate policy
+ * continues where it has stopped. Afterwards the solver state is set to the state saved with the
+ * trained weights, therefore consecutive calls resume as well. The normalizers are loaded from
+ * the weights of the solver state (if they have been saved next to them, otherwise they are
+ * fitted again). LevenbergMarquardt and LBFGS only continue from the weights of the solver state.
+ * The snapshots are always written as binary protos, HDF5 solver states (*.solverstate.h5) are
+ * rejected.
+ *
+ * The expected output data BLOB has one channel per output of the data source, i.e. a net
+ * with m outputs is trained for all of them at once.
+ *
+ * With more than one thread (setNumThreads) the samples of every iteration are split into one
+ * shard per thread, which is processed by an own replica of the net (see DataParallelSync).
+ * The gradients of all shards are summed before the weights are updated, therefore an
+ * iteration has the same result as on one thread, only the order of the summation differs.
+ * If asynchronous training is set (setAsynchronous), every thread updates the shared weights
+ * with the gradients of its shard as soon as they are ready, without waiting for the other
+ * threads (see AsynchronousSGD). The statistics of the last asynchronous training are
+ * returned by getAsynchronousReport(). Its weights are saved as
+ * <snapshot_prefix>_iter_<iteration>.caffemodel, where the iteration counts the updates of all
+ * threads, without a solver state : the history of the solver differs from thread to thread,
+ * therefore a solver state set before is cleared and the next training continues from the weights.
+ *
+ * If a ring is set (setRing), the process is one rank of a distributed training job. Every
+ * rank trains on its own samples (dataSource_ should hold a disjoint part of the data set)
+ * and the gradients of all ranks are summed before every update (see DistributedSync),
+ * therefore the weights of all ranks stay equal. The weights and normalizers of rank 0 are
+ * copied to all ranks when training starts, and only rank 0 writes snapshots and the trained
+ * weights. All ranks return after the trained weights have been saved.
+ *
+ * If validation samples are given (validationDataSource_, or setValidationFraction for the
+ * in-memory overloads of train), the validation error is evaluated every getValidationInterval()
+ * iterations by a validation net which shares the weights of the trained net (see EarlyStopping).
+ * Training stops when the validation error is at most getTargetValidationError() or has not
+ * improved for getPatience() validations, and the weights with the lowest validation error are
+ * saved instead of the last ones. The result is returned by getValidationReport(), which is
+ * empty after a training without validation.
+ *
+ * The iterations are run step by step (Solver::Step), after every iteration the solver checks
+ * whether the time budget (setTimeBudget) is used up or the cancellation token
+ * (setCancellationToken) has been cancelled by another thread. Then training stops cleanly :
+ * the weights trained so far (the best ones with validation) are saved like after the last
+ * iteration and true is returned. The budget counts from the call of train and includes
+ * loading the samples, saving the weights takes additional time. getStopReason() tells why
+ * the last training has ended. The time budget and the cancellation token are used by the
+ * caffe solvers only.
+ *
+ * NOTICE : the file, which is located at getSolverParametersPrototxtPath has to be a valid
+ *          google-protobuf file which can be used to specify a caffe-solver, otherwise the
+ *          function stops and returns false
+ * NOTICE : the layer in front of the loss layer has to have dataSource_.getNumOutputs() neurons,
+ *          otherwise the function stops and returns false
+ * NOTICE : validation needs a fixed number of validation samples, which are loaded at once,
+ *          and can not be combined with asynchronous or distributed training or with the solver
+ *          types LevenbergMarquardt and LBFGS, which stop by their own criteria
+ * NOTICE : a time budget or a cancellation token can not be combined with distributed training,
+ *          as all ranks have to run the same number of iterations
+ * NOTICE : a solver state refers to its weights by the path they have been saved to (relative
+ *          to the working directory of the training which saved it), like in caffe, the
+ *          weights have to be found there, and it can only be restored by a solver of the
+ *          type which has saved it, a solver state whose history does not fit to the solver
+ *          (e.g. of Adam for SGD) is rejected and the function returns false
+ *
+ */
+bool ANN::train(DataSource& dataSource_, DataSource* validationDataSource_) {
+    // the time budget includes loading the samples
+    deadline = chrono::steady_clock::now() + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(getTimeBudget()));
+    stopReason = COMPLETED;
+    validationReport = EarlyStopping::Report();
+
+    // --- read solver parameters from file ---
+
+    // read file into string
+    std::ifstream iFile;
+    iFile.open(getSolverParametersPrototxtPath());
+    stringstream sstr;
+    sstr << iFile.rdbuf();
+    string str;
+    str = sstr.str();
+
+    // create solver parameter by string
+    SolverParameter param;
+    if (!google::protobuf::TextFormat::ParseFromString(str, &param)) {
+        cout << "Error : solver prototxt file is not valid" << endl;
+        return false;
+    }
+    // the deprecated enum solver_type is converted into the type string
+    UpgradeSolverAsNeeded(getSolverParametersPrototxtPath(),&param);
+    if (getSolverType() != "") {
+        param.set_type(getSolverType());
+    }
+    vector<string> solverTypes = SolverRegistry<double>::SolverTypeList();
+    if (param.type() != "LevenbergMarquardt" && param.type() != "LBFGS" && find(solverTypes.begin(),solverTypes.end(),param.type()) == solverTypes.end()) {
+        cout << "Error : solver type " << param.type() << " is not known" << endl;
+        return false;
+    }
+    switch (Caffe::mode()) {
+      case Caffe::CPU:
+        param.set_solver_mode(SolverParameter_SolverMode_CPU);
+        break;
+      case Caffe::GPU:
+        param.set_solver_mode(SolverParameter_SolverMode_GPU);
+        break;
+      default:
+        LOG(FATAL) << "Unknown Caffe mode: " << Caffe::mode();
+    }
+    if (getMaxIterations() > 0) {
+        param.set_max_iter(getMaxIterations());
+    }
+    // the saved weights and solver states are read back as binary protos (*.caffemodel, *.solverstate)
+    param.set_snapshot_format(SolverParameter_SnapshotFormat_BINARYPROTO);
 
-            // start training
-            //  --> this is done by Solve(), which automatically does the following steps
-            //      --> 1. propagates input data through solver_->net
-            //             by automatically using solver_->net()->forward
-            //             as the  output layer is a loss-layer the forward()
-            //             produces a loss value (the badness of the current weights)
-            //      --> 2. by knowing the loss and using solver_->net()->backward() it automatically
-            //             calculates a gradient for every weight (every connection) in the net
-            //             (gradient == a delta of how much the weights have to get changed)
-            //      --> 3. by knowing the gradients it automatically calculates the new weights
-            //  --> these three steps are executed for every input-value and for every learning iteration step
-            //  --> during Solve() preliminary results for the weights are saved to the directory defined in
-            //      solverFile_
-            //  --> the frequency of creating preliminary results as well as the number of training iterations
-            //      and other parameters are defined in solverFile_
-            solver_->Solve();
-
-            // save current trained weights
-            stringstream tempPath;
-            tempPath << param.snapshot_prefix() << "_iter_" << param.max_iter() << ".caffemodel";
-            setTrainedWeightsCaffemodelPath(tempPath.str());
-            solver_->Snapshot();
-            return true;
+    // distributed training : rank 0 saves the weights and logs the progress
+    if (ring != nullptr) {
+        if (getAsynchronous() || param.type() == "LevenbergMarquardt" || param.type() == "LBFGS") {
+            cout << "Error : " << (getAsynchronous() ? "asynchronous" : param.type()) << " training can not be distributed" << endl;
+            return false;
+        }
+        if (ring->getRank() != 0) {
+            param.set_snapshot(0);
+            param.set_snapshot_after_train(false);
+            param.set_display(0);
         }
     }
-}
 
-bool ANN::train(vector<vector<double> > inputValues_, vector<double> expectedOutputValues_) {
-    if (inputValues_.size() != expectedOutputValues_.size()) {
-        cout << "Error : inputValues_ and expectedOutputValues_ have different lengths" << endl;
+    if (ring != nullptr && (getTimeBudget() > 0 || getCancellationToken() != nullptr)) {
+        cout << "Error : distributed training can not be stopped by a time budget or a cancellation token" << endl;
         return false;
-    } else {
-        SolverParameter param;
-        switch (Caffe::mode()) {
-          case Caffe::CPU:
-            param.set_solver_mode(SolverParameter_SolverMode_CPU);
-            break;
-          case Caffe::GPU:
-            param.set_solver_mode(SolverParameter_SolverMode_GPU);
-            break;
-          default:
-            LOG(FATAL) << "Unknown Caffe mode: " << Caffe::mode();
+    }
+
+    // early stopping : all validation samples are evaluated at once by every validation
+    if (validationDataSource_ != nullptr) {
+        if (getAsynchronous() || ring != nullptr) {
+            cout << "Error : early stopping can not be combined with " << (getAsynchronous() ? "asynchronous" : "distributed") << " training" << endl;
+            return false;
+        }
+        if (param.type() == "LevenbergMarquardt" || param.type() == "LBFGS") {
+            cout << "Error : early stopping can not be combined with the solver type " << param.type() << ", which stops by its own criteria" << endl;
+            return false;
+        }
+        if (validationDataSource_->getNumSamples() == 0 ||
+            validationDataSource_->getNumInputs () != dataSource_.getNumInputs () ||
+            validationDataSource_->getNumOutputs() != dataSource_.getNumOutputs()) {
+            cout << "Error : the validation data source needs a fixed number of samples with the inputs and outputs of the data source" << endl;
+            return false;
+        }
+    }
+
+    // number of samples per iteration
+    int num = getBatchSize();
+    if (num <= 0) {
+        if (dataSource_.getNumSamples() == 0) {
+            cout << "Error : full batch training needs a data source with a fixed number of samples" << endl;
+            return false;
         }
+        num = dataSource_.getNumSamples();
+    }
 
-        // --- read solver parameters from file ---
+    // resuming : training continues from the weights of the solver state
+    string solverStatePath_l = getSolverStatePath();
+    int stateHistorySize = 0;
+    if (solverStatePath_l != "") {
+        // the weights and normalizers belong to the learned_net of the state, which is only read from binary protos
+        if (solverStatePath_l.size() > 3 && solverStatePath_l.compare(solverStatePath_l.size() - 3,3,".h5") == 0) {
+            cout << "Error : solver state " << solverStatePath_l << " is a HDF5 file, only *.solverstate files (snapshot_format: BINARYPROTO) are supported" << endl;
+            return false;
+        }
+        // caffe aborts on missing files
+        SolverState state;
+        if (!ifstream(solverStatePath_l).good() || !ReadProtoFromBinaryFile(solverStatePath_l,&state)) {
+            cout << "Error : solver state " << solverStatePath_l << " can not be read" << endl;
+            return false;
+        }
+        stateHistorySize = state.history_size();
+        if (state.has_learned_net()) {
+            if (!ifstream(state.learned_net()).good()) {
+                cout << "Error : the weights " << state.learned_net() << " of solver state " << solverStatePath_l << " can not be read" << endl;
+                return false;
+            }
+            setTrainedWeightsCaffemodelPath(state.learned_net());
+        }
+    }
 
-        // read file into string
-        std::ifstream iFile;
-        iFile.open(getSolverParametersPrototxtPath());
-        stringstream sstr;
-        sstr << iFile.rdbuf();
-        string str;
-        str = sstr.str();
-        cout << str << endl;
+    // normalizers : keep those of the weights training continues from, otherwise fit new ones
+    if (!loadNormalizers()) {
+        if (getNormalization() != Normalizer::NONE) {
+            fitNormalizers(dataSource_);
+        }
+    }
 
-        // create solver parameter by string
-        if (!google::protobuf::TextFormat::ParseFromString(str, &param)) {
-            cout << "Error : solver prototxt file is not valid" << endl;
+    // distributed training : all ranks use the normalizers of rank 0
+    if (ring != nullptr) {
+        stringstream normalizers;
+        inputNormalizer.write(normalizers);
+        outputNormalizer.write(normalizers);
+        string data = normalizers.str();
+        if (!ring->broadcast(data)) {
+            cout << "Error : the normalizers of rank 0 can not be received" << endl;
             return false;
-        } else {
+        }
+        stringstream receivedNormalizers(data);
+        inputNormalizer.read(receivedNormalizers);
+        outputNormalizer.read(receivedNormalizers);
+    }
+
+    // second-order training without a caffe solver, which saves no solver state
+    if (param.type() == "LevenbergMarquardt" || param.type() == "LBFGS") {
+        setSolverStatePath("");
+    }
+    if (param.type() == "LevenbergMarquardt") {
+        return trainLevenbergMarquardt(dataSource_,param);
+    }
+    if (param.type() == "LBFGS") {
+        return trainLBFGS(dataSource_,param);
+    }
 
-            // create solver by parameter
-            solver_.reset(new SGDSolver<double>(param));
+    // create solver by parameter
+    releaseSolver();
+    solver_.reset(SolverRegistry<double>::CreateSolver(param));
 
-            // load weights
-            string trainedWeightsCaffemodelPath_l = getTrainedWeightsCaffemodelPath();
-            if (trainedWeightsCaffemodelPath_l != "") {
-                solver_->net()->CopyTrainedLayersFrom(trainedWeightsCaffemodelPath_l);
-            }
+    // load weights, a solver state restores the weights, the iteration and the history of the solver
+    string trainedWeightsCaffemodelPath_l = getTrainedWeightsCaffemodelPath();
+    if (solverStatePath_l != "") {
+        // caffe aborts if the history of the state does not fit to the solver (e.g. the state of Adam
+        // has two BLOBs per parameter, the state of SGD one)
+        SGDSolver<double>* sgdSolver = dynamic_cast<SGDSolver<double>*>(solver_.get());
+        if (sgdSolver != nullptr && stateHistorySize != (int)sgdSolver->history().size()) {
+            cout << "Error : solver state " << solverStatePath_l << " has " << stateHistorySize << " history BLOBs, but the "
+                 << param.type() << " solver has " << sgdSolver->history().size() << ", it has been saved by another solver type" << endl;
+            releaseSolver();
+            return false;
+        }
+        solver_->Restore(solverStatePath_l.c_str());
+    } else if (trainedWeightsCaffemodelPath_l != "") {
+        solver_->net()->CopyTrainedLayersFrom(trainedWeightsCaffemodelPath_l);
+    }
+
+    // --- prepare input data and expected output data BLOBs of solver_->net ---
+
+    // create BLOB for inputlayer - expected output data
+    Blob<double>* expectedOutputDataBLOB = solver_->net()->input_blobs()[1];
 
-            // --- load input data and expected output data into solver_->net ---
+    // set dimesions of input layer
+    // --> for normal caffe works with images, therefore the data
+    // --> typically is 4 dimensional
+    // --> numberOfImages * numberOfColorChannels * numberOfPixelsInDirectionOfHeight * numberOfPixelsInDirectionOfWidth
+    // --> in this case we use 1-dimensional data, therefore the data-dimension is numberOfSamples*numberOfInputs*1*1
+    int channels = dataSource_.getNumInputs();
+    int height   = 1;
+    int width    = 1;
+    vector<int> dimensionsOfData = {num,channels,height,width};
+
+    // the expected output data has one channel per output of the net (R^n -> R^m)
+    vector<int> dimensionsOfExpectedData = {num,dataSource_.getNumOutputs(),height,width};
+
+    // the loss layer compares the prediction of the net with the expected output data,
+    // therefore the net has to predict one value per output of the data source
+    for (unsigned int i = 0; i < solver_->net()->layers().size(); i++) {
+        const vector<Blob<double>*>& bottoms = solver_->net()->bottom_vecs()[i];
+        if (bottoms.size() == 2 && bottoms[1] == expectedOutputDataBLOB && bottoms[0]->count(1) != dataSource_.getNumOutputs()) {
+            cout << "Error : the net predicts " << bottoms[0]->count(1) << " values per sample, but the data source has "
+                 << dataSource_.getNumOutputs() << " outputs" << endl;
+            releaseSolver();
+            return false;
+        }
+    }
 
-            // create BLOB for inputlayer - input data
-            Blob<double>* inputDataBLOB = solver_->net()->input_blobs()[0];
+    // early stopping : the validation samples are loaded once, the error of the initial weights is the first validation
+    if (validationDataSource_ != nullptr) {
+        earlyStopping.reset(new EarlyStopping(solver_.get()));
+        earlyStopping->setInterval(getValidationInterval());
+        earlyStopping->setPatience(getPatience());
+        earlyStopping->setTargetError(getTargetValidationError());
+
+        Net<double>* validationNet = earlyStopping->getValidationNet();
+        int numValidationSamples = validationDataSource_->getNumSamples();
+        validationNet->input_blobs()[0]->Reshape(vector<int>{numValidationSamples,channels,height,width});
+        validationNet->input_blobs()[1]->Reshape(vector<int>{numValidationSamples,dataSource_.getNumOutputs(),height,width});
+        validationNet->Reshape();
+        fillTrainingBLOBs(*validationDataSource_,validationNet->input_blobs()[0],validationNet->input_blobs()[1]);
+        earlyStopping->validate();
+    }
 
-            // create BLOB for inputlayer - expected output data
-            Blob<double>* expectedOutputDataBLOB = solver_->net()->input_blobs()[1];
+    // the solver checks after every iteration whether training has to stop
+    stopRequested = isInterrupted();
+    if (earlyStopping || getTimeBudget() > 0 || getCancellationToken() != nullptr) {
+        solver_->SetActionFunction([this]() {
+            stopRequested = stopRequested || isInterrupted() || (earlyStopping && earlyStopping->shouldStop());
+            return stopRequested ? SolverAction::STOP : SolverAction::NONE;
+        });
+    }
 
+    // data-parallel training : one replica of the net per thread, replica 0 is the net of the solver
+    int numReplicas = getNumThreads() > 0 ? getNumThreads() : max(1u,thread::hardware_concurrency());
+    numReplicas = min(numReplicas,num);
+    if (numReplicas > 1 && getAsynchronous()) {
+        asynchronousSGD.reset(new AsynchronousSGD(solver_.get(),numReplicas));
+    } else if (numReplicas > 1) {
+        parallelSync.reset(new DataParallelSync(solver_.get(),numReplicas));
+    }
+    vector<Net<double>*> replicas(1,solver_->net().get());
+    for (int r = 1; r < numReplicas; r++) {
+        replicas.push_back(asynchronousSGD ? asynchronousSGD->getReplica(r) : parallelSync->getReplica(r));
+    }
 
-            // set dimesions of input layer
-            // --> for normal caffe works with images, therefore the data
-            // --> typically is 4 dimensional
-            // --> numberOfImages * numberOfColorChannels * numberOfPixelsInDirectionOfHeight * numberOfPixelsInDirectionOfWidth
-            // --> in this case we use 1-dimensional data, therefore the data-dimension is numberOfInputValues*1*1*1
-            int num      = inputValues_.size();
-            int channels = inputValues_[0].size();
-            int height   = 1;
-            int width    = 1;
-            vector<int> dimensionsOfData = {num,channels,height,width};
+    // distributed training : the gradients of all replicas of this rank are summed first
+    if (ring != nullptr) {
+        distributedSync.reset(new DistributedSync(solver_.get(),*ring));
+        distributedSync->setNumSamples(num);
+    }
 
-            // set dimensions of input data
-            inputDataBLOB->Reshape(dimensionsOfData);
+    // every replica gets a disjoint shard of the num samples of an iteration
+    for (int r = 0; r < numReplicas; r++) {
+        dimensionsOfData[0]         = num / numReplicas + (r < num % numReplicas ? 1 : 0);
+        dimensionsOfExpectedData[0] = dimensionsOfData[0];
 
-            // set dimensions of expected output data
-            expectedOutputDataBLOB->Reshape(dimensionsOfData);
+        // set dimensions of input data
+        replicas[r]->input_blobs()[0]->Reshape(dimensionsOfData);
 
-            // forward dimension-change to all layers
-            solver_->net()->Reshape();
+        // set dimensions of expected output data
+        replicas[r]->input_blobs()[1]->Reshape(dimensionsOfExpectedData);
 
-            // insert input values for all neurons for every inputData-dataset
-            // into BLOB of input layer
+        // forward dimension-change to all layers
+        replicas[r]->Reshape();
+    }
 
-            for (unsigned int inputDataSetIndex = 0; inputDataSetIndex < inputValues_.size(); inputDataSetIndex++) {
-                for (unsigned int inputNeuronIndex = 0; inputNeuronIndex < inputValues_[inputDataSetIndex].size(); inputNeuronIndex++) {
-                    setDataOfBLOB(inputDataBLOB,inputDataSetIndex,inputNeuronIndex,0,0,inputValues_[inputDataSetIndex][inputNeuronIndex]);
+    // start training
+    //  --> every iteration of the solver does the following steps
+    //      --> 1. propagates input data through solver_->net
+    //             by automatically using solver_->net()->forward
+    //             as the  output layer is a loss-layer the forward()
+    //             produces a loss value (the badness of the current weights)
+    //      --> 2. by knowing the loss and using solver_->net()->backward() it automatically
+    //             calculates a gradient for every weight (every connection) in the net
+    //             (gradient == a delta of how much the weights have to get changed)
+    //      --> 3. by knowing the gradients it automatically calculates the new weights
+    //  --> during training preliminary results for the weights are saved to the directory defined in
+    //      solverFile_
+    //  --> the frequency of creating preliminary results as well as the number of training iterations
+    //      and other parameters are defined in solverFile_
+    bool completed;
+    long startIteration = 0;
+    if (asynchronousSGD) {
+        // every thread loads its own minibatches (full batch : keeps its shard)
+        function<void(Net<double>*)> loadBatch;
+        if (getBatchSize() <= 0) {
+            for (Net<double>* replica : replicas) {
+                fillTrainingBLOBs(dataSource_,replica->input_blobs()[0],replica->input_blobs()[1]);
+            }
+        } else {
+            loadBatch = [this, &dataSource_](Net<double>* replica_) {
+                fillTrainingBLOBs(dataSource_,replica_->input_blobs()[0],replica_->input_blobs()[1]);
+            };
+        }
+        function<bool()> stop;
+        if (getTimeBudget() > 0 || getCancellationToken() != nullptr) {
+            stop = [this]() {return isInterrupted();};
+        }
+        startIteration = solver_->iter();
+        long numUpdates = param.max_iter() - startIteration;
+        asynchronousReport = stopRequested ? AsynchronousSGD::Report() : asynchronousSGD->run(numUpdates,loadBatch,stop);
+        completed = asynchronousReport.numUpdates >= numUpdates;
+    } else {
+        // full batch : the whole data set is loaded once and used by all iterations,
+        // minibatch : a new minibatch is loaded before every iteration
+        if (getBatchSize() <= 0) {
+            for (Net<double>* replica : replicas) {
+                fillTrainingBLOBs(dataSource_,replica->input_blobs()[0],replica->input_blobs()[1]);
+            }
+        }
+        while (solver_->iter() < param.max_iter() && !stopRequested) {
+            if (getBatchSize() > 0) {
+                for (Net<double>* replica : replicas) {
+                    fillTrainingBLOBs(dataSource_,replica->input_blobs()[0],replica->input_blobs()[1]);
                 }
             }
+            solver_->Step(getBatchSize() > 0 ? 1 : param.max_iter() - solver_->iter());
+        }
+        completed = solver_->iter() >= param.max_iter();
+    }
 
-            // insert expected output values into
-            // BLOB of output layer
-            for (unsigned int i = 0; i < inputValues_.size(); i++) {
-                setDataOfBLOB(expectedOutputDataBLOB,i,0,0,0,expectedOutputValues_[i]);
-            }
+    // why training has ended before max_iter, the cancellation wins over the budget
+    if (earlyStopping && earlyStopping->getReport().stoppedEarly) {
+        stopReason = EARLY_STOPPING;
+    } else if (!completed) {
+        stopReason = (getCancellationToken() != nullptr && getCancellationToken()->isCancelled()) ? CANCELLED : TIME_BUDGET;
+    }
 
-            // start training
-            //  --> this is done by Solve(), which automatically does the following steps
-            //      --> 1. propagates input data through solver_->net
-            //             by automatically using solver_->net()->forward
-            //             as the  output layer is a loss-layer the forward()
-            //             produces a loss value (the badness of the current weights)
-            //      --> 2. by knowing the loss and using solver_->net()->backward() it automatically
-            //             calculates a gradient for every weight (every connection) in the net
-            //             (gradient == a delta of how much the weights have to get changed)
-            //      --> 3. by knowing the gradients it automatically calculates the new weights
-            //  --> these three steps are executed for every input-value and for every learning iteration step
-            //  --> during Solve() preliminary results for the weights are saved to the directory defined in
-            //      solverFile_
-            //  --> the frequency of creating preliminary results as well as the number of training iterations
-            //      and other parameters are defined in solverFile_
-            solver_->Solve();
-
-            // save current trained weights
-            stringstream tempPath;
-            tempPath << param.snapshot_prefix() << "_iter_" << param.max_iter() << ".caffemodel";
-            setTrainedWeightsCaffemodelPath(tempPath.str());
-            solver_->Snapshot();
-            return true;
+    // early stopping : the weights with the lowest validation error are saved
+    if (earlyStopping) {
+        earlyStopping->restoreBestWeights();
+        validationReport = earlyStopping->getReport();
+        if (param.display() > 0) {
+            validationReport.print(cout);
         }
     }
+
+    // save current trained weights, asynchronous training counts the updates of all workers
+    // (the iterations of solver_ are only those of worker 0)
+    long iteration = asynchronousSGD ? startIteration + asynchronousReport.numUpdates : solver_->iter();
+    stringstream tempPath;
+    tempPath << param.snapshot_prefix() << "_iter_" << iteration;
+    setTrainedWeightsCaffemodelPath(tempPath.str() + ".caffemodel");
+    // a retraining which ends at the same iteration overwrites the file of the loaded net,
+    // therefore the loaded net is discarded even if the path has not changed
+    net.reset();
+    if (solverStatePath_l != "") {
+        setSolverStatePath(asynchronousSGD ? "" : tempPath.str() + ".solverstate");
+    }
+    bool saved = true;
+    if (asynchronousSGD) {
+        // the solver state of worker 0 holds neither the iteration nor the history of the other workers
+        NetParameter trainedWeights;
+        solver_->net()->ToProto(&trainedWeights);
+        WriteProtoToBinaryFile(trainedWeights,getTrainedWeightsCaffemodelPath());
+        saved = saveNormalizers();
+    } else if (ring == nullptr || ring->getRank() == 0) {
+        solver_->Snapshot();
+        saved = saveNormalizers();
+    }
+
+    // distributed training : the other ranks wait until rank 0 has saved the weights
+    bool connected = (ring == nullptr) || (distributedSync->isValid() && ring->barrier());
+
+    // the worker threads and replicas are only needed while training
+    releaseSolver();
+    if (!connected) {
+        cout << "Error : rank " << ring->getRank() << " has lost the connection to the other ranks" << endl;
+        return false;
+    }
+    return saved;
 }
 
 
 
-/* --- miscellaneous --- */
+/* --- access to the loaded net --- */
 
-vector<double> ANN::zTransformVector(const vector<double>& vectorToTransform_) {
+/**
+ * @brief ANN::loadNet loads the net used for propagating values forward
+ * @return returns a pointer to the loaded net
+ *
+ * The net structure is read from getNetStructurePrototxtPath() and the weights are
+ * copied from getTrainedWeightsCaffemodelPath() (if set), together with the normalizers
+ * which have been saved next to the weights by train().
+ *
+ * Building a caffe net is much more expensive than propagating a small batch
+ * through it. Therefore the net is only rebuilt if one of both paths has changed
+ * since the last call, otherwise the already loaded net is reused. This allows
+ * calling forward() repeatedly (e.g. chunk by chunk) without reloading the files.
+ * train() discards the loaded net whenever it saves weights, as it may overwrite the
+ * file at the same path (e.g. a retraining with the same number of iterations).
+ */
+Net<double>* ANN::loadNet() {
+    string netStructurePrototxtPath_l     = getNetStructurePrototxtPath();
+    string trainedWeightsCaffemodelPath_l = getTrainedWeightsCaffemodelPath();
 
-    vector<double> result = vectorToTransform_;
+    if ( (!net) ||
+         (netStructurePrototxtPath_l     != loadedNetStructurePrototxtPath) ||
+         (trainedWeightsCaffemodelPath_l != loadedTrainedWeightsCaffemodelPath) ) {
 
-    // calculate mean
-    double sum = std::accumulate(vectorToTransform_.begin(), vectorToTransform_.end(), 0.0);
-    double mean = double(sum) / double(vectorToTransform_.size());
-    // calculate standard deviation
-    double sq_sum = std::inner_product(vectorToTransform_.begin(), vectorToTransform_.end(), vectorToTransform_.begin(), 0.0);
-    double stdev = std::sqrt(sq_sum / double(vectorToTransform_.size()-1) - mean * mean);
+        // load network-structure from prototxt-file
+        net.reset(new Net<double>(netStructurePrototxtPath_l,caffe::TEST));
 
-    for (int i = 0 ; i < vectorToTransform_.size(); i++) {
-        result[i] = (double(vectorToTransform_[i]) - double(mean)) / double(stdev);
-    }
+        // load weights
+        if (trainedWeightsCaffemodelPath_l != "") {
+            net->CopyTrainedLayersFrom(trainedWeightsCaffemodelPath_l);
+        }
+        loadNormalizers();
 
-    return result;
+        loadedNetStructurePrototxtPath     = netStructurePrototxtPath_l;
+        loadedTrainedWeightsCaffemodelPath = trainedWeightsCaffemodelPath_l;
+    }
 
+    return net.get();
 }
 
-vector<double> ANN::reZTransformVector(const vector<double> &vectorToReTransform_, const vector<double> &vectorBeforeZTransform_) {
-    vector<double> result = vectorToReTransform_;
 
-    // calculate mean
-    double sum = std::accumulate(vectorBeforeZTransform_.begin(), vectorBeforeZTransform_.end(), 0.0);
-    double mean = double(sum) / double(vectorBeforeZTransform_.size());
-    // calculate standard deviation
-    double sq_sum = std::inner_product(vectorBeforeZTransform_.begin(), vectorBeforeZTransform_.end(), vectorBeforeZTransform_.begin(), 0.0);
-    double stdev = std::sqrt(sq_sum / double(vectorBeforeZTransform_.size()-1) - mean * mean);
 
-    for (int i = 0 ; i < vectorToReTransform_.size(); i++) {
-        result[i] = double(vectorToReTransform_[i]) * double(stdev) + double(mean);
-    }
+/* --- miscellaneous --- */
 
-    return result;
+/**
+ * @brief ANN::zTransformVector returns the z-transformed values (mean 0, sample standard deviation 1)
+ *
+ * NOTICE : to transform further values or to transform values back without the original
+ *          values, fit a Normalizer once and keep it (see setNormalization)
+ */
+vector<double> ANN::zTransformVector(const vector<double>& vectorToTransform_) {
+    Normalizer normalizer(Normalizer::Z_SCORE);
+    normalizer.fit(vectorToTransform_);
+    return normalizer.transform(vectorToTransform_);
+}
+
+/**
+ * @brief ANN::reZTransformVector maps z-transformed values back by the statistics of vectorBeforeZTransform_
+ */
+vector<double> ANN::reZTransformVector(const vector<double> &vectorToReTransform_, const vector<double> &vectorBeforeZTransform_) {
+    Normalizer normalizer(Normalizer::Z_SCORE);
+    normalizer.fit(vectorBeforeZTransform_);
+    return normalizer.inverseTransform(vectorToReTransform_);
 }
 
+/**
+ * @brief ANN::scaleVector returns vectorToScale_ divided (minimize_) or multiplied by scaleFactor_
+ *
+ * NOTICE : the copy is scaled in place by Transforms, buffers which need no copy can be
+ *          scaled directly by Transforms::scale / Transforms::divide
+ */
 vector<double> ANN::scaleVector(const vector<double> &vectorToScale_, double scaleFactor_, bool minimize_) {
     vector<double> result = vectorToScale_;
+    if (minimize_) {
+        Transforms::divide(result.data(),result.size(),1,&scaleFactor_);
+    } else {
+        Transforms::scale(result.data(),result.size(),1,&scaleFactor_);
+    }
+    return result;
+}
 
-    for (int i = 0 ; i < vectorToScale_.size(); i++) {
+/**
+ * @brief ANN::scaleVector returns every row of vectorToScale_ divided (minimize_) or multiplied by scaleFactor_
+ */
+vector<vector<double> > ANN::scaleVector(const vector<vector<double> > &vectorToScale_, double scaleFactor_, bool minimize_) {
+    vector< vector<double> > result = vectorToScale_;
+    for (unsigned int i = 0 ; i < result.size(); i++) {
         if (minimize_) {
-            result[i] = double(vectorToScale_[i]) / double(scaleFactor_);
+            Transforms::divide(result[i].data(),result[i].size(),1,&scaleFactor_);
         } else {
-            result[i] = double(vectorToScale_[i]) * double(scaleFactor_);
+            Transforms::scale(result[i].data(),result[i].size(),1,&scaleFactor_);
         }
     }
-
     return result;
 }
 
-vector<vector<double> > ANN::scaleVector(const vector<vector<double> > &vectorToScale_, double scaleFactor_, bool minimize_) {
-    vector< vector<double> > result = vectorToScale_;
 
-    for (int i = 0 ; i < vectorToScale_.size(); i++) {
-        result[i] = scaleVector(vectorToScale_[i],scaleFactor_,minimize_);
+
+/**
+ * @brief ANN::scaleVector divides (minimize_) or multiplies all values of matrixToScale_ by scaleFactor_ in place
+ */
+void ANN::scaleVector(Matrix& matrixToScale_, double scaleFactor_, bool minimize_) {
+    if (minimize_) {
+        Transforms::divide(matrixToScale_.data(),matrixToScale_.getSize(),1,&scaleFactor_);
+    } else {
+        Transforms::scale(matrixToScale_.data(),matrixToScale_.getSize(),1,&scaleFactor_);
     }
+}
 
-    return result;
+
+
+/**
+ * @brief ANN::fillTrainingBLOBs loads the next samples of dataSource_ into the BLOBs of the input layer
+ * @param dataSource_             source of the samples
+ * @param inputDataBLOB_          BLOB for the input values, its num() samples are loaded
+ * @param expectedOutputDataBLOB_ BLOB for the expected output values, num() * dataSource_.getNumOutputs() values
+ *
+ * The values are written directly into both BLOBs, as their memory layout (one row of
+ * channels() values per sample) matches the layout of the data source. Both are normalized
+ * by the fitted normalizers (if any).
+ */
+void ANN::fillTrainingBLOBs(DataSource& dataSource_, Blob<double>* inputDataBLOB_, Blob<double>* expectedOutputDataBLOB_) {
+    int num        = inputDataBLOB_->num();
+    int numOutputs = dataSource_.getNumOutputs();
+    dataSource_.nextBatch(num,inputDataBLOB_->mutable_cpu_data(),expectedOutputDataBLOB_->mutable_cpu_data());
+    normalizeInputs(inputDataBLOB_->mutable_cpu_data(),num,dataSource_.getNumInputs());
+    if (outputNormalizer.isFitted() && outputNormalizer.getNumFeatures() == numOutputs) {
+        outputNormalizer.transform(expectedOutputDataBLOB_->mutable_cpu_data(),num);
+    }
+}
+
+/**
+ * @brief ANN::trainLevenbergMarquardt trains the weights by the method of Levenberg-Marquardt (see LevenbergMarquardt)
+ * @param dataSource_ source of the samples, all samples are loaded at once
+ * @param param_      solver parameters : max_iter, snapshot_prefix and display are used
+ * @return returns true if the trained weights have been saved, otherwise false
+ *
+ * The InnerProduct/activation stack of the net at getNetStructurePrototxtPath() is copied into
+ * an MLP, starting from the weights at getTrainedWeightsCaffemodelPath() (if set) or from the
+ * weights of the fillers of the net. The trained weights are written back into the net and
+ * saved as <snapshot_prefix>_iter_<iterations>.caffemodel, which is a standard caffemodel.
+ * The statistics of the training are returned by getLevenbergMarquardtReport().
+ *
+ * NOTICE : the net has to consist of InnerProduct, TanH and ReLU layers (see MLP::loadFromNet)
+ */
+bool ANN::trainLevenbergMarquardt(DataSource& dataSource_, const SolverParameter& param_) {
+    int num = dataSource_.getNumSamples();
+    if (num == 0) {
+        cout << "Error : Levenberg-Marquardt training needs a data source with a fixed number of samples" << endl;
+        return false;
+    }
+
+    // all samples, normalized like the samples of the caffe solvers
+    Matrix inputValues(num,dataSource_.getNumInputs());
+    Matrix expectedOutputValues(num,dataSource_.getNumOutputs());
+    dataSource_.nextBatch(num,inputValues.data(),expectedOutputValues.data());
+    normalizeInputs(inputValues.data(),num,dataSource_.getNumInputs());
+    if (outputNormalizer.isFitted() && outputNormalizer.getNumFeatures() == dataSource_.getNumOutputs()) {
+        outputNormalizer.transform(expectedOutputValues);
+    }
+
+    Net<double> net_l(getNetStructurePrototxtPath(),caffe::TEST);
+    if (getTrainedWeightsCaffemodelPath() != "") {
+        net_l.CopyTrainedLayersFrom(getTrainedWeightsCaffemodelPath());
+    }
+    MLP mlp;
+    if (!mlp.loadFromNet(&net_l)) {
+        return false;
+    }
+
+    LevenbergMarquardt trainer;
+    trainer.setMaxIterations(param_.max_iter());
+    trainer.setNumThreads(getNumThreads());
+    if (!trainer.train(mlp,inputValues,expectedOutputValues,levenbergMarquardtReport)) {
+        return false;
+    }
+    if (param_.display() > 0) {
+        levenbergMarquardtReport.print(cout);
+    }
+
+    // save trained weights
+    if (!mlp.writeToNet(&net_l)) {
+        return false;
+    }
+    stringstream tempPath;
+    tempPath << param_.snapshot_prefix() << "_iter_" << levenbergMarquardtReport.numIterations << ".caffemodel";
+    NetParameter weights;
+    net_l.ToProto(&weights);
+    WriteProtoToBinaryFile(weights,tempPath.str());
+    setTrainedWeightsCaffemodelPath(tempPath.str());
+    // the file of the loaded net may have been overwritten (see train)
+    net.reset();
+    return saveNormalizers();
+}
+
+/**
+ * @brief ANN::trainLBFGS trains the weights by minimizing the loss of all samples with L-BFGS (see LBFGS)
+ * @param dataSource_ source of the samples, all samples are loaded at once
+ * @param param_      solver parameters : net, max_iter, weight_decay, snapshot_prefix and display are used
+ * @return returns true if the trained weights have been saved, otherwise false
+ *
+ * The TRAIN net of the solver prototxt (with its loss layer, see SolverNet) is built once for all samples, starting
+ * from the weights at getTrainedWeightsCaffemodelPath() (if set) or from the weights of the
+ * fillers. Every evaluation of the objective sets the learnable parameters, runs Forward and
+ * Backward over all samples and returns the loss and the gradients, plus the L2 regularization
+ * 0.5 * weight_decay * decay_mult * |w|^2 of every parameter BLOB. The step lengths are found
+ * by a line search, therefore base_lr, lr_policy, momentum and the solver type are not used and
+ * the training is deterministic. It stops after max_iter iterations or when the loss does not
+ * change any more.
+ *
+ * The trained weights are saved as <snapshot_prefix>_iter_<iterations>.caffemodel, the
+ * statistics of the training are returned by getLBFGSReport().
+ *
+ * NOTICE : the training runs on the calling thread, getNumThreads() is not used
+ * NOTICE : the layer in front of the loss layer has to have dataSource_.getNumOutputs() neurons,
+ *          otherwise the function stops and returns false
+ */
+bool ANN::trainLBFGS(DataSource& dataSource_, const SolverParameter& param_) {
+    int num = dataSource_.getNumSamples();
+    if (num == 0) {
+        cout << "Error : L-BFGS training needs a data source with a fixed number of samples" << endl;
+        return false;
+    }
+
+    Net<double> net_l(SolverNet::netParameter(param_,caffe::TRAIN));
+    if (getTrainedWeightsCaffemodelPath() != "") {
+        net_l.CopyTrainedLayersFrom(getTrainedWeightsCaffemodelPath());
+    }
+
+    // the net has to predict one value per output of the data source (see train)
+    Blob<double>* expectedOutputDataBLOB = net_l.input_blobs()[1];
+    for (unsigned int i = 0; i < net_l.layers().size(); i++) {
+        const vector<Blob<double>*>& bottoms = net_l.bottom_vecs()[i];
+        if (bottoms.size() == 2 && bottoms[1] == expectedOutputDataBLOB && bottoms[0]->count(1) != dataSource_.getNumOutputs()) {
+            cout << "Error : the net predicts " << bottoms[0]->count(1) << " values per sample, but the data source has "
+                 << dataSource_.getNumOutputs() << " outputs" << endl;
+            return false;
+        }
+    }
+
+    // all samples are loaded once, every evaluation uses the full batch
+    net_l.input_blobs()[0]->Reshape(vector<int>{num,dataSource_.getNumInputs(),1,1});
+    net_l.input_blobs()[1]->Reshape(vector<int>{num,dataSource_.getNumOutputs(),1,1});
+    net_l.Reshape();
+    fillTrainingBLOBs(dataSource_,net_l.input_blobs()[0],net_l.input_blobs()[1]);
+
+    // the learnable parameters of the net as one vector
+    const vector<Blob<double>*>& params = net_l.learnable_params();
+    vector<double> weights;
+    for (Blob<double>* blob : params) {
+        weights.insert(weights.end(),blob->cpu_data(),blob->cpu_data() + blob->count());
+    }
+
+    LBFGS::Objective objective = [&](const vector<double>& x_, vector<double>& gradient_) {
+        size_t offset = 0;
+        for (Blob<double>* blob : params) {
+            copy(x_.begin() + offset,x_.begin() + offset + blob->count(),blob->mutable_cpu_data());
+            offset += blob->count();
+        }
+        net_l.ClearParamDiffs();
+        double loss = net_l.ForwardBackward();
+
+        offset = 0;
+        for (unsigned int i = 0; i < params.size(); i++) {
+            double decay = param_.weight_decay() * net_l.params_weight_decay()[i];
+            const double* diff = params[i]->cpu_diff();
+            for (int j = 0; j < params[i]->count(); j++, offset++) {
+                gradient_[offset] = diff[j] + decay * x_[offset];
+                loss += 0.5 * decay * x_[offset] * x_[offset];
+            }
+        }
+        return loss;
+    };
+
+    LBFGS optimizer;
+    optimizer.setHistorySize(getLBFGSHistorySize());
+    optimizer.setMaxIterations(param_.max_iter());
+    if (!optimizer.minimize(weights,objective,lbfgsReport)) {
+        cout << "Error : the loss of the initial weights is not finite" << endl;
+        return false;
+    }
+    if (param_.display() > 0) {
+        lbfgsReport.print(cout);
+    }
+
+    // save trained weights (the last evaluation may have been a rejected trial step)
+    size_t offset = 0;
+    for (Blob<double>* blob : params) {
+        copy(weights.begin() + offset,weights.begin() + offset + blob->count(),blob->mutable_cpu_data());
+        offset += blob->count();
+    }
+    stringstream tempPath;
+    tempPath << param_.snapshot_prefix() << "_iter_" << lbfgsReport.numIterations << ".caffemodel";
+    NetParameter trainedWeights;
+    net_l.ToProto(&trainedWeights);
+    WriteProtoToBinaryFile(trainedWeights,tempPath.str());
+    setTrainedWeightsCaffemodelPath(tempPath.str());
+    // the file of the loaded net may have been overwritten (see train)
+    net.reset();
+    return saveNormalizers();
+}
+
+/**
+ * @brief ANN::trainInMemory trains the network with the samples of dataSource_, holding out validation samples if set
+ * @param dataSource_ in-memory samples, the validation samples are removed from it
+ * @return returns true if training has succesfully ended, otherwise false
+ *
+ * If a validation fraction is set (setValidationFraction), that share of the samples is moved
+ * into a validation data source (see InMemoryDataSource::holdOut) which is used for early
+ * stopping (see train(DataSource&, DataSource*)).
+ */
+bool ANN::trainInMemory(InMemoryDataSource& dataSource_) {
+    dataSource_.setShuffle(getShuffle());
+    if (getValidationFraction() <= 0) {
+        return train(dataSource_);
+    }
+
+    InMemoryDataSource validationDataSource = dataSource_.holdOut(getValidationFraction());
+    if (validationDataSource.getNumSamples() == 0) {
+        cout << "Error : too few samples to hold out validation samples" << endl;
+        return false;
+    }
+    return train(dataSource_,&validationDataSource);
+}
+
+/**
+ * @brief ANN::isInterrupted returns true if the time budget of the current training is used up or it has been cancelled
+ *
+ * NOTICE : it is called by the threads of asynchronous training, therefore it only reads
+ */
+bool ANN::isInterrupted() const {
+    return (getCancellationToken() != nullptr && getCancellationToken()->isCancelled()) ||
+           (getTimeBudget() > 0 && chrono::steady_clock::now() >= deadline);
+}
+
+/**
+ * @brief ANN::releaseSolver stops the worker threads of training and releases the solver
+ *
+ * The callbacks (data-parallel sync, distributed sync), the workers of asynchronous training and
+ * the validation net of early stopping are released before the solver, which keeps pointers to them.
+ */
+void ANN::releaseSolver() {
+    earlyStopping.reset();
+    distributedSync.reset();
+    parallelSync.reset();
+    asynchronousSGD.reset();
+    solver_.reset();
+}
+
+/**
+ * @brief ANN::fitNormalizers fits the normalizers of the inputs and outputs to the samples of dataSource_
+ *
+ * The samples are read in batches of 4096, the statistics are collected in one pass (see
+ * Normalizer::update). At most 2^20 samples are used, which gives accurate statistics while
+ * bounding the cost of the pass for big or unbounded data sources. Afterwards the source is
+ * rewound, therefore training starts with a complete epoch.
+ */
+void ANN::fitNormalizers(DataSource& dataSource_) {
+    inputNormalizer  = Normalizer(getNormalization());
+    outputNormalizer = Normalizer(getNormalization());
+
+    const unsigned long long maxSamples = 1 << 20;
+    unsigned long long numSamples = dataSource_.getNumSamples();
+    numSamples = (numSamples > 0) ? min(numSamples,maxSamples) : maxSamples;
+
+    const int batchSize_l = 4096;
+    vector<double> inputValues (batchSize_l * dataSource_.getNumInputs ());
+    vector<double> outputValues(batchSize_l * dataSource_.getNumOutputs());
+    for (unsigned long long first = 0; first < numSamples; first += batchSize_l) {
+        int num = (int)min<unsigned long long>(batchSize_l,numSamples - first);
+        dataSource_.nextBatch(num,inputValues.data(),outputValues.data());
+        inputNormalizer .update(inputValues .data(),num,dataSource_.getNumInputs ());
+        outputNormalizer.update(outputValues.data(),num,dataSource_.getNumOutputs());
+    }
+    dataSource_.rewind();
+}
+
+/**
+ * @brief ANN::loadNormalizers loads the normalizers saved next to getTrainedWeightsCaffemodelPath()
+ * @return returns true if normalizers have been loaded, otherwise false (both normalizers are reset)
+ */
+bool ANN::loadNormalizers() {
+    string normalizerPath = getTrainedWeightsCaffemodelPath() + ".normalizer";
+    ifstream iFile(normalizerPath);
+    if (getTrainedWeightsCaffemodelPath() == "" || !iFile.is_open() ||
+        !inputNormalizer.read(iFile) || !outputNormalizer.read(iFile)) {
+        inputNormalizer.reset();
+        outputNormalizer.reset();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief ANN::saveNormalizers saves the fitted normalizers next to getTrainedWeightsCaffemodelPath()
+ * @return returns false if the normalizers could not be written, otherwise true
+ */
+bool ANN::saveNormalizers() {
+    if (!inputNormalizer.isFitted()) {
+        return true;
+    }
+    string normalizerPath = getTrainedWeightsCaffemodelPath() + ".normalizer";
+    ofstream oFile(normalizerPath);
+    if (!inputNormalizer.write(oFile) || !outputNormalizer.write(oFile)) {
+        cout << "Error : could not write " << normalizerPath << endl;
+        return false;
+    }
+    return true;
 }
 
+/**
+ * @brief ANN::normalizeInputs normalizes num_ rows of numInputs_ input values in place
+ *
+ * NOTICE : nothing is changed if no normalizer for numInputs_ inputs is fitted
+ */
+void ANN::normalizeInputs(double* inputValues_, int num_, int numInputs_) {
+    if (inputNormalizer.isFitted() && inputNormalizer.getNumFeatures() == numInputs_) {
+        inputNormalizer.transform(inputValues_,num_);
+    }
+}
 
+/**
+ * @brief ANN::denormalizeOutputs maps num_ rows of numOutputs_ output values of the net back in place
+ *
+ * NOTICE : nothing is changed if no normalizer for numOutputs_ outputs is fitted
+ */
+void ANN::denormalizeOutputs(double* outputValues_, int num_, int numOutputs_) {
+    if (outputNormalizer.isFitted() && outputNormalizer.getNumFeatures() == numOutputs_) {
+        outputNormalizer.inverseTransform(outputValues_,num_);
+    }
+}
 
 /**
  * @brief ANN::setDataOfBLOB sets the data at the given indexes within the blobToModify_ to value_
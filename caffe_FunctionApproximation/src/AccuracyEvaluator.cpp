@@ -0,0 +1,280 @@
+#include "AccuracyEvaluator.h"
+
+// STL
+#include <thread>
+#include <atomic>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <memory>
+// own
+#include "QuasiRandomSampler.h"
+
+/* --- constructors / destructors --- */
+
+/**
+ * @brief AccuracyEvaluator::AccuracyEvaluator constructor of class AccuracyEvaluator
+ * @param mlp_               the net which is to evaluate
+ * @param referenceFunction_ the function the net approximates
+ *
+ * By default all available cores are used, the batch size is 4096 and the histogram
+ * divides [0, 1) into 20 buckets.
+ *
+ * NOTICE : mlp_ is not copied, therefore it has to outlive the evaluator
+ * NOTICE : referenceFunction_ is called by several threads at once, therefore it must not
+ *          modify shared state
+ */
+AccuracyEvaluator::AccuracyEvaluator(const MLP& mlp_, const function<vector<double>(const vector<double>&)>& referenceFunction_)
+    : mlp(mlp_), referenceFunction(referenceFunction_), numThreads(0), batchSize(4096),
+      numBuckets(20), histogramRange(1.0), seed(0) {
+}
+
+/* --- getter / setter --- */
+
+/**
+ * @brief AccuracyEvaluator::setHistogram sets the buckets of the error histogram
+ * @param numBuckets_     number of buckets of equal width within [0, histogramRange_)
+ * @param histogramRange_ upper bound of the last regular bucket
+ */
+void AccuracyEvaluator::setHistogram(int numBuckets_, double histogramRange_) {
+    numBuckets     = max(numBuckets_,1);
+    histogramRange = (histogramRange_ > 0) ? histogramRange_ : 1.0;
+}
+
+/* --- evaluation --- */
+
+/**
+ * @brief AccuracyEvaluator::evaluate measures the error of the net on numSamples_ samples of domain_
+ * @param domain_     box the samples are taken from
+ * @param numSamples_ number of samples, for GRID this is rounded down to the next k^dimension
+ * @param sampling_   how the samples are distributed within domain_
+ * @return returns the statistics of all errors, report.numSamples is the number of samples
+ *         actually evaluated
+ *
+ * The samples are enumerated by an index. Every thread repeatedly takes the next batch of
+ * indexes, generates the samples belonging to them, propagates the batch through the net and
+ * adds the errors to its own statistics. After all threads have finished, the statistics of
+ * the threads are summed up. Random samples are generated by one random generator per batch,
+ * therefore the result does not depend on the number of threads.
+ *
+ * NOTICE : the function prints an error and returns an empty report if a GRID gets less than
+ *          2^dimension samples or SOBOL gets more than 2^32 samples
+ */
+AccuracyEvaluator::Report AccuracyEvaluator::evaluate(const Domain& domain_, unsigned long long numSamples_, Sampling sampling_) {
+    Report report;
+    int numInputs  = mlp.getNumInputs();
+    int numOutputs = mlp.getNumOutputs();
+
+    if (domain_.dimension() != numInputs || numInputs == 0) {
+        cout << "Error : dimension of the domain does not fit to the number of inputs" << endl;
+        return report;
+    }
+
+    // number of grid points per dimension
+    unsigned long long pointsPerDimension = 0;
+    if (sampling_ == GRID) {
+        pointsPerDimension = (unsigned long long)floor(pow((double)numSamples_,1.0 / numInputs) + 1e-9);
+        // pow is inexact : reduce the points until pointsPerDimension^dimension neither exceeds numSamples_ nor overflows
+        unsigned long long numGridPoints = 0;
+        while (pointsPerDimension >= 2 && numGridPoints == 0) {
+            numGridPoints = 1;
+            for (int i = 0; i < numInputs; i++) {
+                if (numGridPoints > numSamples_ / pointsPerDimension) {
+                    numGridPoints = 0;
+                    pointsPerDimension--;
+                    break;
+                }
+                numGridPoints *= pointsPerDimension;
+            }
+        }
+        if (pointsPerDimension < 2) {
+            cout << "Error : a grid needs at least 2^dimension samples (the bounds of every dimension)" << endl;
+            return report;
+        }
+        numSamples_ = numGridPoints;
+    }
+
+    // low-discrepancy points
+    unique_ptr<QuasiRandomSampler> sampler;
+    if (sampling_ == SOBOL || sampling_ == HALTON) {
+        if (sampling_ == SOBOL && numSamples_ > (1ULL << 32)) {
+            cout << "Error : Sobol points are only available for indexes below 2^32" << endl;
+            return report;
+        }
+        sampler.reset(new QuasiRandomSampler(domain_,(sampling_ == SOBOL) ? QuasiRandomSampler::SOBOL : QuasiRandomSampler::HALTON,true,seed));
+        if (!sampler->isValid()) {
+            return report;
+        }
+    }
+
+    int numThreads_l = numThreads;
+    if (numThreads_l <= 0) {
+        numThreads_l = max(1u,thread::hardware_concurrency());
+    }
+
+    unsigned long long numBatches = (numSamples_ + batchSize - 1) / batchSize;
+    atomic<unsigned long long> nextBatch(0);
+
+    // statistics of every thread
+    struct Statistics {
+        unsigned long long         numErrors;
+        unsigned long long         numNonFiniteErrors;
+        long double                sumOfSquares;
+        long double                sumOfAbsolutes;
+        double                     maxError;
+        vector<double>             worstInput;
+        vector<unsigned long long> histogram;
+    };
+    vector<Statistics> statistics(numThreads_l);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    vector<thread> threads;
+    for (int t = 0; t < numThreads_l; t++) {
+        threads.push_back(thread([&,t] {
+            Statistics& own = statistics[t];
+            own.numErrors      = 0;
+            own.numNonFiniteErrors = 0;
+            own.sumOfSquares   = 0;
+            own.sumOfAbsolutes = 0;
+            own.maxError       = -1;
+            own.histogram.assign(numBuckets + 1,0);
+
+            vector<double> inputValues(batchSize * numInputs);
+            vector<double> outputValues(batchSize * numOutputs);
+            vector<double> sample(numInputs);
+
+            while (true) {
+                unsigned long long batch = nextBatch++;
+                if (batch >= numBatches) {
+                    break;
+                }
+                unsigned long long firstIndex = batch * batchSize;
+                int numSamplesInBatch = (int)min<unsigned long long>(batchSize,numSamples_ - firstIndex);
+
+                // generate the samples of this batch
+                mt19937_64 generator(seed ^ (batch * 0x9E3779B97F4A7C15ULL));
+                uniform_real_distribution<double> unit(0.0,1.0);
+                for (int s = 0; s < numSamplesInBatch; s++) {
+                    double* point = &inputValues[s * numInputs];
+                    if (sampling_ == GRID) {
+                        // the last dimension changes fastest (like the nested loops in main.cpp)
+                        unsigned long long index = firstIndex + s;
+                        for (int i = numInputs - 1; i >= 0; i--) {
+                            unsigned long long gridIndex = index % pointsPerDimension;
+                            index /= pointsPerDimension;
+                            point[i] = domain_.lowerBounds[i] + domain_.width(i) * double(gridIndex) / double(pointsPerDimension - 1);
+                        }
+                    } else if (sampling_ == UNIFORM_RANDOM) {
+                        for (int i = 0; i < numInputs; i++) {
+                            point[i] = domain_.lowerBounds[i] + domain_.width(i) * unit(generator);
+                        }
+                    } else {
+                        sampler->point(firstIndex + s,point);
+                    }
+                }
+
+                mlp.forward(inputValues.data(),numSamplesInBatch,outputValues.data());
+
+                // compare with reference function
+                double sumOfSquares   = 0;
+                double sumOfAbsolutes = 0;
+                for (int s = 0; s < numSamplesInBatch; s++) {
+                    sample.assign(&inputValues[s * numInputs],&inputValues[(s + 1) * numInputs]);
+                    vector<double> expected = referenceFunction(sample);
+                    for (int o = 0; o < numOutputs && o < (int)expected.size(); o++) {
+                        double error = fabs(outputValues[s * numOutputs + o] - expected[o]);
+                        own.numErrors++;
+                        if (isfinite(error)) {
+                            sumOfSquares   += error * error;
+                            sumOfAbsolutes += error;
+                        } else {
+                            // NaN or infinite outputs are worse than every finite error
+                            error = numeric_limits<double>::infinity();
+                            own.numNonFiniteErrors++;
+                        }
+                        if (error > own.maxError) {
+                            own.maxError   = error;
+                            own.worstInput = sample;
+                        }
+                        int bucket = (error < histogramRange) ? int(error / histogramRange * numBuckets) : numBuckets;
+                        own.histogram[min(bucket,numBuckets)]++;
+                    }
+                }
+                own.sumOfSquares   += sumOfSquares;
+                own.sumOfAbsolutes += sumOfAbsolutes;
+            }
+        }));
+    }
+    for (unsigned int t = 0; t < threads.size(); t++) {
+        threads[t].join();
+    }
+
+    // reduce statistics of all threads
+    long double sumOfSquares   = 0;
+    long double sumOfAbsolutes = 0;
+    report.numSamples     = numSamples_;
+    report.histogramRange = histogramRange;
+    report.histogram.assign(numBuckets + 1,0);
+    for (unsigned int t = 0; t < statistics.size(); t++) {
+        report.numErrors += statistics[t].numErrors;
+        report.numNonFiniteErrors += statistics[t].numNonFiniteErrors;
+        sumOfSquares     += statistics[t].sumOfSquares;
+        sumOfAbsolutes   += statistics[t].sumOfAbsolutes;
+        if (statistics[t].maxError > report.maxError || report.worstInput.empty()) {
+            if (!statistics[t].worstInput.empty()) {
+                report.maxError   = statistics[t].maxError;
+                report.worstInput = statistics[t].worstInput;
+            }
+        }
+        for (int b = 0; b <= numBuckets; b++) {
+            report.histogram[b] += statistics[t].histogram[b];
+        }
+    }
+    unsigned long long numFiniteErrors = report.numErrors - report.numNonFiniteErrors;
+    if (numFiniteErrors > 0) {
+        report.rootMeanSquareError = sqrt(double(sumOfSquares / numFiniteErrors));
+        report.meanAbsoluteError   = double(sumOfAbsolutes / numFiniteErrors);
+    }
+    report.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    return report;
+}
+
+/**
+ * @brief AccuracyEvaluator::Report::print writes a compact summary of the report to oStream_
+ */
+void AccuracyEvaluator::Report::print(ostream& oStream_) const {
+    oStream_ << "samples             : " << numSamples << endl;
+    oStream_ << "rms error           : " << rootMeanSquareError << endl;
+    oStream_ << "mean absolute error : " << meanAbsoluteError << endl;
+    if (numNonFiniteErrors > 0) {
+        oStream_ << "non-finite errors   : " << numNonFiniteErrors << " (not in the rms and mean errors)" << endl;
+    }
+    oStream_ << "max error           : " << maxError << " at (";
+    for (unsigned int i = 0; i < worstInput.size(); i++) {
+        oStream_ << worstInput[i] << ((i + 1 < worstInput.size()) ? ", " : "");
+    }
+    oStream_ << ")" << endl;
+
+    oStream_ << "error histogram     :" << endl;
+    int numBuckets = (int)histogram.size() - 1;
+    for (int b = 0; b <= numBuckets; b++) {
+        double percentage = (numErrors > 0) ? 100.0 * double(histogram[b]) / double(numErrors) : 0.0;
+        oStream_ << "  [" << histogramRange * b / numBuckets << ", ";
+        if (b < numBuckets) {
+            oStream_ << histogramRange * (b + 1) / numBuckets << ")";
+        } else {
+            oStream_ << "inf)";
+        }
+        oStream_ << " : " << histogram[b] << " (" << percentage << " %)" << endl;
+    }
+
+    oStream_ << "time                : " << seconds << " s";
+    if (seconds > 0) {
+        oStream_ << " (" << double(numSamples) / seconds << " samples/s)";
+    }
+    oStream_ << endl;
+}
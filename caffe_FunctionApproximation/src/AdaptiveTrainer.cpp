@@ -0,0 +1,154 @@
+#include "AdaptiveTrainer.h"
+
+// STL
+#include <cmath>
+#include <numeric>
+#include <algorithm>
+// own
+#include "QuasiRandomSampler.h"
+
+/* --- constructors / destructors --- */
+
+/**
+ * @brief AdaptiveTrainer::AdaptiveTrainer constructor of class AdaptiveTrainer
+ * @param ann_            the net which is to train
+ * @param domain_         box the samples are taken from
+ * @param targetFunction_ function which is to approximate
+ *
+ * By default training starts with 256 samples, adds 128 samples per round chosen from
+ * 4096 candidates, trains 1000 iterations per round for at most 20 rounds, has no sample
+ * budget and aims at a maximum error of 0.01.
+ */
+AdaptiveTrainer::AdaptiveTrainer(ANN& ann_, const Domain& domain_, const function<double(const vector<double>&)>& targetFunction_)
+    : ann(ann_), domain(domain_), targetFunction(targetFunction_), initialSamples(256), samplesPerRound(128),
+      candidatePoolSize(4096), iterationsPerRound(1000), maxRounds(20), maxSamples(0), targetMaxError(0.01), seed(0) {
+}
+
+/* --- training --- */
+
+/**
+ * @brief AdaptiveTrainer::train trains the ANN round by round and refines the training set between the rounds
+ * @param report_ number of rounds, iterations and samples and the error reached
+ * @return returns true if all rounds have been trained, otherwise false
+ *
+ * The candidate pool of every round consists of new scrambled low-discrepancy points, therefore
+ * the error is never measured on the points the net has been trained on.
+ */
+bool AdaptiveTrainer::train(Report& report_) {
+    report_ = Report();
+    if (ann.getSolverParametersPrototxtPath() == "") {
+        cout << "Error : adaptive training needs a solver prototxt" << endl;
+        return false;
+    }
+
+    QuasiRandomSampler::Sequence sequence = (domain.dimension() <= QuasiRandomSampler::getMaxSobolDimension())
+                                            ? QuasiRandomSampler::SOBOL : QuasiRandomSampler::HALTON;
+    QuasiRandomSampler initialSampler(domain,sequence);
+    initialSampler.sample(initialSamples,targetFunction,inputValues,expectedOutputValues);
+
+    int maxIterations_l = ann.getMaxIterations();
+    ann.setMaxIterations(iterationsPerRound);
+
+    bool result = true;
+    for (int round = 0; round < maxRounds; round++) {
+        if (!ann.train(inputValues,expectedOutputValues)) {
+            result = false;
+            break;
+        }
+        report_.numRounds++;
+        report_.numIterations += iterationsPerRound;
+
+        // --- residuals on a fresh candidate pool ---
+        QuasiRandomSampler candidateSampler(domain,sequence,true,seed + round);
+        vector<vector<double>> candidates;
+        vector<double>         expectedCandidateValues;
+        candidateSampler.sample(candidatePoolSize,targetFunction,candidates,expectedCandidateValues);
+        vector<double> candidateResiduals = residuals(candidates,expectedCandidateValues);
+
+        double sumOfSquares = 0;
+        report_.maxError    = 0;
+        for (unsigned int i = 0; i < candidateResiduals.size(); i++) {
+            sumOfSquares    += candidateResiduals[i] * candidateResiduals[i];
+            report_.maxError = max(report_.maxError,candidateResiduals[i]);
+        }
+        report_.rootMeanSquareError = sqrt(sumOfSquares / max<size_t>(candidateResiduals.size(),1));
+        report_.maxErrors.push_back(report_.maxError);
+
+        if (report_.maxError <= targetMaxError) {
+            report_.converged = true;
+            break;
+        }
+        if (round == maxRounds - 1) {
+            break;
+        }
+
+        // --- refine the training set by the candidates with the largest residuals ---
+        vector<int> candidateOrder(candidates.size());
+        iota(candidateOrder.begin(),candidateOrder.end(),0);
+        int numNewSamples = min<int>(samplesPerRound,candidateOrder.size());
+        partial_sort(candidateOrder.begin(),candidateOrder.begin() + numNewSamples,candidateOrder.end(),
+                     [&candidateResiduals](int a_, int b_) { return candidateResiduals[a_] > candidateResiduals[b_]; });
+
+        int numAdded = numNewSamples;
+        if (maxSamples > 0) {
+            numAdded = max(0,min<int>(numNewSamples,maxSamples - (int)inputValues.size()));
+        }
+        for (int i = 0; i < numAdded; i++) {
+            inputValues.push_back(candidates[candidateOrder[i]]);
+            expectedOutputValues.push_back(expectedCandidateValues[candidateOrder[i]]);
+        }
+
+        // budget exhausted : the remaining candidates replace the easiest training samples
+        if (numAdded < numNewSamples) {
+            vector<double> trainingResiduals = residuals(inputValues,expectedOutputValues);
+            vector<int> trainingOrder(inputValues.size());
+            iota(trainingOrder.begin(),trainingOrder.end(),0);
+            sort(trainingOrder.begin(),trainingOrder.end(),
+                 [&trainingResiduals](int a_, int b_) { return trainingResiduals[a_] < trainingResiduals[b_]; });
+
+            for (int i = numAdded, j = 0; i < numNewSamples && j < (int)trainingOrder.size(); i++, j++) {
+                int candidate = candidateOrder[i];
+                int sample    = trainingOrder[j];
+                if (trainingResiduals[sample] >= candidateResiduals[candidate]) {
+                    break;
+                }
+                inputValues[sample]          = candidates[candidate];
+                expectedOutputValues[sample] = expectedCandidateValues[candidate];
+            }
+        }
+    }
+    report_.numSamples = inputValues.size();
+
+    ann.setMaxIterations(maxIterations_l);
+    return result;
+}
+
+/**
+ * @brief AdaptiveTrainer::Report::print writes a compact summary of the report to oStream_
+ */
+void AdaptiveTrainer::Report::print(ostream& oStream_) const {
+    oStream_ << "rounds     : " << numRounds     << endl;
+    oStream_ << "iterations : " << numIterations << endl;
+    oStream_ << "samples    : " << numSamples    << endl;
+    oStream_ << "max error  : " << maxError      << (converged ? " (target reached)" : " (target not reached)") << endl;
+    oStream_ << "rms error  : " << rootMeanSquareError << endl;
+    oStream_ << "max error per round :";
+    for (unsigned int i = 0; i < maxErrors.size(); i++) {
+        oStream_ << " " << maxErrors[i];
+    }
+    oStream_ << endl;
+}
+
+/* --- miscellaneous --- */
+
+/**
+ * @brief AdaptiveTrainer::residuals calculates |ann(x) - target(x)| for all given samples
+ */
+vector<double> AdaptiveTrainer::residuals(const vector<vector<double>>& inputValues_, const vector<double>& expectedOutputValues_) {
+    vector<vector<double>> outputValues = ann.forward(inputValues_);
+    vector<double> result(inputValues_.size());
+    for (unsigned int i = 0; i < inputValues_.size(); i++) {
+        result[i] = fabs(outputValues[i][0] - expectedOutputValues_[i]);
+    }
+    return result;
+}
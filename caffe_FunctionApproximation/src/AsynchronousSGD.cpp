@@ -0,0 +1,180 @@
+#include "AsynchronousSGD.h"
+
+// STL
+#include <algorithm>
+#include <chrono>
+
+/* --- constructors / destructors --- */
+
+/**
+ * @brief AsynchronousSGD::AsynchronousSGD creates numWorkers_ - 1 solvers, whose nets share the weights of the net of solver_
+ * @param solver_     solver of worker 0, the parameters of the other solvers are copied from it
+ * @param numWorkers_ number of workers including solver_
+ *
+ * NOTICE : the instance has to exist as long as solver_ is used, as solver_ keeps a pointer
+ *          to the monitor of worker 0
+ */
+AsynchronousSGD::AsynchronousSGD(Solver<double>* solver_, int numWorkers_)
+    : solver(solver_), numWorkers(max(numWorkers_,1)), updates(0), claimed(0) {
+    // the other workers only train, tests and snapshots are done by worker 0
+    SolverParameter workerParam;
+    workerParam.CopyFrom(solver->param());
+    workerParam.clear_test_iter();
+    workerParam.clear_test_interval();
+    workerParam.set_snapshot(0);
+    workerParam.set_display(0);
+
+    workerSolvers.push_back(caffe::shared_ptr<Solver<double> >(solver,[](Solver<double>*) {}));
+    for (int w = 1; w < numWorkers; w++) {
+        caffe::shared_ptr<Solver<double> > workerSolver(SolverRegistry<double>::CreateSolver(workerParam));
+        workerSolver->net()->ShareTrainedLayersWith(solver->net().get());
+        workerSolvers.push_back(workerSolver);
+    }
+    for (int w = 0; w < numWorkers; w++) {
+        monitors.push_back(caffe::shared_ptr<Monitor>(new Monitor(*this,workerSolvers[w].get())));
+        workerSolvers[w]->add_callback(monitors[w].get());
+    }
+}
+
+/**
+ * @brief AsynchronousSGD::Monitor::Monitor constructor of the monitor of the iterations of solver_
+ */
+AsynchronousSGD::Monitor::Monitor(AsynchronousSGD& owner_, Solver<double>* solver_)
+    : numUpdates(0), sumStaleness(0), maxStaleness(0), loss(0), owner(owner_), solver(solver_), startUpdates(0) {
+}
+
+/* --- getter / setter --- */
+
+/**
+ * @brief AsynchronousSGD::getReplica returns the net of worker worker_ (0 : the net of the solver)
+ */
+Net<double>* AsynchronousSGD::getReplica(int worker_) {
+    return workerSolvers[worker_]->net().get();
+}
+
+/* --- training --- */
+
+/**
+ * @brief AsynchronousSGD::run trains until the workers have updated the weights numUpdates_ times
+ * @param numUpdates_ number of iterations of all workers together
+ * @param loadBatch_  loads the next batch into the input BLOBs of the given net before every
+ *                    iteration, it is called by one worker at a time (empty : the BLOBs keep their values)
+ * @param stop_       is called by every worker before every iteration, the workers stop as soon as it
+ *                    returns true (empty : no stop), it has to be thread-safe
+ * @return returns the report of the training
+ *
+ * Every worker claims the next iteration before it starts, therefore fast workers do more
+ * iterations than slow ones and the weights are updated exactly numUpdates_ times, unless the
+ * training is stopped by stop_ (see Report::numUpdates).
+ */
+AsynchronousSGD::Report AsynchronousSGD::run(long numUpdates_, const function<void(Net<double>*)>& loadBatch_,
+                                             const function<bool()>& stop_) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    updates.store(0);
+    claimed.store(0);
+    for (const caffe::shared_ptr<Monitor>& monitor : monitors) {
+        monitor->numUpdates   = 0;
+        monitor->sumStaleness = 0;
+        monitor->maxStaleness = 0;
+    }
+
+    // the batches are loaded one at a time, as data sources are not thread-safe
+    mutex loadMutex;
+    function<void(Net<double>*)> loadBatch;
+    if (loadBatch_) {
+        loadBatch = [&loadMutex, &loadBatch_](Net<double>* net_) {
+            lock_guard<mutex> lock(loadMutex);
+            loadBatch_(net_);
+        };
+    }
+
+    // caffe keeps the mode per thread
+    Caffe::Brew mode = Caffe::mode();
+    vector<thread> workers;
+    for (int w = 1; w < numWorkers; w++) {
+        workers.emplace_back([this, w, mode, numUpdates_, &loadBatch, &stop_]() {
+            Caffe::set_mode(mode);
+            work(w,numUpdates_,loadBatch,stop_);
+        });
+    }
+    work(0,numUpdates_,loadBatch,stop_);
+    for (thread& worker : workers) {
+        worker.join();
+    }
+
+    Report report;
+    report.numWorkers       = numWorkers;
+    report.numUpdates       = updates.load();
+    report.seconds          = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    report.updatesPerSecond = report.seconds > 0 ? report.numUpdates / report.seconds : 0;
+    long sumStaleness = 0;
+    for (const caffe::shared_ptr<Monitor>& monitor : monitors) {
+        sumStaleness        += monitor->sumStaleness;
+        report.maxStaleness  = max(report.maxStaleness,monitor->maxStaleness);
+        report.loss         += monitor->loss / numWorkers;
+    }
+    report.meanStaleness = report.numUpdates > 0 ? double(sumStaleness) / report.numUpdates : 0;
+    return report;
+}
+
+/**
+ * @brief AsynchronousSGD::Report::print writes a compact summary of the report to oStream_
+ */
+void AsynchronousSGD::Report::print(ostream& oStream_) const {
+    oStream_ << "workers         : " << numWorkers       << endl;
+    oStream_ << "updates         : " << numUpdates       << endl;
+    oStream_ << "seconds         : " << seconds          << endl;
+    oStream_ << "updates / s     : " << updatesPerSecond << endl;
+    oStream_ << "mean staleness  : " << meanStaleness    << endl;
+    oStream_ << "max staleness   : " << maxStaleness     << endl;
+    oStream_ << "loss            : " << loss             << endl;
+}
+
+/* --- solver callbacks --- */
+
+/**
+ * @brief AsynchronousSGD::Monitor::on_start remembers the number of updates before the weights are read
+ */
+void AsynchronousSGD::Monitor::on_start() {
+    startUpdates = owner.updates.load(memory_order_relaxed);
+}
+
+/**
+ * @brief AsynchronousSGD::Monitor::on_gradients_ready measures the staleness and the loss of the iteration
+ *
+ * The update is counted before it is applied by the solver.
+ */
+void AsynchronousSGD::Monitor::on_gradients_ready() {
+    long staleness = owner.updates.fetch_add(1,memory_order_relaxed) - startUpdates;
+    sumStaleness += staleness;
+    maxStaleness  = max(maxStaleness,staleness);
+
+    // moving average of the loss, as the loss of one batch is noisy
+    const vector<Blob<double>*>& outputs = solver->net()->output_blobs();
+    if (!outputs.empty()) {
+        double currentLoss = outputs[0]->cpu_data()[0];
+        loss = numUpdates == 0 ? currentLoss : 0.99 * loss + 0.01 * currentLoss;
+    }
+    numUpdates++;
+
+    int display = owner.solver->param().display();
+    if (solver == owner.solver && display > 0 && numUpdates % display == 0) {
+        cout << "asynchronous SGD : " << owner.updates.load(memory_order_relaxed) << " updates, loss " << loss
+             << ", mean staleness " << double(sumStaleness) / numUpdates << endl;
+    }
+}
+
+/* --- miscellaneous --- */
+
+/**
+ * @brief AsynchronousSGD::work runs the iterations of worker worker_ until numUpdates_ iterations have been claimed or stop_ returns true
+ */
+void AsynchronousSGD::work(int worker_, long numUpdates_, const function<void(Net<double>*)>& loadBatch_, const function<bool()>& stop_) {
+    Solver<double>* workerSolver = workerSolvers[worker_].get();
+    while (!(stop_ && stop_()) && claimed.fetch_add(1,memory_order_relaxed) < numUpdates_) {
+        if (loadBatch_) {
+            loadBatch_(workerSolver->net().get());
+        }
+        workerSolver->Step(1);
+    }
+}
@@ -0,0 +1,458 @@
+#include "ColumnarDataSet.h"
+
+// STL
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+// POSIX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+// own
+#include "CsvIO.h"
+
+namespace {
+
+const char     magicNumber[8] = {'F','A','D','A','T','A','0','1'};
+const uint32_t formatVersion  = 1;
+
+struct FileHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t numColumns;
+    uint64_t numRows;
+    uint32_t numInputs;
+    uint32_t reserved0;
+    uint64_t reserved[4];
+};
+
+struct ColumnHeader {
+    char     name[48];
+    uint64_t offset;
+    double   minimum;
+    double   maximum;
+    double   mean;
+    double   standardDeviation;
+    uint64_t reserved;
+};
+
+static_assert(sizeof(FileHeader)   == 64, "unexpected size of the file header");
+static_assert(sizeof(ColumnHeader) == 96, "unexpected size of the column header");
+
+size_t alignUp(size_t value_, size_t alignment_) {
+    return (value_ + alignment_ - 1) / alignment_ * alignment_;
+}
+
+/**
+ * statistics of one column, updated value by value by Welford's algorithm
+ */
+struct ColumnStatistics {
+    size_t count;
+    double mean;
+    double sumOfSquaredDeviations;
+    double minimum;
+    double maximum;
+
+    ColumnStatistics() : count(0), mean(0), sumOfSquaredDeviations(0), minimum(0), maximum(0) {};
+
+    void add(double value_) {
+        if (count == 0) {
+            minimum = value_;
+            maximum = value_;
+        }
+        count++;
+        double delta = value_ - mean;
+        mean += delta / count;
+        sumOfSquaredDeviations += delta * (value_ - mean);
+        minimum = min(minimum,value_);
+        maximum = max(maximum,value_);
+    }
+};
+
+/**
+ * writes the file header and the column headers of numRows_ rows and pads the file up to the first column
+ * returns the offsets of the columns within the file
+ */
+vector<size_t> writeHeaders(ofstream& oFile_, const vector<string>& columnNames_, int numInputs_, size_t numRows_,
+                            const vector<ColumnStatistics>& statistics_) {
+    FileHeader fileHeader;
+    memset(&fileHeader,0,sizeof(FileHeader));
+    memcpy(fileHeader.magic,magicNumber,sizeof(magicNumber));
+    fileHeader.version    = formatVersion;
+    fileHeader.numColumns = statistics_.size();
+    fileHeader.numRows    = numRows_;
+    fileHeader.numInputs  = numInputs_;
+    oFile_.write(reinterpret_cast<const char*>(&fileHeader),sizeof(FileHeader));
+
+    size_t headerSize = sizeof(FileHeader) + statistics_.size() * sizeof(ColumnHeader);
+    vector<size_t> offsets(statistics_.size());
+    size_t offset = alignUp(headerSize,ColumnarDataSet::getAlignment());
+    for (unsigned int i = 0; i < statistics_.size(); i++) {
+        ColumnHeader columnHeader;
+        memset(&columnHeader,0,sizeof(ColumnHeader));
+        if (i < columnNames_.size()) {
+            strncpy(columnHeader.name,columnNames_[i].c_str(),sizeof(columnHeader.name) - 1);
+        }
+        offsets[i] = offset;
+        columnHeader.offset            = offset;
+        columnHeader.minimum           = statistics_[i].minimum;
+        columnHeader.maximum           = statistics_[i].maximum;
+        columnHeader.mean              = statistics_[i].mean;
+        columnHeader.standardDeviation = (numRows_ > 1) ? sqrt(statistics_[i].sumOfSquaredDeviations / (numRows_ - 1)) : 0.0;
+        oFile_.write(reinterpret_cast<const char*>(&columnHeader),sizeof(ColumnHeader));
+        offset = alignUp(offset + numRows_ * sizeof(double),ColumnarDataSet::getAlignment());
+    }
+
+    // the columns are written behind the padding, the gaps between them are filled by the file system
+    vector<char> padding(alignUp(headerSize,ColumnarDataSet::getAlignment()) - headerSize,0);
+    oFile_.write(padding.data(),padding.size());
+    return offsets;
+}
+
+}
+
+/* --- constructors / destructors --- */
+
+/**
+ * @brief ColumnarDataSet::ColumnarDataSet constructor of class ColumnarDataSet, creates a closed data set
+ */
+ColumnarDataSet::ColumnarDataSet()
+    : mapped(nullptr), mappedSize(0), numRows(0), numInputs(0) {
+}
+
+/**
+ * @brief ColumnarDataSet::~ColumnarDataSet unmaps the file
+ */
+ColumnarDataSet::~ColumnarDataSet() {
+    close();
+}
+
+/* --- opening / closing --- */
+
+/**
+ * @brief ColumnarDataSet::open maps a data set file with header into memory
+ * @param path_ path of the data set
+ * @return returns true if the file is a valid data set, otherwise false
+ */
+bool ColumnarDataSet::open(const string& path_) {
+    if (!map(path_)) {
+        return false;
+    }
+
+    FileHeader fileHeader;
+    if (mappedSize < sizeof(FileHeader)) {
+        cout << "Error : " << path_ << " is no data set" << endl;
+        close();
+        return false;
+    }
+    memcpy(&fileHeader,mapped,sizeof(FileHeader));
+    if (memcmp(fileHeader.magic,magicNumber,sizeof(magicNumber)) != 0 || fileHeader.version != formatVersion ||
+        fileHeader.numInputs > fileHeader.numColumns ||
+        mappedSize < sizeof(FileHeader) + fileHeader.numColumns * sizeof(ColumnHeader)) {
+        cout << "Error : " << path_ << " is no data set of version " << formatVersion << endl;
+        close();
+        return false;
+    }
+
+    numRows   = fileHeader.numRows;
+    numInputs = fileHeader.numInputs;
+    columns.resize(fileHeader.numColumns);
+    columnData.resize(fileHeader.numColumns);
+    for (uint32_t i = 0; i < fileHeader.numColumns; i++) {
+        ColumnHeader columnHeader;
+        memcpy(&columnHeader,mapped + sizeof(FileHeader) + i * sizeof(ColumnHeader),sizeof(ColumnHeader));
+        // numRows comes from the file, numRows * sizeof(double) may overflow
+        if (columnHeader.offset % sizeof(double) != 0 || columnHeader.offset > mappedSize ||
+            numRows > (mappedSize - columnHeader.offset) / sizeof(double)) {
+            cout << "Error : column " << i << " of " << path_ << " exceeds the file" << endl;
+            close();
+            return false;
+        }
+        columns[i].name              = string(columnHeader.name,strnlen(columnHeader.name,sizeof(columnHeader.name)));
+        columns[i].minimum           = columnHeader.minimum;
+        columns[i].maximum           = columnHeader.maximum;
+        columns[i].mean              = columnHeader.mean;
+        columns[i].standardDeviation = columnHeader.standardDeviation;
+        columnData[i] = reinterpret_cast<const double*>(mapped + columnHeader.offset);
+    }
+    return true;
+}
+
+/**
+ * @brief ColumnarDataSet::openRaw maps a headerless columnar file (StreamingEvaluator::RAW_BINARY) into memory
+ * @param path_       path of the file
+ * @param numInputs_  number of input columns
+ * @param numOutputs_ number of expected output columns
+ * @return returns true if the size of the file fits to the number of columns, otherwise false
+ */
+bool ColumnarDataSet::openRaw(const string& path_, int numInputs_, int numOutputs_) {
+    if (!map(path_)) {
+        return false;
+    }
+
+    int    numColumns = numInputs_ + numOutputs_;
+    size_t rowSize    = sizeof(double) * numColumns;
+    if ((numColumns <= 0) || (mappedSize % rowSize != 0)) {
+        cout << "Error : size of " << path_ << " does not fit to " << numColumns << " columns" << endl;
+        close();
+        return false;
+    }
+
+    numRows   = mappedSize / rowSize;
+    numInputs = numInputs_;
+    columns.assign(numColumns,Column());
+    columnData.resize(numColumns);
+    for (int i = 0; i < numColumns; i++) {
+        columnData[i] = reinterpret_cast<const double*>(mapped) + i * numRows;
+    }
+    return true;
+}
+
+/**
+ * @brief ColumnarDataSet::close unmaps the file
+ */
+void ColumnarDataSet::close() {
+    if (mapped != nullptr) {
+        munmap(const_cast<char*>(mapped),mappedSize);
+    }
+    mapped     = nullptr;
+    mappedSize = 0;
+    numRows    = 0;
+    numInputs  = 0;
+    columns.clear();
+    columnData.clear();
+}
+
+/* --- access to the pages of the file --- */
+
+/**
+ * @brief ColumnarDataSet::advise passes advice_ for the rows firstRow_ ... firstRow_ + numRows_ - 1 of every column to the kernel
+ * @param firstRow_ first row
+ * @param numRows_  number of rows
+ * @param advice_   advice for madvise (e.g. MADV_WILLNEED or MADV_DONTNEED)
+ */
+void ColumnarDataSet::advise(size_t firstRow_, size_t numRows_, int advice_) const {
+    size_t pageSize = sysconf(_SC_PAGESIZE);
+    for (unsigned int i = 0; i < columnData.size(); i++) {
+        size_t begin = reinterpret_cast<const char*>(columnData[i] + firstRow_) - mapped;
+        size_t end   = begin + numRows_ * sizeof(double);
+        // madvise needs page aligned addresses
+        begin -= begin % pageSize;
+        madvise(const_cast<char*>(mapped) + begin,end - begin,advice_);
+    }
+}
+
+/* --- writing / converting --- */
+
+/**
+ * @brief ColumnarDataSet::write writes a data set file
+ * @param path_        path of the data set
+ * @param columnNames_ names of the columns (at most 47 characters are kept), may be empty
+ * @param numInputs_   number of input columns, the remaining columns are expected output values
+ * @param columns_     values of every column
+ * @return returns true if the file has been written, otherwise false
+ *
+ * The statistics of every column are calculated in one pass by Welford's algorithm, the columns
+ * are written from columns_ without any copy.
+ *
+ * NOTICE : all columns have to have the same length
+ */
+bool ColumnarDataSet::write(const string& path_, const vector<string>& columnNames_, int numInputs_,
+                            const vector<vector<double>>& columns_) {
+    size_t numRows_l = columns_.empty() ? 0 : columns_[0].size();
+    for (unsigned int i = 0; i < columns_.size(); i++) {
+        if (columns_[i].size() != numRows_l) {
+            cout << "Error : the columns of the data set have different lengths" << endl;
+            return false;
+        }
+    }
+    if (numInputs_ < 0 || numInputs_ > (int)columns_.size()) {
+        cout << "Error : the data set has less than " << numInputs_ << " columns" << endl;
+        return false;
+    }
+
+    ofstream oFile(path_,ios::binary);
+    if (!oFile.is_open()) {
+        cout << "Error : could not open " << path_ << endl;
+        return false;
+    }
+
+    vector<ColumnStatistics> statistics(columns_.size());
+    for (unsigned int i = 0; i < columns_.size(); i++) {
+        for (size_t r = 0; r < numRows_l; r++) {
+            statistics[i].add(columns_[i][r]);
+        }
+    }
+    vector<size_t> offsets = writeHeaders(oFile,columnNames_,numInputs_,numRows_l,statistics);
+    for (unsigned int i = 0; i < columns_.size(); i++) {
+        oFile.seekp(offsets[i]);
+        oFile.write(reinterpret_cast<const char*>(columns_[i].data()),numRows_l * sizeof(double));
+    }
+
+    if (!oFile) {
+        cout << "Error : could not write " << path_ << endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief ColumnarDataSet::convertFromCSV converts a csv-file into a data set file
+ * @param csvPath_   path of the csv-file, one row per line, an optional non-numeric first line holds the column names
+ * @param path_      path of the data set
+ * @param numInputs_ number of input columns, the remaining columns are expected output values
+ * @return returns true if the data set has been written, otherwise false
+ *
+ * The csv-file is read twice block by block (see CsvReader::readBlocks) :
+ *   1. the rows are counted and the statistics of the columns are calculated, which gives the
+ *      headers and the offsets of all columns
+ *   2. every block is split into its columns, which are written at their offsets
+ * therefore only one block of rows is held in memory, independent of the size of the file.
+ */
+bool ColumnarDataSet::convertFromCSV(const string& csvPath_, const string& path_, int numInputs_) {
+    const size_t rowsPerBlock = 1 << 16;
+
+    // 1. pass : number of rows and statistics of the columns
+    CsvReader reader;
+    vector<ColumnStatistics> statistics;
+    size_t numRows_l = 0;
+    bool read = reader.readBlocks(csvPath_,rowsPerBlock,[&](const double* values_, size_t numRows_) {
+        int numColumns = reader.getNumColumns();
+        statistics.resize(numColumns);
+        for (size_t r = 0; r < numRows_; r++) {
+            for (int i = 0; i < numColumns; i++) {
+                statistics[i].add(values_[r * numColumns + i]);
+            }
+        }
+        numRows_l += numRows_;
+        return true;
+    });
+    if (!read) {
+        return false;
+    }
+    int numColumns = reader.getNumColumns();
+    statistics.resize(numColumns);
+    if (numInputs_ < 0 || numInputs_ > numColumns) {
+        cout << "Error : the data set has less than " << numInputs_ << " columns" << endl;
+        return false;
+    }
+
+    ofstream oFile(path_,ios::binary);
+    if (!oFile.is_open()) {
+        cout << "Error : could not open " << path_ << endl;
+        return false;
+    }
+    vector<size_t> offsets = writeHeaders(oFile,reader.getColumnNames(),numInputs_,numRows_l,statistics);
+
+    // 2. pass : the part of every column which belongs to the block
+    vector<double> column;
+    size_t firstRow = 0;
+    read = reader.readBlocks(csvPath_,rowsPerBlock,[&](const double* values_, size_t numRows_) {
+        // the file has changed since the first pass
+        if (reader.getNumColumns() != numColumns || firstRow + numRows_ > numRows_l) {
+            return false;
+        }
+        column.resize(numRows_);
+        for (int i = 0; i < numColumns; i++) {
+            for (size_t r = 0; r < numRows_; r++) {
+                column[r] = values_[r * numColumns + i];
+            }
+            oFile.seekp(offsets[i] + firstRow * sizeof(double));
+            oFile.write(reinterpret_cast<const char*>(column.data()),numRows_ * sizeof(double));
+        }
+        firstRow += numRows_;
+        return oFile.good();
+    });
+
+    if (!read || firstRow != numRows_l || !oFile) {
+        cout << "Error : could not write " << path_ << endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief ColumnarDataSet::convertToCSV converts a data set file into a csv-file
+ * @param path_    path of the data set
+ * @param csvPath_ path of the csv-file, the first line holds the column names
+ * @return returns true if the csv-file has been written, otherwise false
+ *
+ * Every value is written with the fewest digits which are read back exactly (see CsvWriter).
+ */
+bool ColumnarDataSet::convertToCSV(const string& path_, const string& csvPath_) {
+    ColumnarDataSet dataSet;
+    if (!dataSet.open(path_)) {
+        return false;
+    }
+    CsvWriter writer(csvPath_);
+    if (!writer.isOpen()) {
+        return false;
+    }
+
+    vector<string> columnNames;
+    for (int i = 0; i < dataSet.getNumColumns(); i++) {
+        columnNames.push_back(dataSet.getColumn(i).name);
+    }
+    writer.writeHeader(columnNames);
+
+    // gather blocks of rows from the columns and let the writer format them in parallel
+    const size_t   rowsPerBlock = 1 << 16;
+    int            numColumns   = dataSet.getNumColumns();
+    vector<double> rows;
+    for (size_t firstRow = 0; firstRow < dataSet.getNumRows(); firstRow += rowsPerBlock) {
+        size_t numRows = min(rowsPerBlock,dataSet.getNumRows() - firstRow);
+        rows.resize(numRows * numColumns);
+        for (int i = 0; i < numColumns; i++) {
+            const double* column = dataSet.getColumnData(i) + firstRow;
+            for (size_t r = 0; r < numRows; r++) {
+                rows[r * numColumns + i] = column[r];
+            }
+        }
+        writer.writeRows(rows.data(),numRows,numColumns);
+    }
+
+    if (!writer.close()) {
+        cout << "Error : could not write " << csvPath_ << endl;
+        return false;
+    }
+    return true;
+}
+
+/* --- miscellaneous --- */
+
+/**
+ * @brief ColumnarDataSet::map maps the whole file at path_ read-only into memory
+ */
+bool ColumnarDataSet::map(const string& path_) {
+    close();
+
+    int fileDescriptor = ::open(path_.c_str(),O_RDONLY);
+    if (fileDescriptor < 0) {
+        cout << "Error : could not open " << path_ << endl;
+        return false;
+    }
+
+    struct stat fileStatus;
+    if (fstat(fileDescriptor,&fileStatus) != 0 || fileStatus.st_size == 0) {
+        cout << "Error : " << path_ << " is empty" << endl;
+        ::close(fileDescriptor);
+        return false;
+    }
+
+    void* mapped_l = mmap(nullptr,fileStatus.st_size,PROT_READ,MAP_PRIVATE,fileDescriptor,0);
+    // the mapping stays valid after closing the file
+    ::close(fileDescriptor);
+    if (mapped_l == MAP_FAILED) {
+        cout << "Error : could not map " << path_ << " into memory" << endl;
+        return false;
+    }
+
+    mapped     = static_cast<const char*>(mapped_l);
+    mappedSize = fileStatus.st_size;
+    return true;
+}
@@ -0,0 +1,598 @@
+#include "CsvIO.h"
+
+// STL
+#include <iostream>
+#include <thread>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <algorithm>
+// POSIX
+#include <locale.h>
+
+namespace {
+
+/**
+ * "C" locale, used for all conversions between doubles and text
+ */
+locale_t cLocale() {
+    static locale_t locale = newlocale(LC_ALL_MASK,"C",(locale_t)0);
+    return locale;
+}
+
+/**
+ * switches the calling thread to the "C" locale while it exists (snprintf has no locale parameter)
+ */
+class CLocaleScope {
+    public:
+        CLocaleScope() : previous(uselocale(cLocale())) {};
+        ~CLocaleScope() {uselocale(previous);};
+    private:
+        locale_t previous;
+};
+
+/**
+ * formats value_ with the fewest significant digits which read back exactly, needs the "C" locale
+ */
+int formatShortest(double value_, char* buffer_) {
+    int length = 0;
+    for (int precision = 15; precision <= 17; precision++) {
+        length = snprintf(buffer_,32,"%.*g",precision,value_);
+        double readBack;
+        if (precision == 17 || (CsvReader::parseDouble(buffer_,buffer_ + length,readBack) != buffer_ && readBack == value_)) {
+            break;
+        }
+    }
+    return length;
+}
+
+/**
+ * parses the comma separated values of the line [position_, end_) and appends them to values_
+ * returns the number of values or -1 if the line is invalid
+ */
+int parseLine(const char* position_, const char* end_, vector<double>& values_) {
+    int count = 0;
+    while (true) {
+        while (position_ < end_ && (*position_ == ' ' || *position_ == '\t')) {
+            position_++;
+        }
+        double value;
+        const char* next = CsvReader::parseDouble(position_,end_,value);
+        if (next == position_) {
+            return -1;
+        }
+        values_.push_back(value);
+        count++;
+
+        position_ = next;
+        while (position_ < end_ && (*position_ == ' ' || *position_ == '\t' || *position_ == '\r')) {
+            position_++;
+        }
+        if (position_ == end_) {
+            return count;
+        }
+        if (*position_ != ',') {
+            return -1;
+        }
+        position_++;
+    }
+}
+
+/**
+ * returns the end of the line starting at position_ (without '\r') and sets next_ to the beginning of the next line
+ */
+const char* lineEnd(const char* position_, const char* end_, const char*& next_) {
+    const char* newline = static_cast<const char*>(memchr(position_,'\n',end_ - position_));
+    const char* result  = (newline != nullptr) ? newline : end_;
+    next_ = (newline != nullptr) ? newline + 1 : end_;
+    if (result > position_ && result[-1] == '\r') {
+        result--;
+    }
+    return result;
+}
+
+/**
+ * splits the header line [position_, end_) at commas and appends the trimmed names to names_
+ */
+void parseColumnNames(const char* position_, const char* end_, vector<string>& names_) {
+    const char* name = position_;
+    while (name <= end_) {
+        const char* nameEnd = static_cast<const char*>(memchr(name,',',end_ - name));
+        if (nameEnd == nullptr) {
+            nameEnd = end_;
+        }
+        string columnName(name,nameEnd);
+        columnName.erase(0,columnName.find_first_not_of(" \t"));
+        columnName.erase(columnName.find_last_not_of(" \t") + 1);
+        names_.push_back(columnName);
+        name = nameEnd + 1;
+    }
+}
+
+int resolveNumThreads(int numThreads_) {
+    return (numThreads_ > 0) ? numThreads_ : max(1u,thread::hardware_concurrency());
+}
+
+}
+
+/* --- constructors / destructors --- */
+
+/**
+ * @brief CsvWriter::CsvWriter opens the csv-file at path_ for writing
+ * @param path_       path of the csv-file
+ * @param bufferSize_ number of bytes which are collected before they are written to the file
+ */
+CsvWriter::CsvWriter(const string& path_, size_t bufferSize_)
+    : oFile(path_,ios::binary), buffer(max<size_t>(bufferSize_,64)), used(0), failed(false), numThreads(0) {
+    if (!oFile.is_open()) {
+        cout << "Error : could not open " << path_ << endl;
+        failed = true;
+    }
+}
+
+/**
+ * @brief CsvWriter::~CsvWriter writes the remaining buffer and closes the file
+ */
+CsvWriter::~CsvWriter() {
+    if (oFile.is_open()) {
+        close();
+    }
+}
+
+/* --- writing --- */
+
+/**
+ * @brief CsvWriter::writeHeader writes a line with the names of the columns
+ */
+void CsvWriter::writeHeader(const vector<string>& columnNames_) {
+    for (unsigned int i = 0; i < columnNames_.size(); i++) {
+        if (i > 0) {
+            append(",",1);
+        }
+        append(columnNames_[i].data(),columnNames_[i].size());
+    }
+    append("\n",1);
+}
+
+/**
+ * @brief CsvWriter::writeRow writes one line with numValues_ values
+ */
+void CsvWriter::writeRow(const double* values_, int numValues_) {
+    CLocaleScope cLocaleScope;
+    char text[40];
+    for (int i = 0; i < numValues_; i++) {
+        int length = formatShortest(values_[i],text);
+        text[length++] = (i + 1 < numValues_) ? ',' : '\n';
+        append(text,length);
+    }
+}
+
+/**
+ * @brief CsvWriter::writeRow writes one line with all values_
+ */
+void CsvWriter::writeRow(const vector<double>& values_) {
+    writeRow(values_.data(),values_.size());
+}
+
+/**
+ * @brief CsvWriter::writeRows writes numRows_ lines of numColumns_ values each
+ * @param values_     numRows_ * numColumns_ values, one row after another
+ * @param numRows_    number of rows
+ * @param numColumns_ number of values per row
+ *
+ * Formatting the values is much more expensive than writing the text. Therefore the rows are
+ * divided into chunks, which are formatted in parallel and written in their original order.
+ */
+void CsvWriter::writeRows(const double* values_, size_t numRows_, int numColumns_) {
+    const size_t rowsPerChunk = 16384;
+    int numThreads_l = resolveNumThreads(numThreads);
+    if (numThreads_l == 1 || numRows_ < 2 * rowsPerChunk) {
+        for (size_t r = 0; r < numRows_; r++) {
+            writeRow(&values_[r * numColumns_],numColumns_);
+        }
+        return;
+    }
+
+    vector<string> texts(numThreads_l);
+    for (size_t firstRow = 0; firstRow < numRows_; firstRow += rowsPerChunk * numThreads_l) {
+        vector<thread> threads;
+        for (int t = 0; t < numThreads_l; t++) {
+            threads.push_back(thread([&,t] {
+                CLocaleScope cLocaleScope;
+                size_t begin = min(numRows_,firstRow + t * rowsPerChunk);
+                size_t end   = min(numRows_,begin + rowsPerChunk);
+                string& text = texts[t];
+                text.clear();
+                char value[40];
+                for (size_t r = begin; r < end; r++) {
+                    for (int c = 0; c < numColumns_; c++) {
+                        int length = formatShortest(values_[r * numColumns_ + c],value);
+                        value[length++] = (c + 1 < numColumns_) ? ',' : '\n';
+                        text.append(value,length);
+                    }
+                }
+            }));
+        }
+        for (int t = 0; t < numThreads_l; t++) {
+            threads[t].join();
+            append(texts[t].data(),texts[t].size());
+        }
+    }
+}
+
+/**
+ * @brief CsvWriter::flush writes the buffer to the file
+ * @return returns false if writing has failed (now or before), otherwise true
+ */
+bool CsvWriter::flush() {
+    if (used > 0 && !failed) {
+        oFile.write(buffer.data(),used);
+        oFile.flush();
+        if (!oFile) {
+            cout << "Error : could not write csv-file" << endl;
+            failed = true;
+        }
+    }
+    used = 0;
+    return !failed;
+}
+
+/**
+ * @brief CsvWriter::close writes the buffer and closes the file
+ * @return returns false if writing has failed, otherwise true
+ */
+bool CsvWriter::close() {
+    bool result = flush();
+    oFile.close();
+    return result;
+}
+
+/**
+ * @brief CsvWriter::formatDouble writes the shortest text which reads back to exactly value_ into buffer_
+ * @param value_  value which is to format
+ * @param buffer_ buffer for at least 32 characters
+ * @return returns the number of characters written (without the terminating zero)
+ */
+int CsvWriter::formatDouble(double value_, char* buffer_) {
+    CLocaleScope cLocaleScope;
+    return formatShortest(value_,buffer_);
+}
+
+/**
+ * @brief CsvWriter::append appends text_ to the buffer, writes the buffer if it is full
+ */
+void CsvWriter::append(const char* text_, size_t length_) {
+    if (used + length_ > buffer.size()) {
+        flush();
+        if (length_ > buffer.size()) {
+            // big blocks bypass the buffer
+            if (!failed) {
+                oFile.write(text_,length_);
+                failed = !oFile;
+            }
+            return;
+        }
+    }
+    memcpy(buffer.data() + used,text_,length_);
+    used += length_;
+}
+
+/* --- constructors / destructors --- */
+
+/**
+ * @brief CsvReader::CsvReader constructor of class CsvReader, by default all available cores are used
+ */
+CsvReader::CsvReader()
+    : numThreads(0), numColumns(0) {
+}
+
+/* --- reading --- */
+
+/**
+ * @brief CsvReader::read reads all values of the csv-file at path_
+ * @param path_ path of the csv-file
+ * @return returns true if the file has been read, otherwise false
+ *
+ * NOTICE : if a line contains no valid numbers or a different number of values than the
+ *          first line, the function stops and returns false
+ */
+bool CsvReader::read(const string& path_) {
+    columnNames.clear();
+    values.clear();
+    numColumns = 0;
+
+    ifstream iFile(path_,ios::binary | ios::ate);
+    if (!iFile.is_open()) {
+        cout << "Error : could not open " << path_ << endl;
+        return false;
+    }
+    vector<char> content((size_t)iFile.tellg());
+    iFile.seekg(0);
+    iFile.read(content.data(),content.size());
+    if (!iFile) {
+        cout << "Error : could not read " << path_ << endl;
+        return false;
+    }
+    const char* begin = content.data();
+    const char* end   = begin + content.size();
+
+    // the first non-empty line is either the header or determines the number of columns
+    const char* position = begin;
+    bool headerAllowed = true;
+    while (position < end && numColumns == 0) {
+        const char* next;
+        const char* lineEnd_l = lineEnd(position,end,next);
+        if (lineEnd_l == position) {
+            position = next;
+            continue;
+        }
+
+        vector<double> row;
+        int numValues = parseLine(position,lineEnd_l,row);
+        if (numValues > 0) {
+            numColumns = numValues;
+            break;
+        }
+        if (!headerAllowed) {
+            cout << "Error : invalid line in " << path_ << " : " << string(position,lineEnd_l) << endl;
+            return false;
+        }
+
+        // a non-numeric first line holds the column names
+        parseColumnNames(position,lineEnd_l,columnNames);
+        headerAllowed = false;
+        position = next;
+    }
+    if (numColumns == 0) {
+        numColumns = columnNames.size();
+        return true;
+    }
+
+    // split the rest of the file into parts of whole lines, at least 1 MiB per thread
+    int numParts = (int)min<size_t>(resolveNumThreads(numThreads),max<size_t>(1,(end - position) >> 20));
+    vector<const char*> partBegins(numParts + 1,end);
+    partBegins[0] = position;
+    for (int p = 1; p < numParts; p++) {
+        const char* split = max(partBegins[p - 1],position + (end - position) / numParts * p);
+        const char* newline = static_cast<const char*>(memchr(split,'\n',end - split));
+        partBegins[p] = (newline != nullptr) ? newline + 1 : end;
+    }
+
+    vector<vector<double>> partValues(numParts);
+    vector<string>         invalidLines(numParts);
+    vector<thread> threads;
+    for (int p = 0; p < numParts; p++) {
+        threads.push_back(thread([&,p] {
+            vector<double>& own = partValues[p];
+            own.reserve((partBegins[p + 1] - partBegins[p]) / 8);
+            const char* line = partBegins[p];
+            while (line < partBegins[p + 1]) {
+                const char* next;
+                const char* lineEnd_l = lineEnd(line,partBegins[p + 1],next);
+                if (lineEnd_l > line) {
+                    size_t previousSize = own.size();
+                    if (parseLine(line,lineEnd_l,own) != numColumns) {
+                        own.resize(previousSize);
+                        invalidLines[p] = string(line,lineEnd_l);
+                        return;
+                    }
+                }
+                line = next;
+            }
+        }));
+    }
+    for (int p = 0; p < numParts; p++) {
+        threads[p].join();
+    }
+
+    size_t numValues = 0;
+    for (int p = 0; p < numParts; p++) {
+        if (!invalidLines[p].empty()) {
+            cout << "Error : invalid line in " << path_ << " : " << invalidLines[p] << endl;
+            values.clear();
+            return false;
+        }
+        numValues += partValues[p].size();
+    }
+    values.reserve(numValues);
+    for (int p = 0; p < numParts; p++) {
+        values.insert(values.end(),partValues[p].begin(),partValues[p].end());
+    }
+    if (columnNames.size() != (size_t)numColumns) {
+        columnNames.resize(numColumns);
+    }
+    return true;
+}
+
+/**
+ * @brief CsvReader::readBlocks reads a csv-file line by line and passes the values block by block to block_
+ * @param path_         path of the csv-file
+ * @param rowsPerBlock_ number of rows per block, the last block may have less
+ * @param block_        gets the values of numRows_ rows (row-major), returns false to stop reading
+ * @return returns true if the whole file has been read, otherwise false
+ *
+ * Unlike read(), only one block is held in memory, therefore files larger than the main memory
+ * can be read. The values are not kept (getValues() is empty), the column names and the number
+ * of columns are set before block_ is called the first time.
+ *
+ * NOTICE : if a line contains no valid numbers or a different number of values than the
+ *          first line, the function stops and returns false
+ */
+bool CsvReader::readBlocks(const string& path_, size_t rowsPerBlock_, const function<bool(const double* values_, size_t numRows_)>& block_) {
+    columnNames.clear();
+    values.clear();
+    numColumns = 0;
+
+    ifstream iFile(path_,ios::binary);
+    if (!iFile.is_open()) {
+        cout << "Error : could not open " << path_ << endl;
+        return false;
+    }
+
+    vector<double> block;
+    size_t numRowsInBlock = 0;
+    bool headerAllowed = true;
+    string line;
+    while (getline(iFile,line)) {
+        const char* begin = line.data();
+        const char* end   = begin + line.size();
+        if (end > begin && end[-1] == '\r') {
+            end--;
+        }
+        if (end == begin) {
+            continue;
+        }
+
+        size_t previousSize = block.size();
+        int numValues = parseLine(begin,end,block);
+        if (numColumns == 0 && numValues <= 0 && headerAllowed) {
+            // a non-numeric first line holds the column names
+            block.resize(previousSize);
+            parseColumnNames(begin,end,columnNames);
+            headerAllowed = false;
+            continue;
+        }
+        if (numColumns == 0 && numValues > 0) {
+            numColumns = numValues;
+            columnNames.resize(numColumns);
+        }
+        if (numValues != numColumns) {
+            cout << "Error : invalid line in " << path_ << " : " << string(begin,end) << endl;
+            return false;
+        }
+        headerAllowed = false;
+
+        numRowsInBlock++;
+        if (numRowsInBlock == rowsPerBlock_) {
+            if (!block_(block.data(),numRowsInBlock)) {
+                return false;
+            }
+            block.clear();
+            numRowsInBlock = 0;
+        }
+    }
+    if (iFile.bad()) {
+        cout << "Error : could not read " << path_ << endl;
+        return false;
+    }
+    if (numColumns == 0) {
+        numColumns = columnNames.size();
+    }
+    return numRowsInBlock == 0 || block_(block.data(),numRowsInBlock);
+}
+
+/**
+ * @brief CsvReader::getColumn returns all values of the column index_
+ */
+vector<double> CsvReader::getColumn(int index_) const {
+    vector<double> result(getNumRows());
+    for (size_t r = 0; r < result.size(); r++) {
+        result[r] = values[r * numColumns + index_];
+    }
+    return result;
+}
+
+/**
+ * @brief CsvReader::getRows returns the columns firstColumn_ ... firstColumn_ + numColumns_ - 1 of every row
+ * @return returns one vector per row, as used by the multi-input train and forward functions of ANN
+ */
+vector<vector<double>> CsvReader::getRows(int firstColumn_, int numColumns_) const {
+    vector<vector<double>> result(getNumRows());
+    for (size_t r = 0; r < result.size(); r++) {
+        result[r].assign(values.begin() + r * numColumns + firstColumn_,values.begin() + r * numColumns + firstColumn_ + numColumns_);
+    }
+    return result;
+}
+
+/**
+ * @brief CsvReader::parseDouble converts the number at the beginning of [position_, end_)
+ * @param position_ beginning of the number
+ * @param end_      end of the text
+ * @param value_    the converted number
+ * @return returns the position after the number, position_ if there is no number
+ *
+ * Numbers with at most 19 significant digits, a mantissa up to 2^53 and a decimal exponent
+ * within [-22, 22] are converted exactly by one multiplication or division of two exact
+ * doubles (Clinger's fast path). All other numbers (and nan, inf) are converted by strtod
+ * in the "C" locale.
+ */
+const char* CsvReader::parseDouble(const char* position_, const char* end_, double& value_) {
+    static const double powersOfTen[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                         1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    const char* p = position_;
+    bool negative = false;
+    if (p < end_ && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        p++;
+    }
+
+    unsigned long long mantissa  = 0;
+    int                numDigits = 0;
+    int                exponent  = 0;
+    bool               anyDigit  = false;
+    bool               truncated = false;
+    for (; p < end_ && *p >= '0' && *p <= '9'; p++) {
+        anyDigit = true;
+        if (numDigits < 19) {
+            mantissa = mantissa * 10 + (*p - '0');
+            numDigits += (mantissa != 0);
+        } else {
+            exponent++;
+            truncated |= (*p != '0');
+        }
+    }
+    if (p < end_ && *p == '.') {
+        for (p++; p < end_ && *p >= '0' && *p <= '9'; p++) {
+            anyDigit = true;
+            if (numDigits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                numDigits += (mantissa != 0);
+                exponent--;
+            } else {
+                truncated |= (*p != '0');
+            }
+        }
+    }
+
+    if (anyDigit) {
+        if (p < end_ && (*p == 'e' || *p == 'E')) {
+            const char* q = p + 1;
+            bool negativeExponent = false;
+            if (q < end_ && (*q == '-' || *q == '+')) {
+                negativeExponent = (*q == '-');
+                q++;
+            }
+            if (q < end_ && *q >= '0' && *q <= '9') {
+                int decimalExponent = 0;
+                for (; q < end_ && *q >= '0' && *q <= '9'; q++) {
+                    decimalExponent = min(decimalExponent * 10 + (*q - '0'),100000);
+                }
+                exponent += negativeExponent ? -decimalExponent : decimalExponent;
+                p = q;
+            }
+        }
+
+        if (mantissa == 0 && !truncated) {
+            value_ = negative ? -0.0 : 0.0;
+            return p;
+        }
+        if (!truncated && mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22) {
+            double value = double(mantissa);
+            value  = (exponent < 0) ? value / powersOfTen[-exponent] : value * powersOfTen[exponent];
+            value_ = negative ? -value : value;
+            return p;
+        }
+    }
+
+    // slow path : strtod needs a terminated copy of the number
+    char   text[512];
+    size_t length = 0;
+    while (position_ + length < end_ && length + 1 < sizeof(text) && position_[length] != ',' && position_[length] != '\n') {
+        text[length] = position_[length];
+        length++;
+    }
+    text[length] = '\0';
+    char* textEnd;
+    value_ = strtod_l(text,&textEnd,cLocale());
+    return position_ + (textEnd - text);
+}
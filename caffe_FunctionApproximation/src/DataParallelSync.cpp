@@ -0,0 +1,166 @@
+#include "DataParallelSync.h"
+
+// STL
+#include <algorithm>
+// own
+#include "SolverNet.h"
+
+/* --- constructors / destructors --- */
+
+/**
+ * @brief DataParallelSync::DataParallelSync creates numReplicas_ - 1 replicas of the net of solver_
+ *        and starts one worker thread per replica
+ * @param solver_      solver whose iterations are parallelized, the sync registers itself as its callback
+ * @param numReplicas_ number of replicas including the net of the solver
+ *
+ * The replicas are built from the TRAIN net of the solver parameters (see SolverNet) and share the weights
+ * with the net of the solver, therefore the weights are only updated once per iteration.
+ *
+ * NOTICE : the sync has to exist as long as solver_ is used, as solver_ keeps a pointer to it
+ */
+DataParallelSync::DataParallelSync(Solver<double>* solver_, int numReplicas_)
+    : solver(solver_), numReplicas(max(numReplicas_,1)), weights(numReplicas,1.0 / numReplicas),
+      generation(0), reduced(new atomic<long>[numReplicas]), stopping(false) {
+    for (int r = 0; r < numReplicas; r++) {
+        reduced[r].store(0);
+    }
+
+    replicas.push_back(solver->net());
+    for (int r = 1; r < numReplicas; r++) {
+        caffe::shared_ptr<Net<double> > replica(new Net<double>(SolverNet::netParameter(solver->param(),caffe::TRAIN)));
+        replica->ShareTrainedLayersWith(solver->net().get());
+        replicas.push_back(replica);
+    }
+
+    // caffe keeps the mode per thread
+    Caffe::Brew mode = Caffe::mode();
+    for (int r = 1; r < numReplicas; r++) {
+        workers.emplace_back([this, r, mode]() {
+            Caffe::set_mode(mode);
+            work(r);
+        });
+    }
+    solver->add_callback(this);
+}
+
+/**
+ * @brief DataParallelSync::~DataParallelSync stops the worker threads
+ */
+DataParallelSync::~DataParallelSync() {
+    {
+        lock_guard<mutex> lock(generationMutex);
+        stopping.store(true,memory_order_release);
+    }
+    generationChanged.notify_all();
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
+
+/* --- getter / setter --- */
+
+/**
+ * @brief DataParallelSync::getReplica returns the replica with the index replica_ (0 : the net of the solver)
+ */
+Net<double>* DataParallelSync::getReplica(int replica_) {
+    return replicas[replica_].get();
+}
+
+/* --- solver callbacks --- */
+
+/**
+ * @brief DataParallelSync::on_start starts an iteration of the workers
+ *
+ * The gradients of every replica are weighted by the number of its samples, therefore the
+ * shards do not need to have equal sizes.
+ */
+void DataParallelSync::on_start() {
+    double numSamples = 0;
+    for (int r = 0; r < numReplicas; r++) {
+        numSamples += replicas[r]->input_blobs()[0]->num();
+    }
+    for (int r = 0; r < numReplicas; r++) {
+        weights[r] = replicas[r]->input_blobs()[0]->num() / numSamples;
+    }
+    {
+        lock_guard<mutex> lock(generationMutex);
+        generation.fetch_add(1,memory_order_release);
+    }
+    generationChanged.notify_all();
+}
+
+/**
+ * @brief DataParallelSync::on_gradients_ready sums the gradients of all replicas into the net of the solver
+ */
+void DataParallelSync::on_gradients_ready() {
+    reduce(0,generation.load(memory_order_acquire));
+}
+
+/* --- miscellaneous --- */
+
+/**
+ * @brief DataParallelSync::work runs the iterations of one replica until the sync is destroyed
+ *
+ * Between the iterations the worker sleeps until on_start or the destructor wakes it up.
+ */
+void DataParallelSync::work(int replica_) {
+    Net<double>* net = replicas[replica_].get();
+    long done = 0;
+    while (true) {
+        long current;
+        {
+            unique_lock<mutex> lock(generationMutex);
+            generationChanged.wait(lock,[this, done]() {
+                return stopping.load(memory_order_acquire) || generation.load(memory_order_acquire) != done;
+            });
+            if (stopping.load(memory_order_acquire)) {
+                return;
+            }
+            current = generation.load(memory_order_acquire);
+        }
+        done = current;
+
+        net->ClearParamDiffs();
+        for (int i = 0; i < solver->param().iter_size(); i++) {
+            net->ForwardBackward();
+        }
+        reduce(replica_,current);
+    }
+}
+
+/**
+ * @brief DataParallelSync::reduce sums the gradients of the subtree of replica_ into replica_
+ * @param replica_    index of the replica
+ * @param generation_ number of the current iteration
+ *
+ * The own gradients are weighted first, then the sums of the child subtrees are added as soon
+ * as the children have published them. Finally the sum of the subtree is published.
+ */
+void DataParallelSync::reduce(int replica_, long generation_) {
+    const vector<Blob<double>*>& params = replicas[replica_]->learnable_params();
+    for (Blob<double>* param : params) {
+        double* diff = param->mutable_cpu_diff();
+        for (int i = 0; i < param->count(); i++) {
+            diff[i] *= weights[replica_];
+        }
+    }
+
+    for (int step = 1; step < numReplicas && replica_ % (2 * step) == 0; step *= 2) {
+        int partner = replica_ + step;
+        if (partner >= numReplicas) {
+            continue;
+        }
+        while (reduced[partner].load(memory_order_acquire) != generation_) {
+            this_thread::yield();
+        }
+        const vector<Blob<double>*>& partnerParams = replicas[partner]->learnable_params();
+        for (unsigned int p = 0; p < params.size(); p++) {
+            double*       diff        = params[p]->mutable_cpu_diff();
+            const double* partnerDiff = partnerParams[p]->cpu_diff();
+            for (int i = 0; i < params[p]->count(); i++) {
+                diff[i] += partnerDiff[i];
+            }
+        }
+    }
+    reduced[replica_].store(generation_,memory_order_release);
+}
@@ -0,0 +1,164 @@
+#include "DataSource.h"
+
+// STL
+#include <algorithm>
+#include <numeric>
+#include <cstring>
+
+/* --- constructors / destructors --- */
+
+/**
+ * @brief InMemoryDataSource::InMemoryDataSource constructor for samples with one input and one output value
+ * @param inputValues_  one input value per sample
+ * @param outputValues_ one expected output value per sample
+ *
+ * NOTICE : inputValues_ and outputValues_ have to have the same length
+ */
+InMemoryDataSource::InMemoryDataSource(const vector<double>& inputValues_, const vector<double>& outputValues_)
+    : numInputs(1), numOutputs(1), numSamples(min(inputValues_.size(),outputValues_.size())),
+      inputValues(inputValues_.begin(),inputValues_.begin() + numSamples),
+      outputValues(outputValues_.begin(),outputValues_.begin() + numSamples),
+      position(0), shuffle(true), generator(0) {
+}
+
+/**
+ * @brief InMemoryDataSource::InMemoryDataSource constructor for samples with several input values and one output value
+ * @param inputValues_  vector of input values per sample
+ * @param outputValues_ one expected output value per sample
+ *
+ * NOTICE : inputValues_ and outputValues_ have to have the same length and every sample
+ *          has to have the same number of input values
+ */
+InMemoryDataSource::InMemoryDataSource(const vector<vector<double>>& inputValues_, const vector<double>& outputValues_)
+    : numInputs(inputValues_.empty() ? 0 : (int)inputValues_[0].size()), numOutputs(1),
+      numSamples(min(inputValues_.size(),outputValues_.size())),
+      outputValues(outputValues_.begin(),outputValues_.begin() + numSamples),
+      position(0), shuffle(true), generator(0) {
+    inputValues.reserve(numSamples * numInputs);
+    for (size_t i = 0; i < numSamples; i++) {
+        inputValues.insert(inputValues.end(),inputValues_[i].begin(),inputValues_[i].begin() + numInputs);
+    }
+}
+
+/**
+ * @brief InMemoryDataSource::InMemoryDataSource constructor for samples with several input and output values
+ * @param inputValues_  vector of input values per sample
+ * @param outputValues_ vector of expected output values per sample
+ *
+ * NOTICE : inputValues_ and outputValues_ have to have the same length and every sample
+ *          has to have the same number of input and output values
+ */
+InMemoryDataSource::InMemoryDataSource(const vector<vector<double>>& inputValues_, const vector<vector<double>>& outputValues_)
+    : numInputs(inputValues_.empty() ? 0 : (int)inputValues_[0].size()),
+      numOutputs(outputValues_.empty() ? 0 : (int)outputValues_[0].size()),
+      numSamples(min(inputValues_.size(),outputValues_.size())),
+      position(0), shuffle(true), generator(0) {
+    inputValues.reserve(numSamples * numInputs);
+    outputValues.reserve(numSamples * numOutputs);
+    for (size_t i = 0; i < numSamples; i++) {
+        inputValues.insert(inputValues.end(),inputValues_[i].begin(),inputValues_[i].begin() + numInputs);
+        outputValues.insert(outputValues.end(),outputValues_[i].begin(),outputValues_[i].begin() + numOutputs);
+    }
+}
+
+/**
+ * @brief InMemoryDataSource::InMemoryDataSource constructor for samples stored in two matrices
+ * @param inputValues_  input values, one row per sample
+ * @param outputValues_ expected output values, one row per sample
+ *
+ * The rows of both matrices are already laid out like the internal arrays, therefore each
+ * matrix is copied as one block.
+ *
+ * NOTICE : inputValues_ and outputValues_ have to have the same number of rows
+ */
+InMemoryDataSource::InMemoryDataSource(const MatrixView& inputValues_, const MatrixView& outputValues_)
+    : numInputs(inputValues_.getNumColumns()), numOutputs(outputValues_.getNumColumns()),
+      numSamples(min(inputValues_.getNumRows(),outputValues_.getNumRows())),
+      inputValues(inputValues_.data(),inputValues_.data() + numSamples * numInputs),
+      outputValues(outputValues_.data(),outputValues_.data() + numSamples * numOutputs),
+      position(0), shuffle(true), generator(0) {
+}
+
+/* --- reading samples --- */
+
+/**
+ * @brief InMemoryDataSource::nextBatch copies the next batchSize_ samples into the given buffers
+ * @param batchSize_    number of samples to copy
+ * @param inputValues_  buffer for batchSize_ * getNumInputs() input values
+ * @param outputValues_ buffer for batchSize_ * getNumOutputs() expected output values
+ */
+void InMemoryDataSource::nextBatch(int batchSize_, double* inputValues_, double* outputValues_) {
+    if (numSamples == 0) {
+        return;
+    }
+
+    for (int i = 0; i < batchSize_; i++) {
+        if (position == 0 || position >= numSamples) {
+            startEpoch();
+        }
+        size_t sample = order[position++];
+        memcpy(&inputValues_[i * numInputs],  &inputValues[sample * numInputs],  numInputs  * sizeof(double));
+        memcpy(&outputValues_[i * numOutputs],&outputValues[sample * numOutputs],numOutputs * sizeof(double));
+    }
+}
+
+/* --- miscellaneous --- */
+
+/**
+ * @brief InMemoryDataSource::holdOut moves a random part of the samples into a new data source
+ * @param fraction_ share of the samples which are moved, e.g. 0.2 for a validation set of 20%
+ * @param seed_     seed of the random choice of the samples
+ * @return returns a data source with the moved samples (in their original order)
+ *
+ * The samples are removed from this source, therefore they are never delivered by nextBatch
+ * again. At least one sample is kept. The next batch starts a new epoch.
+ */
+InMemoryDataSource InMemoryDataSource::holdOut(double fraction_, unsigned int seed_) {
+    size_t numHeldOut = (size_t)max(0.0,min(fraction_,1.0) * numSamples + 0.5);
+    numHeldOut = min(numHeldOut,numSamples > 0 ? numSamples - 1 : 0);
+
+    vector<size_t> samples(numSamples);
+    iota(samples.begin(),samples.end(),0);
+    mt19937 generator_l(seed_);
+    std::shuffle(samples.begin(),samples.end(),generator_l);
+    vector<bool> heldOut(numSamples,false);
+    for (size_t i = 0; i < numHeldOut; i++) {
+        heldOut[samples[i]] = true;
+    }
+
+    // the kept samples are compacted in place
+    Matrix heldOutInputValues(numHeldOut,numInputs), heldOutOutputValues(numHeldOut,numOutputs);
+    size_t numKept = 0, numMoved = 0;
+    for (size_t sample = 0; sample < numSamples; sample++) {
+        if (heldOut[sample]) {
+            memcpy(heldOutInputValues.row(numMoved), &inputValues[sample * numInputs],  numInputs  * sizeof(double));
+            memcpy(heldOutOutputValues.row(numMoved),&outputValues[sample * numOutputs],numOutputs * sizeof(double));
+            numMoved++;
+        } else {
+            memmove(&inputValues[numKept * numInputs],  &inputValues[sample * numInputs],  numInputs  * sizeof(double));
+            memmove(&outputValues[numKept * numOutputs],&outputValues[sample * numOutputs],numOutputs * sizeof(double));
+            numKept++;
+        }
+    }
+    numSamples = numKept;
+    inputValues.resize(numSamples * numInputs);
+    outputValues.resize(numSamples * numOutputs);
+    order.clear();
+    position = 0;
+
+    return InMemoryDataSource(heldOutInputValues,heldOutOutputValues);
+}
+
+/**
+ * @brief InMemoryDataSource::startEpoch starts a new pass over all samples, in a new random order if shuffling is enabled
+ */
+void InMemoryDataSource::startEpoch() {
+    if (order.size() != numSamples) {
+        order.resize(numSamples);
+        iota(order.begin(),order.end(),0);
+    }
+    if (shuffle) {
+        std::shuffle(order.begin(),order.end(),generator);
+    }
+    position = 0;
+}
@@ -0,0 +1,83 @@
+#include "DistributedSync.h"
+
+// STL
+#include <algorithm>
+#include <iostream>
+
+/* --- constructors / destructors --- */
+
+/**
+ * @brief DistributedSync::DistributedSync copies the weights of rank 0 to all ranks and registers the sync as callback of solver_
+ * @param solver_ solver of this rank
+ * @param ring_   ring of all ranks, every rank has to create its sync at the same time
+ *
+ * NOTICE : the sync has to exist as long as solver_ is used, as solver_ keeps a pointer to it
+ */
+DistributedSync::DistributedSync(Solver<double>* solver_, RingAllReduce& ring_)
+    : solver(solver_), ring(ring_), valid(true), numSamples(0) {
+    const vector<Blob<double>*>& params = solver->net()->learnable_params();
+    size_t numValues = 1;
+    for (Blob<double>* param : params) {
+        numValues += param->count();
+    }
+    buffer.resize(numValues);
+
+    // broadcast : all ranks except rank 0 contribute zeros to the sum
+    size_t offset = 0;
+    for (Blob<double>* param : params) {
+        if (ring.getRank() == 0) {
+            copy(param->cpu_data(),param->cpu_data() + param->count(),buffer.begin() + offset);
+        } else {
+            fill(buffer.begin() + offset,buffer.begin() + offset + param->count(),0.0);
+        }
+        offset += param->count();
+    }
+    valid = ring.allReduce(buffer.data(),buffer.size() - 1);
+    if (valid) {
+        offset = 0;
+        for (Blob<double>* param : params) {
+            copy(buffer.begin() + offset,buffer.begin() + offset + param->count(),param->mutable_cpu_data());
+            offset += param->count();
+        }
+    }
+    solver->add_callback(this);
+}
+
+/* --- solver callbacks --- */
+
+/**
+ * @brief DistributedSync::on_gradients_ready replaces the gradients of this rank by the weighted sum of the gradients of all ranks
+ */
+void DistributedSync::on_gradients_ready() {
+    if (!valid) {
+        return;
+    }
+    const vector<Blob<double>*>& params = solver->net()->learnable_params();
+    double numSamples_l = numSamples > 0 ? numSamples : solver->net()->input_blobs()[0]->num();
+
+    size_t offset = 0;
+    for (Blob<double>* param : params) {
+        const double* diff = param->cpu_diff();
+        for (int i = 0; i < param->count(); i++) {
+            buffer[offset + i] = diff[i] * numSamples_l;
+        }
+        offset += param->count();
+    }
+    buffer[offset] = numSamples_l;
+
+    if (!ring.allReduce(buffer.data(),buffer.size())) {
+        cout << "Error : rank " << ring.getRank() << " can not sum the gradients, it continues with its own gradients" << endl;
+        valid = false;
+        return;
+    }
+
+    double totalSamples = buffer[offset];
+    offset = 0;
+    for (Blob<double>* param : params) {
+        double* diff = param->mutable_cpu_diff();
+        for (int i = 0; i < param->count(); i++) {
+            diff[i] = buffer[offset + i] / totalSamples;
+        }
+        offset += param->count();
+    }
+}
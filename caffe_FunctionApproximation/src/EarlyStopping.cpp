@@ -0,0 +1,91 @@
+#include "EarlyStopping.h"
+
+// STL
+#include <algorithm>
+// own
+#include "SolverNet.h"
+
+/* --- constructors / destructors --- */
+
+/**
+ * @brief EarlyStopping::EarlyStopping builds the validation net, which shares its weights with the net of solver_
+ * @param solver_ solver whose training is monitored
+ *
+ * By default the validation error is evaluated every 1000 iterations and the training stops
+ * after 10 evaluations without improvement, a target error is not set.
+ */
+EarlyStopping::EarlyStopping(Solver<double>* solver_)
+    : solver(solver_), interval(1000), patience(10), targetError(0), lastIteration(-1), numWithoutImprovement(0) {
+    validationNet.reset(new Net<double>(SolverNet::netParameter(solver->param(),caffe::TEST)));
+    validationNet->ShareTrainedLayersWith(solver->net().get());
+}
+
+/* --- validation --- */
+
+/**
+ * @brief EarlyStopping::validate evaluates the validation error of the current weights of the solver
+ * @return returns the validation error
+ *
+ * If the error is lower than all errors before, the weights are kept as best weights.
+ */
+double EarlyStopping::validate() {
+    double error = 0;
+    validationNet->Forward(&error);
+
+    lastIteration = solver->iter();
+    report.numEvaluations++;
+    report.lastError = error;
+    if (report.numEvaluations == 1 || error < report.bestError) {
+        report.bestError     = error;
+        report.bestIteration = lastIteration;
+        numWithoutImprovement = 0;
+
+        bestWeights.clear();
+        for (Blob<double>* param : solver->net()->learnable_params()) {
+            bestWeights.insert(bestWeights.end(),param->cpu_data(),param->cpu_data() + param->count());
+        }
+    } else {
+        numWithoutImprovement++;
+    }
+    report.targetReached = targetError > 0 && error <= targetError;
+    return error;
+}
+
+/**
+ * @brief EarlyStopping::shouldStop evaluates the validation error if an interval is complete
+ * @return returns true if the target error has been reached or the validation error has not
+ *         improved for getPatience() evaluations, otherwise false
+ */
+bool EarlyStopping::shouldStop() {
+    if (interval > 0 && solver->iter() % interval == 0 && solver->iter() != lastIteration) {
+        validate();
+        report.stoppedEarly = report.targetReached || (patience > 0 && numWithoutImprovement >= patience);
+    }
+    return report.stoppedEarly;
+}
+
+/**
+ * @brief EarlyStopping::restoreBestWeights copies the weights with the lowest validation error into the net of the solver
+ *
+ * The weights of the last iteration are evaluated first, unless they already have been.
+ */
+void EarlyStopping::restoreBestWeights() {
+    if (solver->iter() != lastIteration) {
+        validate();
+    }
+    size_t offset = 0;
+    for (Blob<double>* param : solver->net()->learnable_params()) {
+        copy(bestWeights.begin() + offset,bestWeights.begin() + offset + param->count(),param->mutable_cpu_data());
+        offset += param->count();
+    }
+}
+
+/**
+ * @brief EarlyStopping::Report::print writes a compact summary of the report to oStream_
+ */
+void EarlyStopping::Report::print(ostream& oStream_) const {
+    oStream_ << "evaluations      : " << numEvaluations << endl;
+    oStream_ << "best error       : " << bestError << " (iteration " << bestIteration << ")" << endl;
+    oStream_ << "last error       : " << lastError << endl;
+    oStream_ << "stopped early    : " << (stoppedEarly ? (targetReached ? "yes (target reached)" : "yes (no improvement)") : "no") << endl;
+}
@@ -0,0 +1,116 @@
+#include "GeneratorDataSource.h"
+
+// STL
+#include <random>
+#include <algorithm>
+
+/* --- constructors / destructors --- */
+
+/**
+ * @brief GeneratorDataSource::GeneratorDataSource constructor of class GeneratorDataSource
+ * @param domain_         box the input values are drawn from
+ * @param targetFunction_ function which calculates the expected output values for given input values
+ * @param numOutputs_     number of values returned by targetFunction_
+ */
+GeneratorDataSource::GeneratorDataSource(const Domain& domain_, const function<vector<double>(const vector<double>&)>& targetFunction_,
+                                         int numOutputs_)
+    : domain(domain_), targetFunction(targetFunction_), numOutputs(numOutputs_), numThreads(0), chunkSize(1024),
+      seed(0), positionInChunk(0) {
+}
+
+/**
+ * @brief GeneratorDataSource::~GeneratorDataSource stops the producer threads
+ */
+GeneratorDataSource::~GeneratorDataSource() {
+    if (generatedChunks) {
+        generatedChunks->close();
+    }
+    for (unsigned int i = 0; i < producers.size(); i++) {
+        producers[i].join();
+    }
+}
+
+/* --- reading samples --- */
+
+/**
+ * @brief GeneratorDataSource::nextBatch copies the next batchSize_ generated samples into the given buffers
+ * @param batchSize_    number of samples to copy
+ * @param inputValues_  buffer for batchSize_ * getNumInputs() input values
+ * @param outputValues_ buffer for batchSize_ * getNumOutputs() expected output values
+ *
+ * Blocks until the producers have generated enough samples.
+ */
+void GeneratorDataSource::nextBatch(int batchSize_, double* inputValues_, double* outputValues_) {
+    if (producers.empty()) {
+        start();
+    }
+
+    int numInputs = getNumInputs();
+    int sample    = 0;
+    while (sample < batchSize_) {
+        size_t numSamplesInChunk = currentChunk.numSamples;
+        if (positionInChunk >= numSamplesInChunk) {
+            if (!generatedChunks->pop(currentChunk)) {
+                return;
+            }
+            positionInChunk = 0;
+            continue;
+        }
+
+        // take as many samples of the current chunk as possible
+        int numSamplesToCopy = (int)min<size_t>(batchSize_ - sample,numSamplesInChunk - positionInChunk);
+        copy_n(&currentChunk.inputValues[positionInChunk * numInputs],numSamplesToCopy * numInputs,
+               &inputValues_[sample * numInputs]);
+        copy_n(&currentChunk.outputValues[positionInChunk * numOutputs],numSamplesToCopy * numOutputs,
+               &outputValues_[sample * numOutputs]);
+        positionInChunk += numSamplesToCopy;
+        sample          += numSamplesToCopy;
+    }
+}
+
+/**
+ * @brief GeneratorDataSource::start starts the producer threads
+ */
+void GeneratorDataSource::start() {
+    int numThreads_l = numThreads;
+    if (numThreads_l <= 0) {
+        numThreads_l = max(1u,thread::hardware_concurrency());
+    }
+
+    // two chunks per producer keep all producers busy while the consumer copies
+    generatedChunks.reset(new BoundedQueue<Chunk>(2 * numThreads_l));
+    for (int i = 0; i < numThreads_l; i++) {
+        producers.push_back(thread(&GeneratorDataSource::produce,this,i));
+    }
+}
+
+/**
+ * @brief GeneratorDataSource::produce generates chunks of samples until the source is destroyed
+ * @param producerIndex_ index of the producer, used for seeding its random generator
+ */
+void GeneratorDataSource::produce(int producerIndex_) {
+    int numInputs = getNumInputs();
+    mt19937_64 generator(seed ^ ((producerIndex_ + 1) * 0x9E3779B97F4A7C15ULL));
+    uniform_real_distribution<double> unit(0.0,1.0);
+
+    vector<double> inputValues(numInputs);
+    while (true) {
+        Chunk chunk;
+        chunk.numSamples = chunkSize;
+        chunk.inputValues.resize(chunkSize * numInputs);
+        chunk.outputValues.resize(chunkSize * numOutputs);
+        for (int i = 0; i < chunkSize; i++) {
+            for (int j = 0; j < numInputs; j++) {
+                inputValues[j] = domain.lowerBounds[j] + unit(generator) * domain.width(j);
+                chunk.inputValues[i * numInputs + j] = inputValues[j];
+            }
+            vector<double> outputValues = targetFunction(inputValues);
+            for (int j = 0; j < numOutputs; j++) {
+                chunk.outputValues[i * numOutputs + j] = (j < (int)outputValues.size()) ? outputValues[j] : 0.0;
+            }
+        }
+        if (!generatedChunks->push(std::move(chunk))) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,227 @@
+#include "IntervalVerifier.h"
+
+// STL
+#include <queue>
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+/* --- constructors / destructors --- */
+
+/**
+ * @brief IntervalVerifier::IntervalVerifier constructor of class IntervalVerifier
+ * @param mlp_ the net which is to verify
+ *
+ * NOTICE : mlp_ is not copied, therefore it has to outlive the verifier
+ */
+IntervalVerifier::IntervalVerifier(const MLP& mlp_)
+    : mlp(mlp_), tolerance(0.001), maxBoxes(100000), lipschitzConstant(0) {
+}
+
+/* --- getter / setter --- */
+
+/**
+ * @brief IntervalVerifier::setReferenceFunction sets the function the net approximates
+ * @param referenceFunction_ function which calculates the expected output values for an input value
+ * @param lipschitzConstant_ L with |reference(x) - reference(y)| <= L * max_i |x_i - y_i| for every output
+ *
+ * The reference function is bounded over a box by reference(center) +- L * (half of the largest width).
+ * If an interval extension has been set by setReferenceBounds it is used instead.
+ */
+void IntervalVerifier::setReferenceFunction(const function<vector<double>(const vector<double>&)>& referenceFunction_, double lipschitzConstant_) {
+    referenceFunction = referenceFunction_;
+    lipschitzConstant = lipschitzConstant_;
+}
+
+/* --- verification --- */
+
+/**
+ * @brief IntervalVerifier::propagate calculates bounds of every output neuron over box_
+ * @param box_ box of input values
+ * @return returns one interval per output neuron which contains all output values for inputs within box_
+ *
+ * Every interval is represented by its center m and its radius r. An InnerProduct layer maps
+ *     m -> W * m + b
+ *     r -> |W| * r
+ * which is the tightest box containing the image of the input box. The activation functions
+ * are monotonically non-decreasing (MLP refuses ReLU with a negative slope), therefore they are applied to both ends of the interval.
+ */
+vector<IntervalVerifier::Interval> IntervalVerifier::propagate(const Domain& box_) const {
+    vector<double> center = box_.center();
+    vector<double> radius(center.size());
+    for (unsigned int i = 0; i < radius.size(); i++) {
+        radius[i] = 0.5 * box_.width(i);
+    }
+
+    const vector<MLP::DenseLayer>& layers = mlp.getLayers();
+    vector<double> nextCenter;
+    vector<double> nextRadius;
+    for (unsigned int l = 0; l < layers.size(); l++) {
+        const MLP::DenseLayer& layer = layers[l];
+        nextCenter.assign(layer.numOutputs,0.0);
+        nextRadius.assign(layer.numOutputs,0.0);
+
+        for (int o = 0; o < layer.numOutputs; o++) {
+            const double* weightRow = &layer.weights[o * layer.numInputs];
+            double c = layer.biases[o];
+            double r = 0;
+            for (int i = 0; i < layer.numInputs; i++) {
+                c += weightRow[i] * center[i];
+                r += fabs(weightRow[i]) * radius[i];
+            }
+
+            // apply the non-decreasing activation to both ends of the interval
+            double lower = MLP::activate(layer.activation,c - r,layer.negativeSlope);
+            double upper = MLP::activate(layer.activation,c + r,layer.negativeSlope);
+            nextCenter[o] = 0.5 * (lower + upper);
+            nextRadius[o] = 0.5 * (upper - lower);
+        }
+
+        center.swap(nextCenter);
+        radius.swap(nextRadius);
+    }
+
+    vector<Interval> result(center.size());
+    for (unsigned int o = 0; o < center.size(); o++) {
+        result[o] = Interval(center[o] - radius[o],center[o] + radius[o]);
+    }
+    return result;
+}
+
+/**
+ * @brief IntervalVerifier::certifyMaxError encloses the maximum approximation error over domain_
+ * @param domain_ box of input values the error is to certify on
+ * @return returns the certified bounds of the maximum error
+ *
+ * Branch and bound :
+ *   1. every box gets an error bound by interval bound propagation
+ *      and an observed error at its center
+ *   2. the box with the largest error bound is taken out of the priority queue
+ *   3. if its bound exceeds the largest observed error by no more than tolerance,
+ *      the maximum error is certified, otherwise the box is split in halves along
+ *      its widest dimension and both halves are evaluated by step 1
+ *
+ * NOTICE : if maxBoxes boxes have been evaluated before the tolerance is reached, the function
+ *          stops and returns the bounds reached so far with result.certified == false. The
+ *          upper bound is guaranteed in any case.
+ *
+ * NOTICE : without a reference function, or if the reference does not return one finite
+ *          value or interval per output of the net, the function prints an error and returns
+ *          an uncertified result with an infinite upper bound
+ */
+IntervalVerifier::Result IntervalVerifier::certifyMaxError(const Domain& domain_) const {
+    Result result;
+    result.upperBound = numeric_limits<double>::infinity();
+
+    if (!referenceFunction && !referenceBounds) {
+        cout << "Error : no reference function has been set" << endl;
+        return result;
+    }
+    if (domain_.dimension() != mlp.getNumInputs()) {
+        cout << "Error : dimension of the domain does not fit to the number of inputs" << endl;
+        return result;
+    }
+
+    priority_queue<Box> boxes;
+    boxes.push(evaluateBox(domain_,result));
+
+    while (true) {
+        Box box = boxes.top();
+        result.upperBound = max(box.errorBound,result.lowerBound);
+
+        // the reference could not bound the error of the box, splitting it does not help
+        if (std::isinf(box.errorBound)) {
+            cout << "Error : the reference does not return one finite bound per output of the net" << endl;
+            return result;
+        }
+
+        // the largest bound is close enough to the largest observed error
+        if (result.upperBound - result.lowerBound <= tolerance) {
+            result.certified = true;
+            return result;
+        }
+        if (result.numBoxes >= maxBoxes) {
+            return result;
+        }
+        boxes.pop();
+
+        // split box at the center of its widest dimension
+        int splitDimension = 0;
+        for (int i = 1; i < box.domain.dimension(); i++) {
+            if (box.domain.width(i) > box.domain.width(splitDimension)) {
+                splitDimension = i;
+            }
+        }
+        double splitValue = 0.5 * (box.domain.lowerBounds[splitDimension] + box.domain.upperBounds[splitDimension]);
+
+        Domain lowerHalf = box.domain;
+        Domain upperHalf = box.domain;
+        lowerHalf.upperBounds[splitDimension] = splitValue;
+        upperHalf.lowerBounds[splitDimension] = splitValue;
+
+        boxes.push(evaluateBox(lowerHalf,result));
+        boxes.push(evaluateBox(upperHalf,result));
+    }
+}
+
+/**
+ * @brief IntervalVerifier::evaluateBox calculates the error bound of box_ and
+ *        updates the largest observed error in result_
+ */
+IntervalVerifier::Box IntervalVerifier::evaluateBox(const Domain& box_, Result& result_) const {
+    result_.numBoxes++;
+
+    vector<double> center = box_.center();
+    vector<double> annAtCenter = mlp.forward(center);
+
+    // bounds of the reference function over the box
+    vector<Interval> reference;
+    vector<double> referenceAtCenter;
+    if (referenceFunction) {
+        referenceAtCenter = referenceFunction(center);
+    }
+    if (referenceBounds) {
+        reference = referenceBounds(box_);
+    } else {
+        double maxRadius = 0;
+        for (int i = 0; i < box_.dimension(); i++) {
+            maxRadius = max(maxRadius,0.5 * box_.width(i));
+        }
+        reference.resize(referenceAtCenter.size());
+        for (unsigned int o = 0; o < referenceAtCenter.size(); o++) {
+            reference[o] = Interval(referenceAtCenter[o] - lipschitzConstant * maxRadius,
+                                    referenceAtCenter[o] + lipschitzConstant * maxRadius);
+        }
+    }
+
+    // observed error at the center
+    if (!referenceAtCenter.empty()) {
+        for (unsigned int o = 0; o < annAtCenter.size() && o < referenceAtCenter.size(); o++) {
+            double error = fabs(annAtCenter[o] - referenceAtCenter[o]);
+            if (error > result_.lowerBound || result_.worstInput.empty()) {
+                result_.lowerBound = max(error,result_.lowerBound);
+                result_.worstInput = center;
+            }
+        }
+    }
+
+    // bound of the error over the box
+    vector<Interval> ann = propagate(box_);
+    Box result;
+    result.domain     = box_;
+    result.errorBound = 0;
+    // a reference of the wrong size or a NaN bound must never certify the box
+    if (reference.size() != ann.size()) {
+        result.errorBound = numeric_limits<double>::infinity();
+        return result;
+    }
+    for (unsigned int o = 0; o < ann.size(); o++) {
+        double bound = max(ann[o].upper - reference[o].lower, reference[o].upper - ann[o].lower);
+        if (std::isnan(bound)) {
+            bound = numeric_limits<double>::infinity();
+        }
+        result.errorBound = max(result.errorBound,bound);
+    }
+    return result;
+}
@@ -0,0 +1,297 @@
+#include "LBFGS.h"
+
+// STL
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+
+/* --- constructors / destructors --- */
+
+/**
+ * @brief LBFGS::LBFGS constructor with the default settings
+ *        (history of 10 pairs, at most 1000 iterations, c1 = 1e-4 and c2 = 0.9)
+ */
+LBFGS::LBFGS()
+    : historySize(10), maxIterations(1000), gradientTolerance(1e-10), tolerance(1e-12), c1(1e-4), c2(0.9), maxLineSearchEvaluations(25) {
+}
+
+/* --- minimization --- */
+
+/**
+ * @brief LBFGS::minimize minimizes objective_ starting at x_
+ * @param x_         start point, it is set to the best point found
+ * @param objective_ function value and gradient
+ * @param report_    is set to the statistics of the minimization
+ * @return returns false if the function value or the gradient at the start point is not finite,
+ *         otherwise true
+ *
+ * The minimization stops after getMaxIterations() iterations, if the gradient vanishes (see
+ * setGradientTolerance), if an iteration does not change the function value noticeably (see
+ * setTolerance) or if the line search fails even along the steepest descent direction. In all
+ * but the first case report_.converged is true.
+ */
+bool LBFGS::minimize(vector<double>& x_, const Objective& objective_, Report& report_) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    size_t n = x_.size();
+    report_ = Report();
+
+    Point current;
+    current.t        = 0;
+    current.x        = x_;
+    current.gradient.assign(n,0.0);
+    current.value    = objective_(current.x,current.gradient);
+    report_.numEvaluations = 1;
+    report_.initialLoss    = current.value;
+    if (!isfinite(current.value) || !isfinite(dot(current.gradient,current.gradient))) {
+        return false;
+    }
+
+    // history of the last pairs (s, y) and 1 / s^T y
+    deque<vector<double>> steps, gradientChanges;
+    deque<double>         rhos;
+    vector<double>        direction(n), alphas;
+
+    auto maximumNorm = [](const vector<double>& vector_) {
+        double norm = 0;
+        for (double value : vector_) {
+            norm = max(norm,fabs(value));
+        }
+        return norm;
+    };
+
+    report_.converged = maximumNorm(current.gradient) <= gradientTolerance;
+    while (!report_.converged && report_.numIterations < maxIterations) {
+        // two-loop recursion : direction = -H * gradient
+        for (size_t i = 0; i < n; i++) {
+            direction[i] = -current.gradient[i];
+        }
+        alphas.resize(steps.size());
+        for (int k = steps.size() - 1; k >= 0; k--) {
+            alphas[k] = rhos[k] * dot(steps[k],direction);
+            for (size_t i = 0; i < n; i++) {
+                direction[i] -= alphas[k] * gradientChanges[k][i];
+            }
+        }
+        if (!steps.empty()) {
+            // initial Hessian : scaled identity, which gives steps of about the right length
+            double gamma = dot(steps.back(),gradientChanges.back()) / dot(gradientChanges.back(),gradientChanges.back());
+            for (size_t i = 0; i < n; i++) {
+                direction[i] *= gamma;
+            }
+        }
+        for (size_t k = 0; k < steps.size(); k++) {
+            double beta = rhos[k] * dot(gradientChanges[k],direction);
+            for (size_t i = 0; i < n; i++) {
+                direction[i] += (alphas[k] - beta) * steps[k][i];
+            }
+        }
+
+        // the first step along the gradient has no scale, therefore it is limited to a length of 1
+        current.slope = dot(current.gradient,direction);
+        if (!(current.slope < 0)) {
+            // the approximation has lost positive definiteness (rounding), use steepest descent
+            for (size_t i = 0; i < n; i++) {
+                direction[i] = -current.gradient[i];
+            }
+            current.slope = -dot(current.gradient,current.gradient);
+            steps.clear();
+            gradientChanges.clear();
+            rhos.clear();
+        }
+        double initialStep = 1.0;
+        if (steps.empty()) {
+            initialStep = min(1.0,1.0 / sqrt(dot(current.gradient,current.gradient)));
+        }
+
+        Point next;
+        if (!lineSearch(current,direction,initialStep,objective_,next,report_.numEvaluations)) {
+            if (steps.empty()) {
+                // not even the steepest descent direction reduces the function : minimum up to
+                // the precision of the function values
+                report_.converged = true;
+                break;
+            }
+            // the approximation of the Hessian is not useful any more, restart from steepest descent
+            steps.clear();
+            gradientChanges.clear();
+            rhos.clear();
+            continue;
+        }
+        report_.numIterations++;
+
+        vector<double> step(n), gradientChange(n);
+        for (size_t i = 0; i < n; i++) {
+            step[i]           = next.x[i] - current.x[i];
+            gradientChange[i] = next.gradient[i] - current.gradient[i];
+        }
+        double curvature = dot(step,gradientChange);
+        if (curvature > 1e-12 * dot(gradientChange,gradientChange)) {
+            steps.push_back(step);
+            gradientChanges.push_back(gradientChange);
+            rhos.push_back(1.0 / curvature);
+            if ((int)steps.size() > historySize) {
+                steps.pop_front();
+                gradientChanges.pop_front();
+                rhos.pop_front();
+            }
+        }
+
+        double change = current.value - next.value;
+        current = next;
+        current.t = 0;
+        report_.converged = maximumNorm(current.gradient) <= gradientTolerance ||
+                            change <= tolerance * max(fabs(current.value),1e-300);
+    }
+
+    x_ = current.x;
+    report_.loss         = current.value;
+    report_.gradientNorm = maximumNorm(current.gradient);
+    report_.seconds      = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+/**
+ * @brief LBFGS::Report::print writes a compact summary of the report to oStream_
+ */
+void LBFGS::Report::print(ostream& oStream_) const {
+    oStream_ << "iterations    : " << numIterations << (converged ? " (converged)" : " (not converged)") << endl;
+    oStream_ << "evaluations   : " << numEvaluations << endl;
+    oStream_ << "initial loss  : " << initialLoss    << endl;
+    oStream_ << "loss          : " << loss           << endl;
+    oStream_ << "gradient norm : " << gradientNorm   << endl;
+    oStream_ << "seconds       : " << seconds        << endl;
+}
+
+/* --- miscellaneous --- */
+
+/**
+ * @brief LBFGS::lineSearch finds a step length along direction_ which satisfies the strong Wolfe conditions
+ * @param start_          point at step length 0
+ * @param direction_      search direction, it has to be a descent direction
+ * @param initialStep_    first step length to try
+ * @param result_         is set to the accepted point
+ * @param numEvaluations_ is increased by the number of evaluations of objective_
+ * @return returns true if a step length has been found, otherwise false
+ *
+ * The step length is increased until the minimum along direction_ is bracketed, afterwards
+ * the bracket is reduced (zoom) until both conditions are satisfied.
+ */
+bool LBFGS::lineSearch(const Point& start_, const vector<double>& direction_, double initialStep_,
+                       const Objective& objective_, Point& result_, int& numEvaluations_) const {
+    double decrease = c1 * start_.slope;
+    double curvature = -c2 * start_.slope;
+    auto sufficient = [&](const Point& point_) {
+        return point_.value <= start_.value + point_.t * decrease;
+    };
+
+    // bracketing : increase the step length until the interval (low, high) contains acceptable step lengths
+    Point low = start_;
+    Point high;
+    bool bracketed = false;
+    double t = initialStep_;
+    int evaluations = 0;
+    while (evaluations < maxLineSearchEvaluations) {
+        Point point;
+        evaluate(start_,direction_,t,objective_,point);
+        evaluations++;
+        if (!sufficient(point) || (evaluations > 1 && point.value >= low.value)) {
+            high = point;
+            bracketed = true;
+            break;
+        }
+        if (fabs(point.slope) <= curvature) {
+            result_ = point;
+            numEvaluations_ += evaluations;
+            return true;
+        }
+        if (point.slope >= 0) {
+            high = low;
+            low  = point;
+            bracketed = true;
+            break;
+        }
+        low = point;
+        t *= 2;
+    }
+
+    // zoom : low always satisfies the sufficient decrease and has the lowest value so far
+    while (bracketed && evaluations < maxLineSearchEvaluations && fabs(high.t - low.t) > 1e-16 * max(1.0,low.t)) {
+        Point point;
+        evaluate(start_,direction_,interpolate(low,high),objective_,point);
+        evaluations++;
+        if (!sufficient(point) || point.value >= low.value) {
+            high = point;
+        } else {
+            if (fabs(point.slope) <= curvature) {
+                result_ = point;
+                numEvaluations_ += evaluations;
+                return true;
+            }
+            if (point.slope * (high.t - low.t) >= 0) {
+                high = low;
+            }
+            low = point;
+        }
+    }
+    numEvaluations_ += evaluations;
+
+    // no step length satisfies both conditions within the evaluations, a step with sufficient
+    // decrease is still accepted (the curvature pair is only stored if s^T y > 0)
+    if (low.t > 0 && low.value < start_.value) {
+        result_ = low;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief LBFGS::evaluate evaluates objective_ at start_.x + t_ * direction_
+ */
+void LBFGS::evaluate(const Point& start_, const vector<double>& direction_, double t_,
+                     const Objective& objective_, Point& point_) const {
+    point_.t = t_;
+    point_.x.resize(start_.x.size());
+    for (size_t i = 0; i < point_.x.size(); i++) {
+        point_.x[i] = start_.x[i] + t_ * direction_[i];
+    }
+    point_.gradient.resize(start_.x.size());
+    point_.value = objective_(point_.x,point_.gradient);
+    point_.slope = dot(point_.gradient,direction_);
+}
+
+/**
+ * @brief LBFGS::interpolate returns the minimizer of the cubic interpolating the values and slopes of a_ and b_
+ *
+ * The result is kept away from the ends of the interval by 10% of its length, otherwise
+ * (or if the cubic has no minimizer) the center of the interval is returned.
+ */
+double LBFGS::interpolate(const Point& a_, const Point& b_) {
+    double low  = min(a_.t,b_.t);
+    double high = max(a_.t,b_.t);
+    double d1 = a_.slope + b_.slope - 3 * (a_.value - b_.value) / (a_.t - b_.t);
+    double d2Squared = d1 * d1 - a_.slope * b_.slope;
+    double t = 0.5 * (low + high);
+    if (d2Squared >= 0) {
+        double d2 = sqrt(d2Squared) * (b_.t > a_.t ? 1 : -1);
+        double denominator = b_.slope - a_.slope + 2 * d2;
+        if (denominator != 0) {
+            t = b_.t - (b_.t - a_.t) * (b_.slope + d2 - d1) / denominator;
+        }
+    }
+    double margin = 0.1 * (high - low);
+    if (!(t >= low + margin && t <= high - margin)) {
+        t = 0.5 * (low + high);
+    }
+    return t;
+}
+
+/**
+ * @brief LBFGS::dot returns the scalar product of a_ and b_
+ */
+double LBFGS::dot(const vector<double>& a_, const vector<double>& b_) {
+    double sum = 0;
+    for (size_t i = 0; i < a_.size(); i++) {
+        sum += a_[i] * b_[i];
+    }
+    return sum;
+}
@@ -0,0 +1,311 @@
+#include "LevenbergMarquardt.h"
+
+// STL
+#include <cmath>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+// own
+#include "LinearAlgebra.h"
+
+/* --- constructors / destructors --- */
+
+/**
+ * @brief LevenbergMarquardt::LevenbergMarquardt constructor with the default settings
+ *        (at most 1000 iterations, initial damping 1e-3, damping factor 10, relative tolerance 1e-12)
+ */
+LevenbergMarquardt::LevenbergMarquardt()
+    : maxIterations(1000), initialDamping(1e-3), dampingFactor(10), maxDamping(1e12), tolerance(1e-12), numThreads(0) {
+}
+
+/* --- training --- */
+
+/**
+ * @brief LevenbergMarquardt::train optimizes the weights of mlp_ for the given samples
+ * @param mlp_                  MLP whose weights are optimized, it is set to the best weights found
+ * @param inputValues_          input values, one row of mlp_.getNumInputs() values per sample
+ * @param expectedOutputValues_ expected output values, one row of mlp_.getNumOutputs() values per sample
+ * @param report_               is set to the statistics of the training
+ * @return returns true if the training has been run, otherwise false (sizes do not fit)
+ *
+ * The training stops after getMaxIterations() iterations, if an accepted step does not reduce
+ * the loss noticeably (see setTolerance) or if the damping exceeds getMaxDamping(), i.e. no
+ * step reduces the loss any more. In the last two cases report_.converged is true.
+ */
+bool LevenbergMarquardt::train(MLP& mlp_, const MatrixView& inputValues_, const MatrixView& expectedOutputValues_, Report& report_) {
+    if (inputValues_.getNumColumns() != mlp_.getNumInputs() || expectedOutputValues_.getNumColumns() != mlp_.getNumOutputs() ||
+        inputValues_.getNumRows() != expectedOutputValues_.getNumRows() || inputValues_.isEmpty()) {
+        cout << "Error : the samples do not fit to the inputs and outputs of the MLP" << endl;
+        return false;
+    }
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    int numParameters = mlp_.getNumParameters();
+    vector<double> parameters = mlp_.getParameters();
+    vector<double> hessian, gradient, damped, step;
+    double currentLoss = normalEquations(mlp_,inputValues_,expectedOutputValues_,hessian,gradient);
+
+    report_ = Report();
+    report_.initialLoss = currentLoss;
+    double damping = initialDamping;
+
+    while (report_.numIterations < maxIterations) {
+        report_.numIterations++;
+
+        // the diagonal is bounded from below, otherwise weights without influence (e.g. of a
+        // saturated neuron) would make the damped matrix singular
+        double maxDiagonal = 0;
+        for (int i = 0; i < numParameters; i++) {
+            maxDiagonal = max(maxDiagonal,hessian[i * numParameters + i]);
+        }
+        double minDiagonal = max(maxDiagonal * 1e-9,1e-12);
+
+        // damped normal equations, increase the damping until the step reduces the loss
+        bool accepted = false;
+        while (!accepted && damping <= maxDamping) {
+            damped = hessian;
+            step.resize(numParameters);
+            for (int i = 0; i < numParameters; i++) {
+                damped[i * numParameters + i] += damping * max(hessian[i * numParameters + i],minDiagonal);
+                step[i] = -gradient[i];
+            }
+            if (LinearAlgebra::solveCholesky(damped,numParameters,step)) {
+                vector<double> candidate(numParameters);
+                for (int i = 0; i < numParameters; i++) {
+                    candidate[i] = parameters[i] + step[i];
+                }
+                mlp_.setParameters(candidate);
+                double candidateLoss = loss(mlp_,inputValues_,expectedOutputValues_);
+                if (candidateLoss < currentLoss) {
+                    accepted = true;
+                    damping  = max(damping / dampingFactor,1e-15);
+                    parameters.swap(candidate);
+                    double improvement = currentLoss - candidateLoss;
+                    currentLoss = normalEquations(mlp_,inputValues_,expectedOutputValues_,hessian,gradient);
+                    if (improvement <= tolerance * candidateLoss) {
+                        report_.converged = true;
+                    }
+                    break;
+                }
+            }
+            damping *= dampingFactor;
+        }
+
+        if (!accepted) {
+            // no step reduces the loss any more : minimum (up to the precision of the loss)
+            mlp_.setParameters(parameters);
+            report_.converged = true;
+        }
+        if (report_.converged) {
+            break;
+        }
+    }
+
+    report_.loss    = currentLoss;
+    report_.damping = damping;
+    report_.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+/**
+ * @brief LevenbergMarquardt::Report::print writes a compact summary of the report to oStream_
+ */
+void LevenbergMarquardt::Report::print(ostream& oStream_) const {
+    oStream_ << "iterations   : " << numIterations << (converged ? " (converged)" : " (not converged)") << endl;
+    oStream_ << "initial loss : " << initialLoss   << endl;
+    oStream_ << "loss         : " << loss          << endl;
+    oStream_ << "damping      : " << damping       << endl;
+    oStream_ << "seconds      : " << seconds       << endl;
+}
+
+/* --- miscellaneous --- */
+
+/**
+ * @brief LevenbergMarquardt::resolveNumThreads returns the number of threads to use (getNumThreads(), 0 : all cores)
+ */
+int LevenbergMarquardt::resolveNumThreads() const {
+    return numThreads > 0 ? numThreads : max(1u,thread::hardware_concurrency());
+}
+
+/**
+ * @brief LevenbergMarquardt::loss returns the EuclideanLoss of mlp_ for the given samples
+ */
+double LevenbergMarquardt::loss(const MLP& mlp_, const MatrixView& inputValues_, const MatrixView& expectedOutputValues_) const {
+    size_t numSamples = inputValues_.getNumRows();
+    int    numThreads_l = min<size_t>(resolveNumThreads(),max<size_t>(numSamples / 256,1));
+    vector<double> sums(numThreads_l,0.0);
+    vector<thread> threads;
+    for (int t = 0; t < numThreads_l; t++) {
+        threads.emplace_back([&, t]() {
+            size_t first = numSamples * t / numThreads_l;
+            size_t last  = numSamples * (t + 1) / numThreads_l;
+            vector<double> outputValues((last - first) * mlp_.getNumOutputs());
+            mlp_.forward(inputValues_.row(first),last - first,outputValues.data());
+            const double* expected = expectedOutputValues_.row(first);
+            for (size_t i = 0; i < outputValues.size(); i++) {
+                sums[t] += (outputValues[i] - expected[i]) * (outputValues[i] - expected[i]);
+            }
+        });
+    }
+    for (thread& t : threads) {
+        t.join();
+    }
+    double sum = 0;
+    for (double partialSum : sums) {
+        sum += partialSum;
+    }
+    return sum / (2.0 * numSamples);
+}
+
+/**
+ * @brief LevenbergMarquardt::normalEquations calculates J^T J and J^T r of all samples and returns the loss
+ *
+ * Every thread accumulates the samples of its part into own matrices, which are summed afterwards.
+ * Both are scaled like the loss (by 1 / samples), which does not change the steps.
+ */
+double LevenbergMarquardt::normalEquations(const MLP& mlp_, const MatrixView& inputValues_, const MatrixView& expectedOutputValues_,
+                                           vector<double>& hessian_, vector<double>& gradient_) const {
+    size_t numSamples    = inputValues_.getNumRows();
+    int    numParameters = mlp_.getNumParameters();
+    int    numThreads_l  = min<size_t>(resolveNumThreads(),max<size_t>(numSamples / 64,1));
+
+    vector<vector<double>> hessians(numThreads_l), gradients(numThreads_l);
+    vector<double> sums(numThreads_l);
+    vector<thread> threads;
+    for (int t = 0; t < numThreads_l; t++) {
+        threads.emplace_back([&, t]() {
+            size_t first = numSamples * t / numThreads_l;
+            size_t last  = numSamples * (t + 1) / numThreads_l;
+            sums[t] = accumulate(mlp_,inputValues_.rows(first,last - first),expectedOutputValues_.rows(first,last - first),
+                                 hessians[t],gradients[t]);
+        });
+    }
+    for (thread& t : threads) {
+        t.join();
+    }
+
+    hessian_.swap(hessians[0]);
+    gradient_.swap(gradients[0]);
+    double sum = sums[0];
+    for (int t = 1; t < numThreads_l; t++) {
+        for (size_t i = 0; i < hessian_.size(); i++) {
+            hessian_[i] += hessians[t][i];
+        }
+        for (int i = 0; i < numParameters; i++) {
+            gradient_[i] += gradients[t][i];
+        }
+        sum += sums[t];
+    }
+
+    // only the upper triangle has been accumulated
+    for (int i = 0; i < numParameters; i++) {
+        for (int j = i; j < numParameters; j++) {
+            hessian_[i * numParameters + j] /= numSamples;
+            hessian_[j * numParameters + i]  = hessian_[i * numParameters + j];
+        }
+        gradient_[i] /= numSamples;
+    }
+    return sum / (2.0 * numSamples);
+}
+
+/**
+ * @brief LevenbergMarquardt::accumulate calculates the upper triangle of J^T J, J^T r and the sum of the squared residuals
+ *
+ * For every sample the activations and the derivatives of the activations of all layers are
+ * calculated. Then the derivatives of every output are propagated back through the layers,
+ * which gives one row of J (the derivatives of the output with respect to all weights and
+ * biases, in the order of MLP::getParameters).
+ */
+double LevenbergMarquardt::accumulate(const MLP& mlp_, const MatrixView& inputValues_, const MatrixView& expectedOutputValues_,
+                                      vector<double>& hessian_, vector<double>& gradient_) {
+    const vector<MLP::DenseLayer>& layers = mlp_.getLayers();
+    int numLayers     = layers.size();
+    int numParameters = mlp_.getNumParameters();
+    int numOutputs    = mlp_.getNumOutputs();
+    hessian_.assign(numParameters * numParameters,0.0);
+    gradient_.assign(numParameters,0.0);
+
+    // offset of the weights of every layer in the parameter vector
+    vector<int> offsets(numLayers);
+    for (int l = 0, offset = 0; l < numLayers; l++) {
+        offsets[l] = offset;
+        offset += layers[l].weights.size() + layers[l].biases.size();
+    }
+
+    vector<vector<double>> activations(numLayers), derivatives(numLayers);
+    vector<double> row(numParameters), delta, previousDelta;
+    double sumOfSquares = 0;
+
+    for (size_t s = 0; s < inputValues_.getNumRows(); s++) {
+        // forward, keeping the activations and their derivatives
+        const double* layerInput = inputValues_.row(s);
+        for (int l = 0; l < numLayers; l++) {
+            const MLP::DenseLayer& layer = layers[l];
+            activations[l].resize(layer.numOutputs);
+            derivatives[l].resize(layer.numOutputs);
+            for (int o = 0; o < layer.numOutputs; o++) {
+                const double* weightRow = &layer.weights[o * layer.numInputs];
+                double sum = layer.biases[o];
+                for (int i = 0; i < layer.numInputs; i++) {
+                    sum += weightRow[i] * layerInput[i];
+                }
+                double value = MLP::activate(layer.activation,sum,layer.negativeSlope);
+                activations[l][o] = value;
+                switch (layer.activation) {
+                    case MLP::TANH : derivatives[l][o] = 1.0 - value * value;                       break;
+                    case MLP::RELU : derivatives[l][o] = (sum > 0) ? 1.0 : layer.negativeSlope;    break;
+                    default        : derivatives[l][o] = 1.0;                                      break;
+                }
+            }
+            layerInput = activations[l].data();
+        }
+
+        // one row of J per output
+        for (int k = 0; k < numOutputs; k++) {
+            double residual = activations[numLayers - 1][k] - expectedOutputValues_(s,k);
+            sumOfSquares += residual * residual;
+
+            delta.assign(numOutputs,0.0);
+            delta[k] = derivatives[numLayers - 1][k];
+            for (int l = numLayers - 1; l >= 0; l--) {
+                const MLP::DenseLayer& layer = layers[l];
+                const double* input = (l > 0) ? activations[l - 1].data() : inputValues_.row(s);
+                double* weightRow = &row[offsets[l]];
+                double* biasRow   = weightRow + layer.weights.size();
+                for (int o = 0; o < layer.numOutputs; o++) {
+                    for (int i = 0; i < layer.numInputs; i++) {
+                        weightRow[o * layer.numInputs + i] = delta[o] * input[i];
+                    }
+                    biasRow[o] = delta[o];
+                }
+                if (l > 0) {
+                    previousDelta.assign(layer.numInputs,0.0);
+                    for (int o = 0; o < layer.numOutputs; o++) {
+                        const double* weights = &layer.weights[o * layer.numInputs];
+                        for (int i = 0; i < layer.numInputs; i++) {
+                            previousDelta[i] += weights[i] * delta[o];
+                        }
+                    }
+                    for (int i = 0; i < layer.numInputs; i++) {
+                        previousDelta[i] *= derivatives[l - 1][i];
+                    }
+                    delta.swap(previousDelta);
+                }
+            }
+
+            // upper triangle of row * row^T, zero entries (e.g. inactive ReLUs) are skipped
+            for (int i = 0; i < numParameters; i++) {
+                double value = row[i];
+                if (value == 0) {
+                    continue;
+                }
+                gradient_[i] += value * residual;
+                double* hessianRow = &hessian_[i * numParameters];
+                for (int j = i; j < numParameters; j++) {
+                    hessianRow[j] += value * row[j];
+                }
+            }
+        }
+    }
+    return sumOfSquares;
+}
@@ -0,0 +1,157 @@
+#include "LinearAlgebra.h"
+
+// STL
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+
+/**
+ * @brief LinearAlgebra::singularValueDecomposition decomposes matrix_ into u_ * diag(singularValues_) * v_^T
+ * @param matrix_         numRows_ x numColumns_ matrix which is to decompose
+ * @param numRows_        number of rows of matrix_
+ * @param numColumns_     number of columns of matrix_
+ * @param u_              numRows_ x rank matrix of left singular vectors (orthonormal columns)
+ * @param singularValues_ rank singular values in descending order
+ * @param v_              numColumns_ x rank matrix of right singular vectors (orthonormal columns)
+ *
+ * with rank = min(numRows_, numColumns_).
+ *
+ * The decomposition is calculated by the one-sided Jacobi method (Hestenes) : pairs of columns
+ * are rotated until all columns are orthogonal to each other. The norms of the columns are the
+ * singular values. The method is slow for big matrices, but very accurate, which is what matters
+ * for truncating weight matrices.
+ */
+void LinearAlgebra::singularValueDecomposition(const vector<double>& matrix_, int numRows_, int numColumns_,
+                                               vector<double>& u_, vector<double>& singularValues_, vector<double>& v_) {
+    // the columns of the working matrix are orthogonalized, therefore it needs at least as many rows as columns
+    bool transposed = (numRows_ < numColumns_);
+    int m = transposed ? numColumns_ : numRows_;
+    int n = transposed ? numRows_    : numColumns_;
+
+    vector<double> a(m * n);
+    for (int i = 0; i < numRows_; i++) {
+        for (int j = 0; j < numColumns_; j++) {
+            if (transposed) {
+                a[j * n + i] = matrix_[i * numColumns_ + j];
+            } else {
+                a[i * n + j] = matrix_[i * numColumns_ + j];
+            }
+        }
+    }
+    vector<double> v(n * n,0.0);
+    for (int i = 0; i < n; i++) {
+        v[i * n + i] = 1.0;
+    }
+
+    // rotate pairs of columns until they are orthogonal
+    const double epsilon = 1e-15;
+    for (int sweep = 0; sweep < 100; sweep++) {
+        bool rotated = false;
+        for (int p = 0; p < n - 1; p++) {
+            for (int q = p + 1; q < n; q++) {
+                double alpha = 0;
+                double beta  = 0;
+                double gamma = 0;
+                for (int i = 0; i < m; i++) {
+                    alpha += a[i * n + p] * a[i * n + p];
+                    beta  += a[i * n + q] * a[i * n + q];
+                    gamma += a[i * n + p] * a[i * n + q];
+                }
+                if (fabs(gamma) <= epsilon * sqrt(alpha * beta) || gamma == 0) {
+                    continue;
+                }
+                rotated = true;
+
+                double zeta = (beta - alpha) / (2.0 * gamma);
+                double t    = ((zeta >= 0) ? 1.0 : -1.0) / (fabs(zeta) + sqrt(1.0 + zeta * zeta));
+                double c    = 1.0 / sqrt(1.0 + t * t);
+                double s    = c * t;
+                for (int i = 0; i < m; i++) {
+                    double ap = a[i * n + p];
+                    double aq = a[i * n + q];
+                    a[i * n + p] = c * ap - s * aq;
+                    a[i * n + q] = s * ap + c * aq;
+                }
+                for (int i = 0; i < n; i++) {
+                    double vp = v[i * n + p];
+                    double vq = v[i * n + q];
+                    v[i * n + p] = c * vp - s * vq;
+                    v[i * n + q] = s * vp + c * vq;
+                }
+            }
+        }
+        if (!rotated) {
+            break;
+        }
+    }
+
+    // singular values are the norms of the columns, sorted in descending order
+    vector<double> norms(n);
+    for (int j = 0; j < n; j++) {
+        double sum = 0;
+        for (int i = 0; i < m; i++) {
+            sum += a[i * n + j] * a[i * n + j];
+        }
+        norms[j] = sqrt(sum);
+    }
+    vector<int> order(n);
+    iota(order.begin(),order.end(),0);
+    sort(order.begin(),order.end(),[&norms](int a_, int b_) { return norms[a_] > norms[b_]; });
+
+    // a = U * S, v = V  --> for the transposed matrix U and V swap their roles
+    int rank = n;
+    vector<double>& left  = transposed ? v_ : u_;
+    vector<double>& right = transposed ? u_ : v_;
+    left.assign(m * rank,0.0);
+    right.assign(n * rank,0.0);
+    singularValues_.assign(rank,0.0);
+    for (int k = 0; k < rank; k++) {
+        int j = order[k];
+        singularValues_[k] = norms[j];
+        for (int i = 0; i < m; i++) {
+            left[i * rank + k] = (norms[j] > 0) ? a[i * n + j] / norms[j] : 0.0;
+        }
+        for (int i = 0; i < n; i++) {
+            right[i * rank + k] = v[i * n + j];
+        }
+    }
+}
+
+/**
+ * @brief LinearAlgebra::solveCholesky solves matrix_ * x = rightHandSide_ for a symmetric positive definite matrix_
+ * @param matrix_        size_ x size_ symmetric matrix, it is overwritten by its Cholesky factor L (lower triangle)
+ * @param size_          number of rows and columns of matrix_
+ * @param rightHandSide_ right hand side, it is overwritten by the solution x
+ * @return returns true if matrix_ is positive definite, otherwise false (both arguments are undefined then)
+ *
+ * matrix_ is decomposed into L * L^T, afterwards x is found by forward and backward substitution.
+ */
+bool LinearAlgebra::solveCholesky(vector<double>& matrix_, int size_, vector<double>& rightHandSide_) {
+    for (int j = 0; j < size_; j++) {
+        double* rowJ = &matrix_[j * size_];
+        double diagonal = rowJ[j] - inner_product(rowJ,rowJ + j,rowJ,0.0);
+        if (!(diagonal > 0)) {
+            return false;
+        }
+        rowJ[j] = sqrt(diagonal);
+        for (int i = j + 1; i < size_; i++) {
+            double* rowI = &matrix_[i * size_];
+            rowI[j] = (rowI[j] - inner_product(rowI,rowI + j,rowJ,0.0)) / rowJ[j];
+        }
+    }
+
+    // L * y = b
+    for (int i = 0; i < size_; i++) {
+        const double* rowI = &matrix_[i * size_];
+        rightHandSide_[i] = (rightHandSide_[i] - inner_product(rowI,rowI + i,rightHandSide_.begin(),0.0)) / rowI[i];
+    }
+    // L^T * x = y
+    for (int i = size_ - 1; i >= 0; i--) {
+        double sum = rightHandSide_[i];
+        for (int k = i + 1; k < size_; k++) {
+            sum -= matrix_[k * size_ + i] * rightHandSide_[k];
+        }
+        rightHandSide_[i] = sum / matrix_[i * size_ + i];
+    }
+    return true;
+}
@@ -0,0 +1,339 @@
+#include "LowRankCompressor.h"
+
+// STL
+#include <cmath>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+// caffe
+#include "caffe/util/io.hpp"
+// own
+#include "LinearAlgebra.h"
+
+/* --- constructors / destructors --- */
+
+/**
+ * @brief LowRankCompressor::LowRankCompressor constructor of class LowRankCompressor
+ * @param ann_ the trained net which is to compress
+ *
+ * The net structure and the trained weights are taken from ann_. The solver prototxt of ann_
+ * (if set) is used for fine-tuning. By default the error budget is 0.01 and the compressed net
+ * is fine-tuned for 10000 iterations.
+ */
+LowRankCompressor::LowRankCompressor(ANN& ann_)
+    : ann(ann_), errorBudget(0.01), fineTuningIterations(10000) {
+}
+
+/* --- compression --- */
+
+/**
+ * @brief LowRankCompressor::compress factorizes all hidden InnerProduct layers of the net which allow it
+ * @param inputValues_          samples the error is measured on
+ * @param expectedOutputValues_ expected output values of the samples
+ * @param outputPrefix_         prefix of the paths the compressed net is written to
+ * @param report_               error and number of multiply-adds of every layer
+ * @return returns true if the compressed net has been written, otherwise false
+ *
+ * The layers are treated one after another, the error of every candidate rank is measured with
+ * all previous layers already factorized. Therefore the error budget holds for the whole net and
+ * not only for a single layer.
+ *
+ * The first and the last InnerProduct layer are never factorized. They connect the few inputs
+ * and outputs of the function to the hidden layers and hardly save any work, but every error
+ * they introduce reaches the outputs directly.
+ *
+ * Fine-tuning trains the compressed net with the solver parameters of the ANN, but only for
+ * fineTuningIterations iterations. The fine-tuned weights are kept if they reduce the error.
+ * The snapshot of the fine-tuning (<outputPrefix_>_iter_<n>.*) is removed afterwards.
+ *
+ * If the ANN has been trained with normalization, the samples are normalized by its normalizers
+ * before they are propagated through the layers and the outputs are mapped back before they are
+ * compared. The normalizers are copied next to the compressed weights.
+ */
+bool LowRankCompressor::compress(const vector<vector<double>>& inputValues_, const vector<vector<double>>& expectedOutputValues_,
+                                 const string& outputPrefix_, Report& report_) {
+    report_ = Report();
+    if (inputValues_.empty() || inputValues_.size() != expectedOutputValues_.size()) {
+        cout << "Error : inputValues_ and expectedOutputValues_ have different lengths" << endl;
+        return false;
+    }
+
+    // the layers are factorized in the units of the net, the errors are measured in the original units
+    MLP original;
+    if (!original.loadFromNet(ann.loadNet())) {
+        return false;
+    }
+    vector<vector<double>> normalizedInputValues = ann.getInputNormalizer().transform(inputValues_);
+    report_.errorBefore = rootMeanSquareError(original,normalizedInputValues,expectedOutputValues_);
+
+    // every original layer is replaced either by itself or by a pair of layers
+    const vector<MLP::DenseLayer>& layers = original.getLayers();
+    vector<vector<MLP::DenseLayer> > replacements(layers.size());
+    for (unsigned int l = 0; l < layers.size(); l++) {
+        replacements[l].push_back(layers[l]);
+    }
+    auto assemble = [&replacements]() {
+        MLP result;
+        for (unsigned int l = 0; l < replacements.size(); l++) {
+            for (unsigned int r = 0; r < replacements[l].size(); r++) {
+                result.addLayer(replacements[l][r]);
+            }
+        }
+        return result;
+    };
+
+    for (unsigned int l = 0; l < layers.size(); l++) {
+        const MLP::DenseLayer& layer = layers[l];
+        LayerReport layerReport;
+        layerReport.name        = layer.name;
+        layerReport.numInputs   = layer.numInputs;
+        layerReport.numOutputs  = layer.numOutputs;
+        layerReport.rank        = 0;
+        layerReport.flopsBefore = (long long)layer.numInputs * layer.numOutputs;
+        layerReport.flopsAfter  = layerReport.flopsBefore;
+
+        // largest rank which still saves work, the input and the output layer are kept
+        int maxRank = 0;
+        bool hiddenLayer = (l > 0 && l + 1 < layers.size());
+        while (hiddenLayer && (long long)(maxRank + 1) * (layer.numInputs + layer.numOutputs) < layerReport.flopsBefore) {
+            maxRank++;
+        }
+
+        if (maxRank > 0) {
+            vector<double> u;
+            vector<double> singularValues;
+            vector<double> v;
+            LinearAlgebra::singularValueDecomposition(layer.weights,layer.numOutputs,layer.numInputs,u,singularValues,v);
+            int fullRank = (int)singularValues.size();
+
+            for (int rank = 1; rank <= maxRank; rank++) {
+                // first layer : S_k * V_k^T, without bias
+                MLP::DenseLayer first;
+                first.name       = layer.name + "_lowRank";
+                first.numInputs  = layer.numInputs;
+                first.numOutputs = rank;
+                first.weights.assign(rank * layer.numInputs,0.0);
+                first.biases.assign(rank,0.0);
+                for (int k = 0; k < rank; k++) {
+                    for (int i = 0; i < layer.numInputs; i++) {
+                        first.weights[k * layer.numInputs + i] = singularValues[k] * v[i * fullRank + k];
+                    }
+                }
+
+                // second layer : U_k, with the bias and activation of the original layer
+                MLP::DenseLayer second = layer;
+                second.numInputs = rank;
+                second.weights.assign(layer.numOutputs * rank,0.0);
+                for (int o = 0; o < layer.numOutputs; o++) {
+                    for (int k = 0; k < rank; k++) {
+                        second.weights[o * rank + k] = u[o * fullRank + k];
+                    }
+                }
+
+                replacements[l] = {first, second};
+                if (rootMeanSquareError(assemble(),normalizedInputValues,expectedOutputValues_) <= errorBudget) {
+                    layerReport.rank       = rank;
+                    layerReport.flopsAfter = (long long)rank * (layer.numInputs + layer.numOutputs);
+                    break;
+                }
+            }
+            if (layerReport.rank == 0) {
+                replacements[l] = {layer};
+            }
+        }
+
+        layerReport.error = rootMeanSquareError(assemble(),normalizedInputValues,expectedOutputValues_);
+        report_.flopsBefore += layerReport.flopsBefore;
+        report_.flopsAfter  += layerReport.flopsAfter;
+        report_.layers.push_back(layerReport);
+    }
+
+    MLP compressed = assemble();
+    report_.errorAfterFactorization = rootMeanSquareError(compressed,normalizedInputValues,expectedOutputValues_);
+
+    // --- write compressed net ---
+    string withoutLossPath = outputPrefix_ + "_without_loss.prototxt";
+    string caffemodelPath  = outputPrefix_ + ".caffemodel";
+    if (!writeNetStructure(ann.getNetStructurePrototxtPath(),withoutLossPath,report_.layers)) {
+        return false;
+    }
+
+    Net<double> compressedNet(withoutLossPath,caffe::TEST);
+    if (!compressed.writeToNet(&compressedNet)) {
+        return false;
+    }
+    NetParameter weights;
+    compressedNet.ToProto(&weights);
+    WriteProtoToBinaryFile(weights,caffemodelPath);
+
+    // the compressed net works on the same normalized values as the original one
+    ifstream normalizerFile(ann.getTrainedWeightsCaffemodelPath() + ".normalizer");
+    if (normalizerFile.good()) {
+        ofstream compressedNormalizerFile(caffemodelPath + ".normalizer");
+        compressedNormalizerFile << normalizerFile.rdbuf();
+        if (!compressedNormalizerFile.good()) {
+            cout << "Error : could not write " << caffemodelPath << ".normalizer" << endl;
+            return false;
+        }
+    }
+
+    // --- fine-tuning ---
+    if (fineTuningIterations <= 0) {
+        return true;
+    }
+    if (ann.getSolverParametersPrototxtPath() == "") {
+        cout << "Error : fine-tuning needs a solver prototxt, the compressed net is not fine-tuned" << endl;
+        return true;
+    }
+
+    SolverParameter solverParam;
+    std::ifstream iFile(ann.getSolverParametersPrototxtPath());
+    stringstream sstr;
+    sstr << iFile.rdbuf();
+    if (!google::protobuf::TextFormat::ParseFromString(sstr.str(), &solverParam)) {
+        cout << "Error : solver prototxt file is not valid" << endl;
+        return false;
+    }
+
+    string withLossPath = outputPrefix_ + "_with_loss.prototxt";
+    string solverPath   = outputPrefix_ + "_solver.prototxt";
+    if (!writeNetStructure(solverParam.net(),withLossPath,report_.layers)) {
+        return false;
+    }
+    solverParam.set_net(withLossPath);
+    solverParam.set_max_iter(fineTuningIterations);
+    solverParam.set_snapshot(0);
+    solverParam.set_snapshot_prefix(outputPrefix_);
+    WriteProtoToTextFile(solverParam,solverPath);
+
+    ANN tunedAnn(withoutLossPath,caffemodelPath,solverPath);
+    bool trained = tunedAnn.train(inputValues_,expectedOutputValues_);
+    MLP tuned;
+    bool loaded = trained && tuned.loadFromNet(tunedAnn.loadNet());
+
+    // the snapshot of the fine-tuning is only needed until it is loaded, the result is written to caffemodelPath
+    string snapshotPath = tunedAnn.getTrainedWeightsCaffemodelPath();
+    if (snapshotPath != caffemodelPath) {
+        string snapshotPrefix = snapshotPath.substr(0,snapshotPath.size() - string(".caffemodel").size());
+        remove(snapshotPath.c_str());
+        remove((snapshotPath + ".normalizer").c_str());
+        remove((snapshotPrefix + ".solverstate").c_str());
+    }
+    if (!loaded) {
+        return false;
+    }
+    report_.errorAfterFineTuning = rootMeanSquareError(tuned,normalizedInputValues,expectedOutputValues_);
+
+    // keep the fine-tuned weights only if they are better
+    if (report_.errorAfterFineTuning < report_.errorAfterFactorization) {
+        tuned.writeToNet(&compressedNet);
+        compressedNet.ToProto(&weights);
+        WriteProtoToBinaryFile(weights,caffemodelPath);
+    }
+    return true;
+}
+
+/**
+ * @brief LowRankCompressor::Report::print writes the error/work trade-off of every layer to oStream_
+ */
+void LowRankCompressor::Report::print(ostream& oStream_) const {
+    oStream_ << "layer, inputs, outputs, rank, multiply-adds before, multiply-adds after, rms error" << endl;
+    for (unsigned int l = 0; l < layers.size(); l++) {
+        oStream_ << layers[l].name << ", " << layers[l].numInputs << ", " << layers[l].numOutputs << ", ";
+        if (layers[l].rank > 0) {
+            oStream_ << layers[l].rank;
+        } else {
+            oStream_ << "full";
+        }
+        oStream_ << ", " << layers[l].flopsBefore << ", " << layers[l].flopsAfter << ", " << layers[l].error << endl;
+    }
+    oStream_ << "multiply-adds per sample : " << flopsBefore << " -> " << flopsAfter << endl;
+    oStream_ << "rms error                : " << errorBefore << " -> " << errorAfterFactorization;
+    if (errorAfterFineTuning >= 0) {
+        oStream_ << " -> " << errorAfterFineTuning << " (fine-tuned)";
+    }
+    oStream_ << endl;
+}
+
+/* --- miscellaneous --- */
+
+/**
+ * @brief LowRankCompressor::rootMeanSquareError calculates the root mean square error of mlp_ over all samples and outputs
+ *
+ * NOTICE : inputValues_ have to be normalized already, the outputs of mlp_ are mapped back by
+ *          the output normalizer of the ANN (if fitted)
+ */
+double LowRankCompressor::rootMeanSquareError(const MLP& mlp_, const vector<vector<double>>& inputValues_,
+                                              const vector<vector<double>>& expectedOutputValues_) const {
+    const Normalizer& outputNormalizer = ann.getOutputNormalizer();
+    double sumOfSquares = 0;
+    long long numErrors = 0;
+    vector<double> outputValues(mlp_.getNumOutputs());
+    for (unsigned int s = 0; s < inputValues_.size(); s++) {
+        mlp_.forward(inputValues_[s].data(),outputValues.data());
+        if (outputNormalizer.isFitted() && outputNormalizer.getNumFeatures() == (int)outputValues.size()) {
+            outputNormalizer.inverseTransform(outputValues.data(),1);
+        }
+        for (unsigned int o = 0; o < outputValues.size() && o < expectedOutputValues_[s].size(); o++) {
+            double error = outputValues[o] - expectedOutputValues_[s][o];
+            sumOfSquares += error * error;
+            numErrors++;
+        }
+    }
+    return (numErrors > 0) ? sqrt(sumOfSquares / numErrors) : 0.0;
+}
+
+/**
+ * @brief LowRankCompressor::writeNetStructure writes a copy of the net prototxt with factorized layers
+ * @param sourcePath_ path of the prototxt of the original net
+ * @param targetPath_ path the prototxt of the compressed net is written to
+ * @param layers_     reports of all layers, layers with rank > 0 are factorized
+ * @return returns true if the prototxt has been written, otherwise false
+ *
+ * A factorized layer "name" is preceded by a new InnerProduct layer "name_lowRank" without bias,
+ * which has rank outputs and takes the bottom of the original layer. The original layer then
+ * takes "name_lowRank" as its bottom.
+ */
+bool LowRankCompressor::writeNetStructure(const string& sourcePath_, const string& targetPath_, const vector<LayerReport>& layers_) const {
+    NetParameter source;
+    if (!ReadProtoFromTextFile(sourcePath_,&source)) {
+        cout << "Error : could not read " << sourcePath_ << endl;
+        return false;
+    }
+
+    NetParameter target;
+    target.CopyFrom(source);
+    target.clear_layer();
+    for (int i = 0; i < source.layer_size(); i++) {
+        const LayerParameter& layer = source.layer(i);
+
+        int rank = 0;
+        for (unsigned int l = 0; l < layers_.size(); l++) {
+            if (layers_[l].name == layer.name() && layer.type() == "InnerProduct") {
+                rank = layers_[l].rank;
+            }
+        }
+
+        if (rank > 0) {
+            string lowRankName = layer.name() + "_lowRank";
+
+            LayerParameter* lowRankLayer = target.add_layer();
+            lowRankLayer->CopyFrom(layer);
+            lowRankLayer->set_name(lowRankName);
+            lowRankLayer->clear_top();
+            lowRankLayer->add_top(lowRankName);
+            lowRankLayer->mutable_inner_product_param()->set_num_output(rank);
+            lowRankLayer->mutable_inner_product_param()->set_bias_term(false);
+
+            LayerParameter* originalLayer = target.add_layer();
+            originalLayer->CopyFrom(layer);
+            originalLayer->clear_bottom();
+            originalLayer->add_bottom(lowRankName);
+        } else {
+            target.add_layer()->CopyFrom(layer);
+        }
+    }
+
+    WriteProtoToTextFile(target,targetPath_);
+    return true;
+}
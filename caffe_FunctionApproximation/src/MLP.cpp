@@ -0,0 +1,357 @@
+#include "MLP.h"
+
+// STL
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+/* --- building --- */
+
+/**
+ * @brief MLP::loadFromNet copies the weights of all InnerProduct layers of net_
+ * @param net_ the net to copy the weights from
+ * @return returns true if net_ is a supported InnerProduct/activation stack, otherwise false
+ *
+ * Supported layers are
+ *   - Input         : ignored
+ *   - InnerProduct  : becomes a new DenseLayer
+ *   - TanH, ReLU    : becomes the activation of the preceding DenseLayer, the
+ *                     negative_slope of ReLU is kept (LeakyReLU), a negative
+ *                     negative_slope is not supported
+ *   - EuclideanLoss : ignored, therefore nets with and without loss are supported
+ *
+ * NOTICE : the normalizers of a net trained with normalization are not applied, the MLP
+ *          works on normalized values (see the overload with normalizers)
+ * NOTICE : every activation layer has to follow directly on an InnerProduct layer,
+ *          otherwise the function stops, prints an error and returns false
+ */
+bool MLP::loadFromNet(Net<double>* net_) {
+    layers.clear();
+
+    const vector<caffe::shared_ptr<Layer<double> > >& netLayers = net_->layers();
+    for (unsigned int i = 0; i < netLayers.size(); i++) {
+        string type = netLayers[i]->type();
+        const LayerParameter& layerParam = netLayers[i]->layer_param();
+
+        if (type == "Input" || type == "EuclideanLoss") {
+            continue;
+        } else if (type == "InnerProduct") {
+            vector<caffe::shared_ptr<Blob<double> > >& blobs = netLayers[i]->blobs();
+
+            DenseLayer layer;
+            layer.name       = layerParam.name();
+            layer.numOutputs = blobs[0]->shape(0);
+            layer.numInputs  = blobs[0]->count() / layer.numOutputs;
+            layer.weights.assign(blobs[0]->cpu_data(),blobs[0]->cpu_data() + blobs[0]->count());
+            if (blobs.size() > 1) {
+                layer.biases.assign(blobs[1]->cpu_data(),blobs[1]->cpu_data() + blobs[1]->count());
+            } else {
+                layer.biases.assign(layer.numOutputs,0.0);
+            }
+
+            if (!addLayer(layer)) {
+                layers.clear();
+                return false;
+            }
+        } else if (type == "TanH" || type == "ReLU") {
+            if (layers.empty() || layers.back().activation != LINEAR) {
+                cout << "Error : activation layer " << layerParam.name() << " does not follow an InnerProduct layer" << endl;
+                layers.clear();
+                return false;
+            }
+            if (type == "TanH") {
+                layers.back().activation = TANH;
+            } else {
+                if (layerParam.relu_param().negative_slope() < 0) {
+                    cout << "Error : ReLU layer " << layerParam.name() << " has a negative slope" << endl;
+                    layers.clear();
+                    return false;
+                }
+                layers.back().activation    = RELU;
+                layers.back().negativeSlope = layerParam.relu_param().negative_slope();
+            }
+        } else {
+            cout << "Error : layer type " << type << " is not supported" << endl;
+            layers.clear();
+            return false;
+        }
+    }
+
+    if (layers.empty()) {
+        cout << "Error : net does not contain any InnerProduct layer" << endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief MLP::loadFromNet copies the weights of net_ and folds the normalizers into them
+ * @param net_              the net to copy the weights from
+ * @param inputNormalizer_  normalizer of the input values the net has been trained with
+ * @param outputNormalizer_ normalizer of the output values the net has been trained with
+ * @return returns true if net_ is a supported InnerProduct/activation stack, otherwise false
+ *
+ * Usually called as mlp.loadFromNet(ann.loadNet(),ann.getInputNormalizer(),ann.getOutputNormalizer()),
+ * see addNormalization.
+ */
+bool MLP::loadFromNet(Net<double>* net_, const Normalizer& inputNormalizer_, const Normalizer& outputNormalizer_) {
+    return loadFromNet(net_) && addNormalization(inputNormalizer_,outputNormalizer_);
+}
+
+/**
+ * @brief MLP::writeToNet copies the weights of all DenseLayers back into the InnerProduct layers of net_
+ * @param net_ the net to copy the weights to
+ * @return returns true if the InnerProduct layers of net_ fit to the DenseLayers, otherwise false
+ *
+ * The n-th DenseLayer is written to the n-th InnerProduct layer of net_, therefore net_ has to
+ * have the same structure as the MLP (the activations and other layers are not checked).
+ * InnerProduct layers without bias get no bias.
+ *
+ * NOTICE : if the sizes do not fit, the function stops, prints an error and returns false. In this
+ *          case the layers before the misfitting layer have already been written.
+ * NOTICE : the weights of an MLP with normalization (see addNormalization) do not fit to the
+ *          normalizers of the ANN any more
+ */
+bool MLP::writeToNet(Net<double>* net_) const {
+    const vector<caffe::shared_ptr<Layer<double> > >& netLayers = net_->layers();
+    unsigned int layerIndex = 0;
+    for (unsigned int i = 0; i < netLayers.size(); i++) {
+        if (string(netLayers[i]->type()) != "InnerProduct") {
+            continue;
+        }
+        vector<caffe::shared_ptr<Blob<double> > >& blobs = netLayers[i]->blobs();
+        if ( (layerIndex >= layers.size()) ||
+             (blobs[0]->count() != (int)layers[layerIndex].weights.size()) ||
+             ((blobs.size() > 1) && (blobs[1]->count() != (int)layers[layerIndex].biases.size())) ) {
+            cout << "Error : layer " << netLayers[i]->layer_param().name() << " does not fit to the MLP" << endl;
+            return false;
+        }
+        memcpy(blobs[0]->mutable_cpu_data(),layers[layerIndex].weights.data(),layers[layerIndex].weights.size() * sizeof(double));
+        if (blobs.size() > 1) {
+            memcpy(blobs[1]->mutable_cpu_data(),layers[layerIndex].biases.data(),layers[layerIndex].biases.size() * sizeof(double));
+        }
+        layerIndex++;
+    }
+
+    if (layerIndex != layers.size()) {
+        cout << "Error : net has fewer InnerProduct layers than the MLP" << endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief MLP::getNumParameters returns the number of weights and biases of all layers
+ */
+int MLP::getNumParameters() const {
+    int numParameters = 0;
+    for (const DenseLayer& layer : layers) {
+        numParameters += layer.weights.size() + layer.biases.size();
+    }
+    return numParameters;
+}
+
+/**
+ * @brief MLP::getParameters returns the weights and biases of all layers in one vector
+ *
+ * The layers are stored one after another, the weights of a layer (caffe's layout) followed
+ * by its biases, i.e. in the order of the learnable parameters of the caffe net.
+ */
+vector<double> MLP::getParameters() const {
+    vector<double> parameters;
+    parameters.reserve(getNumParameters());
+    for (const DenseLayer& layer : layers) {
+        parameters.insert(parameters.end(),layer.weights.begin(),layer.weights.end());
+        parameters.insert(parameters.end(),layer.biases.begin(),layer.biases.end());
+    }
+    return parameters;
+}
+
+/**
+ * @brief MLP::setParameters sets the weights and biases of all layers (see getParameters)
+ * @return returns true if parameters_ has getNumParameters() values, otherwise false
+ */
+bool MLP::setParameters(const vector<double>& parameters_) {
+    if ((int)parameters_.size() != getNumParameters()) {
+        cout << "Error : " << parameters_.size() << " parameters do not fit to the MLP" << endl;
+        return false;
+    }
+    vector<double>::const_iterator position = parameters_.begin();
+    for (DenseLayer& layer : layers) {
+        copy(position,position + layer.weights.size(),layer.weights.begin());
+        position += layer.weights.size();
+        copy(position,position + layer.biases.size(),layer.biases.begin());
+        position += layer.biases.size();
+    }
+    return true;
+}
+
+/**
+ * @brief MLP::addLayer appends layer_ to the end of the stack
+ * @return returns true if layer_ has consistent sizes, otherwise false
+ *
+ * NOTICE : a ReLU layer with a negative slope is refused, as it would not be monotonic
+ * NOTICE : the number of inputs of layer_ has to be equal to the number of outputs of
+ *          the last layer of the stack, otherwise the function does nothing except for
+ *          printing an error and returns false
+ */
+bool MLP::addLayer(const DenseLayer& layer_) {
+    if ( (layer_.numInputs <= 0) || (layer_.numOutputs <= 0) ||
+         ((int)layer_.weights.size() != layer_.numInputs * layer_.numOutputs) ||
+         ((int)layer_.biases.size()  != layer_.numOutputs) ) {
+        cout << "Error : layer " << layer_.name << " has inconsistent sizes" << endl;
+        return false;
+    }
+    if (layer_.activation == RELU && layer_.negativeSlope < 0) {
+        cout << "Error : ReLU layer " << layer_.name << " has a negative slope" << endl;
+        return false;
+    }
+    if (!layers.empty() && layers.back().numOutputs != layer_.numInputs) {
+        cout << "Error : layer " << layer_.name << " does not fit to the preceding layer" << endl;
+        return false;
+    }
+    layers.push_back(layer_);
+    return true;
+}
+
+/**
+ * @brief MLP::addNormalization lets the stack take and return the values before normalization
+ * @param inputNormalizer_  normalizer of the input values
+ * @param outputNormalizer_ normalizer of the output values
+ * @return returns true if the normalizers have been applied, otherwise false
+ *
+ * Both normalizers are affine per feature (see Normalizer), therefore they are exact parts of
+ * the stack :
+ *   - inputs  : W * (x * f + s) + b = (W * diag(f)) * x + (W * s + b) replaces the first layer
+ *   - outputs : y * f' + o is folded into the last layer if it has no activation, otherwise
+ *               it becomes an additional diagonal layer without activation
+ * Normalizers which are not fitted (or have another number of features) are ignored, like
+ * ANN::forward ignores them.
+ *
+ * NOTICE : the MLP has to contain at least one layer
+ */
+bool MLP::addNormalization(const Normalizer& inputNormalizer_, const Normalizer& outputNormalizer_) {
+    if (layers.empty()) {
+        cout << "Error : normalization can not be added to an empty MLP" << endl;
+        return false;
+    }
+
+    DenseLayer& first = layers.front();
+    if (inputNormalizer_.isFitted() && inputNormalizer_.getNumFeatures() == first.numInputs) {
+        for (int o = 0; o < first.numOutputs; o++) {
+            double* weightRow = &first.weights[o * first.numInputs];
+            for (int i = 0; i < first.numInputs; i++) {
+                first.biases[o] += weightRow[i] * inputNormalizer_.getSummand(i);
+                weightRow[i]    *= inputNormalizer_.getFactor(i);
+            }
+        }
+    }
+
+    int numOutputs = getNumOutputs();
+    if (outputNormalizer_.isFitted() && outputNormalizer_.getNumFeatures() == numOutputs) {
+        DenseLayer& last = layers.back();
+        if (last.activation == LINEAR) {
+            for (int o = 0; o < numOutputs; o++) {
+                for (int i = 0; i < last.numInputs; i++) {
+                    last.weights[o * last.numInputs + i] *= outputNormalizer_.getInverseFactor(o);
+                }
+                last.biases[o] = last.biases[o] * outputNormalizer_.getInverseFactor(o) + outputNormalizer_.getOffset(o);
+            }
+        } else {
+            DenseLayer denormalization;
+            denormalization.name       = "outputDenormalization";
+            denormalization.numInputs  = numOutputs;
+            denormalization.numOutputs = numOutputs;
+            denormalization.weights.assign(numOutputs * numOutputs,0.0);
+            denormalization.biases.assign(numOutputs,0.0);
+            for (int o = 0; o < numOutputs; o++) {
+                denormalization.weights[o * numOutputs + o] = outputNormalizer_.getInverseFactor(o);
+                denormalization.biases[o]                   = outputNormalizer_.getOffset(o);
+            }
+            layers.push_back(denormalization);
+        }
+    }
+    return true;
+}
+
+/* --- pushing values forward (from input to output) --- */
+
+/**
+ * @brief MLP::forward propagates one sample through the stack
+ * @param inputValues_  pointer to getNumInputs() input values
+ * @param outputValues_ pointer to getNumOutputs() values the result is written to
+ *
+ * NOTICE : forward does not modify the MLP, therefore it can be called by several threads at once
+ */
+void MLP::forward(const double* inputValues_, double* outputValues_) const {
+    forward(inputValues_,1,outputValues_);
+}
+
+/**
+ * @brief MLP::forward propagates a batch of samples through the stack
+ * @param inputValues_  pointer to numSamples_ * getNumInputs() input values (row-major, one row per sample)
+ * @param numSamples_   number of samples
+ * @param outputValues_ pointer to numSamples_ * getNumOutputs() values the result is written to (row-major)
+ *
+ * The batch is propagated layer by layer, so that the weights of a layer stay in cache
+ * while they are applied to all samples. The intermediate buffers are only allocated once
+ * per call instead of once per sample.
+ *
+ * NOTICE : forward does not modify the MLP, therefore it can be called by several threads at once
+ */
+void MLP::forward(const double* inputValues_, int numSamples_, double* outputValues_) const {
+    if (numSamples_ <= 0) {
+        return;
+    }
+
+    vector<double> current(inputValues_,inputValues_ + numSamples_ * getNumInputs());
+    vector<double> next;
+
+    for (unsigned int l = 0; l < layers.size(); l++) {
+        const DenseLayer& layer = layers[l];
+        next.resize(numSamples_ * layer.numOutputs);
+        for (int s = 0; s < numSamples_; s++) {
+            const double* sampleIn  = &current[s * layer.numInputs];
+            double*       sampleOut = &next[s * layer.numOutputs];
+            for (int o = 0; o < layer.numOutputs; o++) {
+                const double* weightRow = &layer.weights[o * layer.numInputs];
+                double sum = layer.biases[o];
+                for (int i = 0; i < layer.numInputs; i++) {
+                    sum += weightRow[i] * sampleIn[i];
+                }
+                sampleOut[o] = activate(layer.activation,sum,layer.negativeSlope);
+            }
+        }
+        current.swap(next);
+    }
+
+    memcpy(outputValues_,current.data(),current.size() * sizeof(double));
+}
+
+/**
+ * @brief MLP::forward propagates one sample through the stack
+ * @param inputValues_ vector of getNumInputs() input values
+ * @return returns the vector of getNumOutputs() output values
+ */
+vector<double> MLP::forward(const vector<double>& inputValues_) const {
+    vector<double> result(getNumOutputs());
+    forward(inputValues_.data(),result.data());
+    return result;
+}
+
+/* --- miscellaneous --- */
+
+/**
+ * @brief MLP::activate applies activation_ to value_
+ * @param negativeSlope_ slope of RELU for negative values, ignored by the other activations
+ */
+double MLP::activate(Activation activation_, double value_, double negativeSlope_) {
+    switch (activation_) {
+        case TANH:
+            return tanh(value_);
+        case RELU:
+            return (value_ > 0) ? value_ : negativeSlope_ * value_;
+        default:
+            return value_;
+    }
+}
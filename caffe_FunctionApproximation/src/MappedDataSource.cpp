@@ -0,0 +1,135 @@
+#include "MappedDataSource.h"
+
+// STL
+#include <algorithm>
+#include <numeric>
+// POSIX
+#include <sys/mman.h>
+
+/* --- constructors / destructors --- */
+
+/**
+ * @brief MappedDataSource::MappedDataSource maps the data set file at path_ into memory
+ * @param path_ path of a data set file with header (see ColumnarDataSet)
+ *
+ * The numbers of input and output columns are taken from the header.
+ *
+ * NOTICE : if the file is no valid data set an error is printed and isOpen() returns false
+ */
+MappedDataSource::MappedDataSource(const string& path_)
+    : shuffle(true), generator(0), blockSize(4096), blockPosition(0), currentBlock(0), rowPosition(0) {
+    dataSet.open(path_);
+}
+
+/**
+ * @brief MappedDataSource::MappedDataSource maps the headerless columnar binary file at path_ into memory
+ * @param path_       path of the headerless columnar binary file
+ * @param numInputs_  number of input columns
+ * @param numOutputs_ number of expected output columns
+ *
+ * The number of samples is derived from the file size :
+ *     numSamples = fileSize / (sizeof(double) * (numInputs_ + numOutputs_))
+ *
+ * NOTICE : if the file can not be opened or its size is no multiple of the size of one
+ *          sample an error is printed and isOpen() returns false
+ */
+MappedDataSource::MappedDataSource(const string& path_, int numInputs_, int numOutputs_)
+    : shuffle(true), generator(0), blockSize(4096), blockPosition(0), currentBlock(0), rowPosition(0) {
+    dataSet.openRaw(path_,numInputs_,numOutputs_);
+}
+
+/* --- reading samples --- */
+
+/**
+ * @brief MappedDataSource::nextBatch copies the next batchSize_ samples into the given buffers
+ * @param batchSize_    number of samples to copy
+ * @param inputValues_  buffer for batchSize_ * getNumInputs() input values
+ * @param outputValues_ buffer for batchSize_ * getNumOutputs() expected output values
+ */
+void MappedDataSource::nextBatch(int batchSize_, double* inputValues_, double* outputValues_) {
+    if (!isOpen() || getNumSamples() == 0) {
+        return;
+    }
+
+    int numInputs  = getNumInputs();
+    int numOutputs = getNumOutputs();
+    for (int i = 0; i < batchSize_; i++) {
+        if (rowPosition >= rowOrder.size()) {
+            startBlock();
+        }
+        size_t sample = currentBlock * blockSize + rowOrder[rowPosition++];
+        for (int j = 0; j < numInputs; j++) {
+            inputValues_[i * numInputs + j] = dataSet.getColumnData(j)[sample];
+        }
+        for (int j = 0; j < numOutputs; j++) {
+            outputValues_[i * numOutputs + j] = dataSet.getColumnData(numInputs + j)[sample];
+        }
+    }
+}
+
+/**
+ * @brief MappedDataSource::rewind releases the current block, the next batch starts a new epoch
+ */
+void MappedDataSource::rewind() {
+    if (!rowOrder.empty()) {
+        adviseBlock(currentBlock,MADV_DONTNEED);
+    }
+    blockOrder.clear();
+    blockPosition = 0;
+    rowOrder.clear();
+    rowPosition = 0;
+}
+
+/**
+ * @brief MappedDataSource::startEpoch starts a new pass over all blocks, in a new random order if shuffling is enabled
+ */
+void MappedDataSource::startEpoch() {
+    size_t numBlocks = (getNumSamples() + blockSize - 1) / blockSize;
+    if (blockOrder.size() != numBlocks) {
+        blockOrder.resize(numBlocks);
+        iota(blockOrder.begin(),blockOrder.end(),0);
+    }
+    if (shuffle) {
+        std::shuffle(blockOrder.begin(),blockOrder.end(),generator);
+    }
+    blockPosition = 0;
+}
+
+/**
+ * @brief MappedDataSource::startBlock releases the finished block and starts the next one
+ *
+ * The pages of the finished block are released, the pages of the started block and of the
+ * block after it are requested from the kernel in advance.
+ */
+void MappedDataSource::startBlock() {
+    if (!rowOrder.empty()) {
+        adviseBlock(currentBlock,MADV_DONTNEED);
+    }
+    if (blockPosition >= blockOrder.size()) {
+        startEpoch();
+    }
+
+    currentBlock = blockOrder[blockPosition++];
+    size_t numRows = min<size_t>(blockSize,getNumSamples() - currentBlock * blockSize);
+    rowOrder.resize(numRows);
+    iota(rowOrder.begin(),rowOrder.end(),0);
+    if (shuffle) {
+        std::shuffle(rowOrder.begin(),rowOrder.end(),generator);
+    }
+    rowPosition = 0;
+
+    adviseBlock(currentBlock,MADV_WILLNEED);
+    if (blockPosition < blockOrder.size()) {
+        adviseBlock(blockOrder[blockPosition],MADV_WILLNEED);
+    }
+}
+
+/**
+ * @brief MappedDataSource::adviseBlock passes advice_ for all pages of block_ (in every column) to the kernel
+ * @param block_  index of the block
+ * @param advice_ advice for madvise (e.g. MADV_WILLNEED or MADV_DONTNEED)
+ */
+void MappedDataSource::adviseBlock(size_t block_, int advice_) {
+    size_t firstRow = block_ * blockSize;
+    dataSet.advise(firstRow,min<size_t>(blockSize,getNumSamples() - firstRow),advice_);
+}
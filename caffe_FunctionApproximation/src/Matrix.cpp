@@ -0,0 +1,145 @@
+#include "Matrix.h"
+
+// STL
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+/**
+ * allocates memory for numValues_ doubles, aligned to Matrix::getAlignment() bytes
+ */
+double* allocate(size_t numValues_) {
+    if (numValues_ == 0) {
+        return nullptr;
+    }
+    void* memory = nullptr;
+    if (posix_memalign(&memory,Matrix::getAlignment(),numValues_ * sizeof(double)) != 0) {
+        throw bad_alloc();
+    }
+    return static_cast<double*>(memory);
+}
+
+}
+
+/* --- constructors / destructors --- */
+
+/**
+ * @brief Matrix::Matrix constructor of an empty matrix (0 rows, 0 columns)
+ */
+Matrix::Matrix()
+    : values(nullptr), numRows(0), numColumns(0), capacity(0) {
+}
+
+/**
+ * @brief Matrix::Matrix constructor of a matrix with numRows_ rows of numColumns_ values, all set to value_
+ */
+Matrix::Matrix(size_t numRows_, int numColumns_, double value_)
+    : values(allocate(numRows_ * numColumns_)), numRows(numRows_), numColumns(numColumns_), capacity(numRows_ * numColumns_) {
+    fill(values,values + capacity,value_);
+}
+
+/**
+ * @brief Matrix::Matrix copies the values of view_
+ */
+Matrix::Matrix(const MatrixView& view_)
+    : values(allocate(view_.getSize())), numRows(view_.getNumRows()), numColumns(view_.getNumColumns()), capacity(view_.getSize()) {
+    copy(view_.data(),view_.data() + capacity,values);
+}
+
+/**
+ * @brief Matrix::Matrix copies rows_ (one row per sample) into one block
+ *
+ * NOTICE : every row has to have the same number of values as the first row
+ */
+Matrix::Matrix(const vector<vector<double>>& rows_)
+    : Matrix(rows_.size(),rows_.empty() ? 0 : rows_[0].size()) {
+    for (size_t r = 0; r < numRows; r++) {
+        copy(rows_[r].begin(),rows_[r].begin() + numColumns,row(r));
+    }
+}
+
+/**
+ * @brief Matrix::Matrix copy constructor
+ */
+Matrix::Matrix(const Matrix& other_)
+    : Matrix(other_.view()) {
+}
+
+/**
+ * @brief Matrix::Matrix move constructor, other_ is empty afterwards
+ */
+Matrix::Matrix(Matrix&& other_)
+    : values(other_.values), numRows(other_.numRows), numColumns(other_.numColumns), capacity(other_.capacity) {
+    other_.values     = nullptr;
+    other_.numRows    = 0;
+    other_.numColumns = 0;
+    other_.capacity   = 0;
+}
+
+/**
+ * @brief Matrix::~Matrix releases the memory
+ */
+Matrix::~Matrix() {
+    free(values);
+}
+
+/**
+ * @brief Matrix::operator= copies the values of other_, the memory is reused if it is big enough
+ */
+Matrix& Matrix::operator=(const Matrix& other_) {
+    if (this != &other_) {
+        resize(other_.numRows,other_.numColumns);
+        copy(other_.values,other_.values + other_.getSize(),values);
+    }
+    return *this;
+}
+
+/**
+ * @brief Matrix::operator= takes over the memory of other_, other_ is empty afterwards
+ */
+Matrix& Matrix::operator=(Matrix&& other_) {
+    if (this != &other_) {
+        swap(values,other_.values);
+        swap(numRows,other_.numRows);
+        swap(numColumns,other_.numColumns);
+        swap(capacity,other_.capacity);
+        other_.numRows    = 0;
+        other_.numColumns = 0;
+    }
+    return *this;
+}
+
+/* --- miscellaneous --- */
+
+/**
+ * @brief Matrix::resize changes the dimensions to numRows_ * numColumns_
+ *
+ * The memory is only reallocated if it is too small, therefore a matrix which is reused for
+ * batches of the same size does not allocate memory again.
+ *
+ * NOTICE : the values are undefined afterwards, unless the matrix has not been reallocated
+ *          and the number of columns is unchanged (then the first rows are kept)
+ */
+void Matrix::resize(size_t numRows_, int numColumns_) {
+    size_t size = numRows_ * numColumns_;
+    if (size > capacity) {
+        free(values);
+        values   = allocate(size);
+        capacity = size;
+    }
+    numRows    = numRows_;
+    numColumns = numColumns_;
+}
+
+/**
+ * @brief Matrix::toRows returns one vector per row, as used by the vector based functions of ANN
+ */
+vector<vector<double>> Matrix::toRows() const {
+    vector<vector<double>> result(numRows);
+    for (size_t r = 0; r < numRows; r++) {
+        result[r].assign(row(r),row(r) + numColumns);
+    }
+    return result;
+}
@@ -0,0 +1,408 @@
+#include "Normalizer.h"
+
+// STL
+#include <iostream>
+#include <fstream>
+#include <thread>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+// own
+#include "CsvIO.h"
+#include "Transforms.h"
+
+namespace {
+
+const char* methodNames[] = {"none","z_score","min_max"};
+
+}
+
+/* --- constructors / destructors --- */
+
+/**
+ * @brief Normalizer::Normalizer constructor of class Normalizer, the normalizer is not fitted yet
+ * @param method_ mapping which is applied by transform()
+ */
+Normalizer::Normalizer(Method method_)
+    : method(method_), numThreads(0) {
+}
+
+/* --- getter / setter --- */
+
+/**
+ * @brief Normalizer::getStandardDeviation returns the sample standard deviation (divisor count - 1) of feature_
+ */
+double Normalizer::getStandardDeviation(int feature_) const {
+    const Statistics& statistics_l = statistics[feature_];
+    return (statistics_l.count > 1) ? sqrt(statistics_l.sumOfSquaredDeviations / (statistics_l.count - 1)) : 0.0;
+}
+
+/* --- fitting --- */
+
+/**
+ * @brief Normalizer::reset forgets all statistics, afterwards transform() does not change any value
+ */
+void Normalizer::reset() {
+    statistics.clear();
+    updateCoefficients();
+}
+
+/**
+ * @brief Normalizer::fit fits a normalizer with one feature to all values_ (one value per sample)
+ */
+void Normalizer::fit(const vector<double>& values_) {
+    fit(values_.data(),values_.size(),1);
+}
+
+/**
+ * @brief Normalizer::fit fits the normalizer to all rows_ (one row of features per sample)
+ */
+void Normalizer::fit(const vector<vector<double>>& rows_) {
+    reset();
+    if (rows_.empty()) {
+        return;
+    }
+    int numFeatures = rows_[0].size();
+    vector<double> block;
+    const size_t rowsPerBlock = 1 << 16;
+    for (size_t firstRow = 0; firstRow < rows_.size(); firstRow += rowsPerBlock) {
+        size_t numRows = min(rowsPerBlock,rows_.size() - firstRow);
+        block.resize(numRows * numFeatures);
+        for (size_t r = 0; r < numRows; r++) {
+            copy(rows_[firstRow + r].begin(),rows_[firstRow + r].begin() + numFeatures,block.begin() + r * numFeatures);
+        }
+        update(block.data(),numRows,numFeatures);
+    }
+}
+
+/**
+ * @brief Normalizer::fit fits the normalizer to numRows_ rows of numFeatures_ values
+ * @param rows_        numRows_ * numFeatures_ values, one row after another
+ * @param numRows_     number of rows (samples)
+ * @param numFeatures_ number of values per row
+ */
+void Normalizer::fit(const double* rows_, size_t numRows_, int numFeatures_) {
+    reset();
+    update(rows_,numRows_,numFeatures_);
+}
+
+/**
+ * @brief Normalizer::fit fits the normalizer to all rows_ (one row of features per sample)
+ */
+void Normalizer::fit(const MatrixView& rows_) {
+    fit(rows_.data(),rows_.getNumRows(),rows_.getNumColumns());
+}
+
+/**
+ * @brief Normalizer::update adds numRows_ further rows to the statistics
+ * @param rows_        numRows_ * numFeatures_ values, one row after another
+ * @param numRows_     number of rows (samples)
+ * @param numFeatures_ number of values per row, has to match the rows added before
+ *
+ * Blocks of at least 65536 values are split into one part per thread (getNumThreads(),
+ * 0 : all cores), every part is accumulated separately and the parts are merged.
+ */
+void Normalizer::update(const double* rows_, size_t numRows_, int numFeatures_) {
+    if (numRows_ == 0 || numFeatures_ <= 0) {
+        return;
+    }
+    if (!statistics.empty() && (int)statistics.size() != numFeatures_) {
+        cout << "Error : the number of features does not match the fitted normalizer" << endl;
+        return;
+    }
+
+    int numThreads_l = (numThreads > 0) ? numThreads : max(1u,thread::hardware_concurrency());
+    size_t numParts  = min<size_t>(numThreads_l,max<size_t>(1,numRows_ * numFeatures_ / 65536));
+
+    vector<vector<Statistics>> partStatistics(numParts);
+    if (numParts == 1) {
+        accumulate(rows_,numRows_,numFeatures_,partStatistics[0]);
+    } else {
+        vector<thread> threads;
+        size_t rowsPerPart = (numRows_ + numParts - 1) / numParts;
+        for (size_t p = 0; p < numParts; p++) {
+            size_t firstRow = min(numRows_,p * rowsPerPart);
+            size_t numRows  = min(numRows_,firstRow + rowsPerPart) - firstRow;
+            threads.push_back(thread(&Normalizer::accumulate,rows_ + firstRow * numFeatures_,numRows,numFeatures_,ref(partStatistics[p])));
+        }
+        for (unsigned int p = 0; p < threads.size(); p++) {
+            threads[p].join();
+        }
+    }
+
+    if (statistics.empty()) {
+        statistics = partStatistics[0];
+        partStatistics.erase(partStatistics.begin());
+    }
+    for (unsigned int p = 0; p < partStatistics.size(); p++) {
+        for (int j = 0; j < numFeatures_; j++) {
+            combine(statistics[j],partStatistics[p][j]);
+        }
+    }
+    updateCoefficients();
+}
+
+/**
+ * @brief Normalizer::merge adds the statistics of other_, which has been fitted to other samples of the same features
+ */
+void Normalizer::merge(const Normalizer& other_) {
+    if (!other_.isFitted()) {
+        return;
+    }
+    if (!isFitted()) {
+        statistics = other_.statistics;
+    } else if (statistics.size() != other_.statistics.size()) {
+        cout << "Error : the number of features does not match the fitted normalizer" << endl;
+        return;
+    } else {
+        for (unsigned int j = 0; j < statistics.size(); j++) {
+            combine(statistics[j],other_.statistics[j]);
+        }
+    }
+    updateCoefficients();
+}
+
+/* --- transforming --- */
+
+/**
+ * @brief Normalizer::transform normalizes numRows_ rows of getNumFeatures() values in place
+ *
+ * The rows are transformed by one vectorized pass (see Transforms::multiplyAdd).
+ *
+ * NOTICE : if the normalizer is not fitted or its method is NONE the values are not changed
+ */
+void Normalizer::transform(double* rows_, size_t numRows_) const {
+    if (method != NONE) {
+        Transforms::multiplyAdd(rows_,numRows_,offsets.size(),factors.data(),summands.data());
+    }
+}
+
+/**
+ * @brief Normalizer::inverseTransform maps numRows_ rows of normalized values back in place
+ */
+void Normalizer::inverseTransform(double* rows_, size_t numRows_) const {
+    if (method != NONE) {
+        Transforms::multiplyAdd(rows_,numRows_,offsets.size(),inverseFactors.data(),offsets.data());
+    }
+}
+
+/**
+ * @brief Normalizer::transform normalizes all rows_ in place
+ *
+ * NOTICE : nothing is changed if the number of columns differs from getNumFeatures()
+ */
+void Normalizer::transform(Matrix& rows_) const {
+    if (rows_.getNumColumns() == getNumFeatures()) {
+        transform(rows_.data(),rows_.getNumRows());
+    }
+}
+
+/**
+ * @brief Normalizer::inverseTransform maps all rows_ back from the normalized range in place
+ */
+void Normalizer::inverseTransform(Matrix& rows_) const {
+    if (rows_.getNumColumns() == getNumFeatures()) {
+        inverseTransform(rows_.data(),rows_.getNumRows());
+    }
+}
+
+/**
+ * @brief Normalizer::transform returns the normalized values_
+ * @param values_ either one value per sample of a normalizer with one feature, or rows of all features
+ */
+vector<double> Normalizer::transform(const vector<double>& values_) const {
+    vector<double> result = values_;
+    if (!offsets.empty()) {
+        transform(result.data(),result.size() / offsets.size());
+    }
+    return result;
+}
+
+/**
+ * @brief Normalizer::inverseTransform returns the values_ mapped back from the normalized range
+ */
+vector<double> Normalizer::inverseTransform(const vector<double>& values_) const {
+    vector<double> result = values_;
+    if (!offsets.empty()) {
+        inverseTransform(result.data(),result.size() / offsets.size());
+    }
+    return result;
+}
+
+/**
+ * @brief Normalizer::transform returns the normalized rows_ (one row of features per sample)
+ */
+vector<vector<double>> Normalizer::transform(const vector<vector<double>>& rows_) const {
+    vector<vector<double>> result = rows_;
+    for (unsigned int i = 0; i < result.size(); i++) {
+        transform(result[i].data(),(result[i].size() == offsets.size()) ? 1 : 0);
+    }
+    return result;
+}
+
+/**
+ * @brief Normalizer::inverseTransform returns the rows_ mapped back from the normalized range
+ */
+vector<vector<double>> Normalizer::inverseTransform(const vector<vector<double>>& rows_) const {
+    vector<vector<double>> result = rows_;
+    for (unsigned int i = 0; i < result.size(); i++) {
+        inverseTransform(result[i].data(),(result[i].size() == offsets.size()) ? 1 : 0);
+    }
+    return result;
+}
+
+/* --- persistence --- */
+
+/**
+ * @brief Normalizer::save writes the normalizer into a text file (see write)
+ * @param path_ path of the file
+ * @return returns true if the file has been written, otherwise false
+ */
+bool Normalizer::save(const string& path_) const {
+    ofstream oFile(path_);
+    if (!oFile.is_open()) {
+        cout << "Error : could not open " << path_ << endl;
+        return false;
+    }
+    if (!write(oFile)) {
+        cout << "Error : could not write " << path_ << endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Normalizer::load reads a normalizer from a text file written by save()
+ * @param path_ path of the file
+ * @return returns true if the normalizer has been read, otherwise false (the normalizer is not changed)
+ */
+bool Normalizer::load(const string& path_) {
+    ifstream iFile(path_);
+    if (!iFile.is_open()) {
+        cout << "Error : could not open " << path_ << endl;
+        return false;
+    }
+    if (!read(iFile)) {
+        cout << "Error : " << path_ << " contains no valid normalizer" << endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Normalizer::write writes the method and the statistics of every feature to oStream_
+ * @return returns true if everything has been written, otherwise false
+ *
+ * The values are written without loss of precision, therefore a normalizer which has been
+ * read back transforms exactly like the written one.
+ */
+bool Normalizer::write(ostream& oStream_) const {
+    oStream_ << "normalizer " << methodNames[method] << " " << statistics.size() << "\n";
+    char buffer[32];
+    for (unsigned int j = 0; j < statistics.size(); j++) {
+        oStream_ << statistics[j].count;
+        for (double value : {statistics[j].mean,statistics[j].sumOfSquaredDeviations,statistics[j].minimum,statistics[j].maximum}) {
+            oStream_ << " " << string(buffer,CsvWriter::formatDouble(value,buffer));
+        }
+        oStream_ << "\n";
+    }
+    return (bool)oStream_;
+}
+
+/**
+ * @brief Normalizer::read reads a normalizer written by write()
+ * @return returns true if a valid normalizer has been read, otherwise false (the normalizer is not changed)
+ */
+bool Normalizer::read(istream& iStream_) {
+    string keyword, methodName;
+    size_t numFeatures = 0;
+    iStream_ >> keyword >> methodName >> numFeatures;
+    const char** methodName_l = find(begin(methodNames),end(methodNames),methodName);
+    if (!iStream_ || keyword != "normalizer" || methodName_l == end(methodNames)) {
+        return false;
+    }
+
+    vector<Statistics> statistics_l(numFeatures);
+    for (size_t j = 0; j < numFeatures; j++) {
+        string texts[4];
+        iStream_ >> statistics_l[j].count >> texts[0] >> texts[1] >> texts[2] >> texts[3];
+        double* values[] = {&statistics_l[j].mean,&statistics_l[j].sumOfSquaredDeviations,&statistics_l[j].minimum,&statistics_l[j].maximum};
+        for (int k = 0; k < 4; k++) {
+            const char* text = texts[k].c_str();
+            if (!iStream_ || CsvReader::parseDouble(text,text + texts[k].size(),*values[k]) != text + texts[k].size()) {
+                return false;
+            }
+        }
+    }
+
+    method     = Method(methodName_l - begin(methodNames));
+    statistics = statistics_l;
+    updateCoefficients();
+    return true;
+}
+
+/* --- miscellaneous --- */
+
+/**
+ * @brief Normalizer::accumulate collects the statistics of numRows_ rows by Welford's algorithm
+ */
+void Normalizer::accumulate(const double* rows_, size_t numRows_, int numFeatures_, vector<Statistics>& statistics_) {
+    Statistics empty = {0,0.0,0.0,numeric_limits<double>::infinity(),-numeric_limits<double>::infinity()};
+    statistics_.assign(numFeatures_,empty);
+    for (size_t r = 0; r < numRows_; r++) {
+        for (int j = 0; j < numFeatures_; j++) {
+            double value = rows_[r * numFeatures_ + j];
+            Statistics& s = statistics_[j];
+            s.count++;
+            double delta = value - s.mean;
+            s.mean += delta / s.count;
+            s.sumOfSquaredDeviations += delta * (value - s.mean);
+            s.minimum = min(s.minimum,value);
+            s.maximum = max(s.maximum,value);
+        }
+    }
+}
+
+/**
+ * @brief Normalizer::combine merges the statistics of two disjoint sets of samples into statistics_
+ */
+void Normalizer::combine(Statistics& statistics_, const Statistics& other_) {
+    if (other_.count == 0) {
+        return;
+    }
+    double count = double(statistics_.count) + double(other_.count);
+    double delta = other_.mean - statistics_.mean;
+    statistics_.mean += delta * other_.count / count;
+    statistics_.sumOfSquaredDeviations += other_.sumOfSquaredDeviations + delta * delta * statistics_.count * other_.count / count;
+    statistics_.count  += other_.count;
+    statistics_.minimum = min(statistics_.minimum,other_.minimum);
+    statistics_.maximum = max(statistics_.maximum,other_.maximum);
+}
+
+/**
+ * @brief Normalizer::updateCoefficients derives the coefficients of every feature from its statistics
+ *
+ * transform(x) = x * factor + summand, with summand = -offset * factor
+ * inverseTransform(y) = y * inverseFactor + offset
+ */
+void Normalizer::updateCoefficients() {
+    offsets       .assign(statistics.size(),0.0);
+    factors       .assign(statistics.size(),1.0);
+    inverseFactors.assign(statistics.size(),1.0);
+    summands      .assign(statistics.size(),0.0);
+    for (unsigned int j = 0; j < statistics.size(); j++) {
+        double scale = 0.0;
+        if (method == Z_SCORE) {
+            offsets[j] = statistics[j].mean;
+            scale      = getStandardDeviation(j);
+        } else if (method == MIN_MAX) {
+            offsets[j] = 0.5 * (statistics[j].maximum + statistics[j].minimum);
+            scale      = 0.5 * (statistics[j].maximum - statistics[j].minimum);
+        }
+        if (scale > 0.0) {
+            factors[j]        = 1.0 / scale;
+            inverseFactors[j] = scale;
+        }
+        summands[j] = -offsets[j] * factors[j];
+    }
+}
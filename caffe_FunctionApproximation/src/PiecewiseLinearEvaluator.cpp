@@ -0,0 +1,401 @@
+#include "PiecewiseLinearEvaluator.h"
+
+// STL
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <iostream>
+
+/* --- constructors / destructors --- */
+
+/**
+ * @brief PiecewiseLinearEvaluator::PiecewiseLinearEvaluator constructor of class PiecewiseLinearEvaluator
+ *
+ * By default build() gives up after 1000000 regions.
+ */
+PiecewiseLinearEvaluator::PiecewiseLinearEvaluator()
+    : numInputs(0), numOutputs(0), maxRegions(1000000), numCellsPerDimension(0) {
+}
+
+/* --- building --- */
+
+/**
+ * @brief PiecewiseLinearEvaluator::build enumerates the linear regions of mlp_ within domain_
+ * @param mlp_    the net, which has to consist of InnerProduct layers with ReLU or no activation
+ * @param domain_ 1- or 2-dimensional box the net is to evaluate on
+ * @return returns true if all regions have been enumerated, otherwise false
+ *
+ * Every region carries the affine map from the input value to the values of the current layer.
+ * Starting with the whole domain and the identity map, every layer is processed as follows :
+ *   1. the affine map is extended by the InnerProduct layer (pre-activations of the layer)
+ *   2. for every ReLU neuron whose pre-activation changes its sign within the region, the
+ *      region is split into the part where it is positive and the part where it is negative
+ *   3. on every resulting part the activation pattern is fixed, therefore the ReLU only
+ *      scales the rows of inactive neurons by the negative slope
+ * After the last layer the affine map of every region is the map from input to output.
+ *
+ * NOTICE : if the net contains other activations than ReLU, the dimension is not 1 or 2 or more
+ *          than maxRegions regions arise, the function prints an error and returns false
+ */
+bool PiecewiseLinearEvaluator::build(const MLP& mlp_, const Domain& domain_) {
+    regions.clear();
+    leftBounds.clear();
+    cells.clear();
+
+    const vector<MLP::DenseLayer>& layers = mlp_.getLayers();
+    if (layers.empty() || domain_.dimension() != mlp_.getNumInputs()) {
+        cout << "Error : dimension of the domain does not fit to the number of inputs" << endl;
+        return false;
+    }
+    if (domain_.dimension() != 1 && domain_.dimension() != 2) {
+        cout << "Error : linear regions can only be built for 1 or 2 inputs" << endl;
+        return false;
+    }
+    for (unsigned int l = 0; l < layers.size(); l++) {
+        if (layers[l].activation != MLP::LINEAR && layers[l].activation != MLP::RELU) {
+            cout << "Error : layer " << layers[l].name << " is not piecewise linear" << endl;
+            return false;
+        }
+    }
+
+    numInputs  = mlp_.getNumInputs();
+    numOutputs = mlp_.getNumOutputs();
+    domain     = domain_;
+
+    // the whole domain with the identity map
+    Region initial;
+    if (numInputs == 1) {
+        initial.vertices = {domain.lowerBounds[0], domain.upperBounds[0]};
+        initial.slope    = {1.0};
+        initial.offset   = {0.0};
+    } else {
+        initial.vertices = {domain.lowerBounds[0], domain.lowerBounds[1],
+                            domain.upperBounds[0], domain.lowerBounds[1],
+                            domain.upperBounds[0], domain.upperBounds[1],
+                            domain.lowerBounds[0], domain.upperBounds[1]};
+        initial.slope    = {1.0, 0.0, 0.0, 1.0};
+        initial.offset   = {0.0, 0.0};
+    }
+
+    vector<Region> current(1,initial);
+    vector<Region> next;
+    for (unsigned int l = 0; l < layers.size(); l++) {
+        const MLP::DenseLayer& layer = layers[l];
+        next.clear();
+
+        for (unsigned int r = 0; r < current.size(); r++) {
+            // 1. pre-activations of this layer as affine map of the input value
+            Region preActivation;
+            preActivation.vertices = current[r].vertices;
+            preActivation.slope.assign(layer.numOutputs * numInputs,0.0);
+            preActivation.offset.assign(layer.numOutputs,0.0);
+            for (int o = 0; o < layer.numOutputs; o++) {
+                preActivation.offset[o] = layer.biases[o];
+                for (int i = 0; i < layer.numInputs; i++) {
+                    double weight = layer.weights[o * layer.numInputs + i];
+                    preActivation.offset[o] += weight * current[r].offset[i];
+                    for (int d = 0; d < numInputs; d++) {
+                        preActivation.slope[o * numInputs + d] += weight * current[r].slope[i * numInputs + d];
+                    }
+                }
+            }
+
+            if (layer.activation == MLP::LINEAR) {
+                next.push_back(preActivation);
+                continue;
+            }
+
+            // 2. split along the sign changes of every neuron
+            vector<Region> pieces(1,preActivation);
+            for (int o = 0; o < layer.numOutputs; o++) {
+                vector<Region> splitPieces;
+                for (unsigned int p = 0; p < pieces.size(); p++) {
+                    Region positive;
+                    Region negative;
+                    if (splitRegion(pieces[p],&preActivation.slope[o * numInputs],preActivation.offset[o],positive,negative)) {
+                        splitPieces.push_back(positive);
+                        splitPieces.push_back(negative);
+                    } else {
+                        splitPieces.push_back(pieces[p]);
+                    }
+                }
+                pieces.swap(splitPieces);
+                if ((int)(next.size() + pieces.size()) > maxRegions) {
+                    cout << "Error : net has more than " << maxRegions << " linear regions" << endl;
+                    return false;
+                }
+            }
+
+            // 3. apply the fixed activation pattern of every piece
+            for (unsigned int p = 0; p < pieces.size(); p++) {
+                Region& piece = pieces[p];
+                int numVertices = (int)piece.vertices.size() / numInputs;
+                vector<double> centroid(numInputs,0.0);
+                for (int v = 0; v < numVertices; v++) {
+                    for (int d = 0; d < numInputs; d++) {
+                        centroid[d] += piece.vertices[v * numInputs + d] / numVertices;
+                    }
+                }
+                for (int o = 0; o < layer.numOutputs; o++) {
+                    double value = piece.offset[o];
+                    for (int d = 0; d < numInputs; d++) {
+                        value += piece.slope[o * numInputs + d] * centroid[d];
+                    }
+                    if (value < 0) {
+                        piece.offset[o] *= layer.negativeSlope;
+                        for (int d = 0; d < numInputs; d++) {
+                            piece.slope[o * numInputs + d] *= layer.negativeSlope;
+                        }
+                    }
+                }
+                next.push_back(piece);
+            }
+        }
+        current.swap(next);
+    }
+
+    regions.swap(current);
+    buildLookup();
+    return true;
+}
+
+/**
+ * @brief PiecewiseLinearEvaluator::splitRegion splits region_ along gradient_ * x + constant_ = 0
+ * @return returns true if the line crosses the interior of region_, otherwise false
+ *
+ * positive_ gets the part of region_ with gradient_ * x + constant_ >= 0, negative_ the rest.
+ * Polygons are clipped by the Sutherland-Hodgman algorithm, which keeps the counter-clockwise
+ * order of the vertices.
+ */
+bool PiecewiseLinearEvaluator::splitRegion(const Region& region_, const double* gradient_, double constant_,
+                                           Region& positive_, Region& negative_) const {
+    int numVertices = (int)region_.vertices.size() / numInputs;
+    vector<double> values(numVertices);
+    double scale = fabs(constant_);
+    for (int v = 0; v < numVertices; v++) {
+        values[v] = constant_;
+        for (int d = 0; d < numInputs; d++) {
+            values[v] += gradient_[d] * region_.vertices[v * numInputs + d];
+            scale     += fabs(gradient_[d] * region_.vertices[v * numInputs + d]);
+        }
+    }
+
+    // the line does not cross the region
+    double tolerance = 1e-12 * (scale + 1.0);
+    double minValue = *min_element(values.begin(),values.end());
+    double maxValue = *max_element(values.begin(),values.end());
+    if (minValue >= -tolerance || maxValue <= tolerance) {
+        return false;
+    }
+
+    positive_ = region_;
+    negative_ = region_;
+
+    if (numInputs == 1) {
+        double root = -constant_ / gradient_[0];
+        if (gradient_[0] > 0) {
+            negative_.vertices = {region_.vertices[0], root};
+            positive_.vertices = {root, region_.vertices[1]};
+        } else {
+            positive_.vertices = {region_.vertices[0], root};
+            negative_.vertices = {root, region_.vertices[1]};
+        }
+        return true;
+    }
+
+    positive_.vertices.clear();
+    negative_.vertices.clear();
+    for (int v = 0; v < numVertices; v++) {
+        int w = (v + 1) % numVertices;
+        const double* p = &region_.vertices[v * 2];
+        const double* q = &region_.vertices[w * 2];
+
+        if (values[v] >= 0) {
+            positive_.vertices.push_back(p[0]);
+            positive_.vertices.push_back(p[1]);
+        }
+        if (values[v] <= 0) {
+            negative_.vertices.push_back(p[0]);
+            negative_.vertices.push_back(p[1]);
+        }
+        // edge crosses the line
+        if ((values[v] > 0 && values[w] < 0) || (values[v] < 0 && values[w] > 0)) {
+            double t = values[v] / (values[v] - values[w]);
+            double x = p[0] + t * (q[0] - p[0]);
+            double y = p[1] + t * (q[1] - p[1]);
+            positive_.vertices.push_back(x);
+            positive_.vertices.push_back(y);
+            negative_.vertices.push_back(x);
+            negative_.vertices.push_back(y);
+        }
+    }
+    return (positive_.vertices.size() >= 6) && (negative_.vertices.size() >= 6);
+}
+
+/**
+ * @brief PiecewiseLinearEvaluator::buildLookup builds the search structure over all regions
+ */
+void PiecewiseLinearEvaluator::buildLookup() {
+    // bounding boxes {xMin, xMax, yMin, yMax}
+    for (unsigned int r = 0; r < regions.size(); r++) {
+        Region& region = regions[r];
+        region.boundingBox[0] = region.boundingBox[2] =  numeric_limits<double>::max();
+        region.boundingBox[1] = region.boundingBox[3] = -numeric_limits<double>::max();
+        int numVertices = (int)region.vertices.size() / numInputs;
+        for (int v = 0; v < numVertices; v++) {
+            for (int d = 0; d < numInputs; d++) {
+                region.boundingBox[2 * d]     = min(region.boundingBox[2 * d],    region.vertices[v * numInputs + d]);
+                region.boundingBox[2 * d + 1] = max(region.boundingBox[2 * d + 1],region.vertices[v * numInputs + d]);
+            }
+        }
+    }
+
+    if (numInputs == 1) {
+        sort(regions.begin(),regions.end(),[](const Region& a_, const Region& b_) {
+            return a_.boundingBox[0] < b_.boundingBox[0];
+        });
+        for (unsigned int r = 0; r < regions.size(); r++) {
+            leftBounds.push_back(regions[r].boundingBox[0]);
+        }
+        return;
+    }
+
+    // uniform grid with about one region per cell
+    numCellsPerDimension = max(1,min(1024,(int)ceil(sqrt((double)regions.size()))));
+    cells.assign(numCellsPerDimension * numCellsPerDimension,vector<int>());
+    for (unsigned int r = 0; r < regions.size(); r++) {
+        int cellRange[4];
+        for (int d = 0; d < 2; d++) {
+            for (int side = 0; side < 2; side++) {
+                double relative = (regions[r].boundingBox[2 * d + side] - domain.lowerBounds[d]) / domain.width(d);
+                cellRange[2 * d + side] = max(0,min(numCellsPerDimension - 1,(int)floor(relative * numCellsPerDimension)));
+            }
+        }
+        for (int cx = cellRange[0]; cx <= cellRange[1]; cx++) {
+            for (int cy = cellRange[2]; cy <= cellRange[3]; cy++) {
+                cells[cx * numCellsPerDimension + cy].push_back(r);
+            }
+        }
+    }
+}
+
+/* --- evaluation --- */
+
+/**
+ * @brief PiecewiseLinearEvaluator::evaluate calculates the output of the net for one input value
+ * @param inputValue_  pointer to the input value (numInputs values)
+ * @param outputValue_ pointer to numOutputs values the result is written to
+ * @return returns false if the input value is outside of the domain, otherwise true
+ */
+bool PiecewiseLinearEvaluator::evaluate(const double* inputValue_, double* outputValue_) const {
+    int r = findRegion(inputValue_);
+    if (r < 0) {
+        return false;
+    }
+
+    const Region& region = regions[r];
+    for (int o = 0; o < numOutputs; o++) {
+        double value = region.offset[o];
+        for (int d = 0; d < numInputs; d++) {
+            value += region.slope[o * numInputs + d] * inputValue_[d];
+        }
+        outputValue_[o] = value;
+    }
+    return true;
+}
+
+/**
+ * @brief PiecewiseLinearEvaluator::evaluate calculates the outputs of the net for a batch of input values
+ * @param inputValues_  pointer to numSamples_ * numInputs input values (row-major)
+ * @param numSamples_   number of samples
+ * @param outputValues_ pointer to numSamples_ * numOutputs values the results are written to (row-major)
+ *
+ * NOTICE : the outputs of input values outside of the domain are set to NaN
+ */
+void PiecewiseLinearEvaluator::evaluate(const double* inputValues_, int numSamples_, double* outputValues_) const {
+    for (int s = 0; s < numSamples_; s++) {
+        if (!evaluate(&inputValues_[s * numInputs],&outputValues_[s * numOutputs])) {
+            for (int o = 0; o < numOutputs; o++) {
+                outputValues_[s * numOutputs + o] = numeric_limits<double>::quiet_NaN();
+            }
+        }
+    }
+}
+
+/**
+ * @brief PiecewiseLinearEvaluator::evaluate calculates the output of the net for one input value
+ * @return returns the output values, or an empty vector if the input value is outside of the domain
+ */
+vector<double> PiecewiseLinearEvaluator::evaluate(const vector<double>& inputValue_) const {
+    vector<double> result(numOutputs);
+    if ((int)inputValue_.size() != numInputs || !evaluate(inputValue_.data(),result.data())) {
+        result.clear();
+    }
+    return result;
+}
+
+/**
+ * @brief PiecewiseLinearEvaluator::findRegion finds the index of the region containing inputValue_
+ * @return returns the index of the region, or -1 if inputValue_ is outside of the domain
+ *
+ * Because of rounding a point on the border between two regions may be slightly outside of both
+ * of them. In this case the region with the smallest violation is taken, the affine maps of
+ * neighbouring regions agree on their common border.
+ */
+int PiecewiseLinearEvaluator::findRegion(const double* inputValue_) const {
+    if (regions.empty()) {
+        return -1;
+    }
+    for (int d = 0; d < numInputs; d++) {
+        if (inputValue_[d] < domain.lowerBounds[d] || inputValue_[d] > domain.upperBounds[d]) {
+            return -1;
+        }
+    }
+
+    if (numInputs == 1) {
+        int r = (int)(upper_bound(leftBounds.begin(),leftBounds.end(),inputValue_[0]) - leftBounds.begin()) - 1;
+        return max(0,r);
+    }
+
+    int cellIndex[2];
+    for (int d = 0; d < 2; d++) {
+        double relative = (inputValue_[d] - domain.lowerBounds[d]) / domain.width(d);
+        cellIndex[d] = max(0,min(numCellsPerDimension - 1,(int)floor(relative * numCellsPerDimension)));
+    }
+    const vector<int>& candidates = cells[cellIndex[0] * numCellsPerDimension + cellIndex[1]];
+
+    int    bestRegion    = -1;
+    double bestViolation = numeric_limits<double>::max();
+    for (unsigned int c = 0; c < candidates.size(); c++) {
+        double currentViolation = violation(regions[candidates[c]],inputValue_);
+        if (currentViolation <= 0) {
+            return candidates[c];
+        }
+        if (currentViolation < bestViolation) {
+            bestViolation = currentViolation;
+            bestRegion    = candidates[c];
+        }
+    }
+    return bestRegion;
+}
+
+/**
+ * @brief PiecewiseLinearEvaluator::violation calculates how far inputValue_ lies outside of region_
+ * @return returns the largest distance to the outside of an edge, or zero if inputValue_ is inside of region_
+ */
+double PiecewiseLinearEvaluator::violation(const Region& region_, const double* inputValue_) const {
+    double result = 0;
+    int numVertices = (int)region_.vertices.size() / 2;
+    for (int v = 0; v < numVertices; v++) {
+        int w = (v + 1) % numVertices;
+        double edgeX = region_.vertices[w * 2]     - region_.vertices[v * 2];
+        double edgeY = region_.vertices[w * 2 + 1] - region_.vertices[v * 2 + 1];
+        double cross = edgeX * (inputValue_[1] - region_.vertices[v * 2 + 1]) -
+                       edgeY * (inputValue_[0] - region_.vertices[v * 2]);
+        double length = sqrt(edgeX * edgeX + edgeY * edgeY);
+        if (length > 0) {
+            result = max(result,-cross / length);
+        }
+    }
+    return result;
+}
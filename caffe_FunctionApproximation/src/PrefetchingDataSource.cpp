@@ -0,0 +1,127 @@
+#include "PrefetchingDataSource.h"
+
+// STL
+#include <algorithm>
+
+/* --- constructors / destructors --- */
+
+/**
+ * @brief PrefetchingDataSource::PrefetchingDataSource constructor of class PrefetchingDataSource
+ * @param source_     source the batches are read from
+ * @param numBuffers_ number of batches which are held in memory at the same time
+ */
+PrefetchingDataSource::PrefetchingDataSource(DataSource& source_, int numBuffers_)
+    : source(source_), numBuffers(max(numBuffers_,2)), batchSize(0), hasCurrentBatch(false), positionInBatch(0) {
+}
+
+/**
+ * @brief PrefetchingDataSource::~PrefetchingDataSource stops the background thread
+ */
+PrefetchingDataSource::~PrefetchingDataSource() {
+    stop();
+}
+
+/* --- reading samples --- */
+
+/**
+ * @brief PrefetchingDataSource::nextBatch copies the next prefetched batch into the given buffers
+ * @param batchSize_    number of samples to copy
+ * @param inputValues_  buffer for batchSize_ * getNumInputs() input values
+ * @param outputValues_ buffer for batchSize_ * getNumOutputs() expected output values
+ *
+ * Blocks until the background thread has read the samples. The samples are taken from the
+ * current buffer, a batch which exceeds it is completed from the next buffers. Therefore the
+ * samples arrive in the order of the wrapped source, whatever the sizes of the batches are.
+ */
+void PrefetchingDataSource::nextBatch(int batchSize_, double* inputValues_, double* outputValues_) {
+    if (batchSize_ <= 0) {
+        return;
+    }
+    if (!producer.joinable()) {
+        start(batchSize_);
+    }
+
+    int numInputs  = getNumInputs();
+    int numOutputs = getNumOutputs();
+    for (int numCopied = 0; numCopied < batchSize_; ) {
+        if (!hasCurrentBatch) {
+            if (!filledBatches->pop(currentBatch)) {
+                return;
+            }
+            hasCurrentBatch = true;
+            positionInBatch = 0;
+        }
+
+        int num = min(batchSize_ - numCopied,batchSize - positionInBatch);
+        copy(currentBatch.inputValues.begin() + positionInBatch * numInputs,
+             currentBatch.inputValues.begin() + (positionInBatch + num) * numInputs,
+             inputValues_ + numCopied * numInputs);
+        copy(currentBatch.outputValues.begin() + positionInBatch * numOutputs,
+             currentBatch.outputValues.begin() + (positionInBatch + num) * numOutputs,
+             outputValues_ + numCopied * numOutputs);
+        positionInBatch += num;
+        numCopied       += num;
+
+        // hand the used up buffer back for the next batch
+        if (positionInBatch == batchSize) {
+            emptyBatches->push(std::move(currentBatch));
+            hasCurrentBatch = false;
+        }
+    }
+}
+
+/**
+ * @brief PrefetchingDataSource::rewind drops all prefetched batches and rewinds the wrapped source
+ */
+void PrefetchingDataSource::rewind() {
+    stop();
+    source.rewind();
+}
+
+/**
+ * @brief PrefetchingDataSource::start allocates the buffers and starts the background thread
+ * @param batchSize_ number of samples per batch
+ */
+void PrefetchingDataSource::start(int batchSize_) {
+    batchSize = batchSize_;
+    emptyBatches.reset(new BoundedQueue<Batch>(numBuffers));
+    filledBatches.reset(new BoundedQueue<Batch>(numBuffers));
+
+    for (int i = 0; i < numBuffers; i++) {
+        Batch batch;
+        batch.inputValues.resize(batchSize * getNumInputs());
+        batch.outputValues.resize(batchSize * getNumOutputs());
+        emptyBatches->push(std::move(batch));
+    }
+
+    producer = thread(&PrefetchingDataSource::produce,this);
+}
+
+/**
+ * @brief PrefetchingDataSource::stop stops the background thread and drops all prefetched batches
+ *
+ * NOTICE : prefetched samples which have not been taken yet are lost, for a shuffling
+ *          source this only means a slightly different order of the samples
+ */
+void PrefetchingDataSource::stop() {
+    if (producer.joinable()) {
+        emptyBatches->close();
+        filledBatches->close();
+        producer.join();
+    }
+    batchSize       = 0;
+    hasCurrentBatch = false;
+}
+
+/**
+ * @brief PrefetchingDataSource::produce fills empty buffers from the wrapped source until stop() is called
+ */
+void PrefetchingDataSource::produce() {
+    Batch batch;
+    while (emptyBatches->pop(batch)) {
+        source.nextBatch(batchSize,batch.inputValues.data(),batch.outputValues.data());
+        if (!filledBatches->push(std::move(batch))) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,288 @@
+#include "QuasiRandomSampler.h"
+
+// STL
+#include <iostream>
+#include <random>
+#include <numeric>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+/**
+ * primitive polynomials and initial direction numbers of Joe and Kuo (new-joe-kuo-6.21201)
+ * for the dimensions 2 ... 21, dimension 1 is the van der Corput sequence in base 2
+ *   degree : degree s of the primitive polynomial
+ *   a      : coefficients a_1 ... a_(s-1) of the polynomial (a_1 is the most significant bit)
+ *   m      : initial direction numbers m_1 ... m_s
+ */
+struct SobolParameters {
+    int          degree;
+    unsigned int a;
+    unsigned int m[7];
+};
+
+const SobolParameters sobolParameters[] = {
+    {1,  0, {1}},
+    {2,  1, {1, 3}},
+    {3,  1, {1, 3, 1}},
+    {3,  2, {1, 1, 1}},
+    {4,  1, {1, 1, 3, 3}},
+    {4,  4, {1, 3, 5, 13}},
+    {5,  2, {1, 1, 5, 5, 17}},
+    {5,  4, {1, 1, 5, 5, 5}},
+    {5,  7, {1, 1, 7, 11, 19}},
+    {5, 11, {1, 1, 5, 1, 1}},
+    {5, 13, {1, 1, 1, 3, 11}},
+    {5, 14, {1, 3, 5, 5, 31}},
+    {6,  1, {1, 3, 3, 9, 7, 49}},
+    {6, 13, {1, 1, 1, 15, 21, 21}},
+    {6, 16, {1, 3, 1, 13, 27, 49}},
+    {6, 19, {1, 1, 1, 15, 7, 5}},
+    {6, 22, {1, 3, 1, 15, 13, 25}},
+    {6, 25, {1, 1, 5, 5, 19, 61}},
+    {7,  1, {1, 3, 7, 11, 23, 15, 103}},
+    {7,  4, {1, 3, 7, 13, 13, 15, 69}}
+};
+
+const int numDirectionNumbers = 32;
+
+}
+
+/* --- constructors / destructors --- */
+
+/**
+ * @brief QuasiRandomSampler::QuasiRandomSampler constructor of class QuasiRandomSampler
+ * @param domain_    box the points are placed in
+ * @param sequence_  low-discrepancy sequence
+ * @param scrambled_ randomize the sequence
+ * @param seed_      seed of the randomization
+ *
+ * NOTICE : if the dimension of domain_ is not supported by the sequence an error is printed
+ *          and isValid() returns false
+ */
+QuasiRandomSampler::QuasiRandomSampler(const Domain& domain_, Sequence sequence_, bool scrambled_, unsigned long long seed_)
+    : domain(domain_), sequence(sequence_), scrambled(scrambled_), valid(true) {
+    if (sequence == SOBOL) {
+        if (domain.dimension() > getMaxSobolDimension()) {
+            cout << "Error : Sobol sequences are supported up to " << getMaxSobolDimension() << " dimensions" << endl;
+            valid = false;
+            return;
+        }
+        initSobol(seed_);
+    } else {
+        initHalton(seed_);
+    }
+}
+
+/* --- getter / setter --- */
+
+/**
+ * @brief QuasiRandomSampler::getMaxSobolDimension returns the highest dimension Sobol points are available for
+ */
+int QuasiRandomSampler::getMaxSobolDimension() {
+    return 1 + sizeof(sobolParameters) / sizeof(sobolParameters[0]);
+}
+
+/* --- sampling --- */
+
+/**
+ * @brief QuasiRandomSampler::point calculates the point with the given index
+ * @param index_ index of the point within the sequence (Sobol : below 2^32)
+ * @param point_ buffer for domain_.dimension() values
+ */
+void QuasiRandomSampler::point(unsigned long long index_, double* point_) const {
+    int dimension = domain.dimension();
+    if (!valid) {
+        fill(point_,point_ + dimension,0.0);
+        return;
+    }
+
+    for (int i = 0; i < dimension; i++) {
+        double unit = 0;
+        if (sequence == SOBOL) {
+            // points in Gray code order : the point is the sum of the direction numbers of the set bits of the Gray code
+            unsigned long long grayCode = index_ ^ (index_ >> 1);
+            unsigned int       value    = 0;
+            for (int k = 0; grayCode != 0 && k < numDirectionNumbers; k++, grayCode >>= 1) {
+                if (grayCode & 1) {
+                    value ^= directionNumbers[i][k];
+                }
+            }
+            value ^= shifts[i];
+            unit = double(value) / 4294967296.0;
+        } else {
+            // radical inverse : mirror the digits of the index at the decimal point
+            unsigned long long rest   = index_;
+            double             factor = 1.0 / bases[i];
+            for (int k = 0; rest != 0; k++, rest /= bases[i], factor /= bases[i]) {
+                unsigned int digit = rest % bases[i];
+                if (scrambled) {
+                    digit = digitPermutations[i][k][digit];
+                }
+                unit += digit * factor;
+            }
+        }
+        point_[i] = domain.lowerBounds[i] + unit * domain.width(i);
+    }
+}
+
+/**
+ * @brief QuasiRandomSampler::point returns the point with the given index
+ * @param index_ index of the point within the sequence
+ * @return returns the point as vector of domain_.dimension() values
+ */
+vector<double> QuasiRandomSampler::point(unsigned long long index_) const {
+    vector<double> result(domain.dimension());
+    point(index_,result.data());
+    return result;
+}
+
+/**
+ * @brief QuasiRandomSampler::sample returns the points firstIndex_ ... firstIndex_ + numSamples_ - 1
+ * @param numSamples_ number of points
+ * @param firstIndex_ index of the first point
+ * @return returns the points in the layout of the multi-input train and forward functions of ANN
+ *
+ * NOTICE : Sobol points are equidistributed best for numSamples_ = 2^m and firstIndex_ = 0
+ */
+vector<vector<double>> QuasiRandomSampler::sample(unsigned long long numSamples_, unsigned long long firstIndex_) const {
+    vector<vector<double>> result(numSamples_,vector<double>(domain.dimension()));
+    for (unsigned long long i = 0; i < numSamples_; i++) {
+        point(firstIndex_ + i,result[i].data());
+    }
+    return result;
+}
+
+/**
+ * @brief QuasiRandomSampler::sample creates a training set of numSamples_ points and the values of targetFunction_ at these points
+ * @param numSamples_           number of points
+ * @param targetFunction_       function which is to approximate
+ * @param inputValues_          the points
+ * @param expectedOutputValues_ the values of targetFunction_ at the points
+ */
+void QuasiRandomSampler::sample(unsigned long long numSamples_, const function<double(const vector<double>&)>& targetFunction_,
+                                vector<vector<double>>& inputValues_, vector<double>& expectedOutputValues_) const {
+    inputValues_ = sample(numSamples_);
+    expectedOutputValues_.resize(numSamples_);
+    for (unsigned long long i = 0; i < numSamples_; i++) {
+        expectedOutputValues_[i] = targetFunction_(inputValues_[i]);
+    }
+}
+
+/**
+ * @brief QuasiRandomSampler::initSobol calculates the direction numbers of all dimensions
+ * @param seed_ seed of the scrambling
+ *
+ * The direction numbers v_k = m_k / 2^k are stored as 32 bit fractions. The m_k beyond the
+ * initial ones follow from the recurrence of the primitive polynomial of degree s :
+ *     m_k = 2^s m_(k-s) xor m_(k-s) xor 2^1 a_1 m_(k-1) xor ... xor 2^(s-1) a_(s-1) m_(k-s+1)
+ *
+ * Scrambling multiplies every direction number by a random lower triangular bit matrix with
+ * unit diagonal (every output digit is the input digit plus a random sum of the more
+ * significant input digits) and xors every point with a random shift.
+ */
+void QuasiRandomSampler::initSobol(unsigned long long seed_) {
+    int dimension = domain.dimension();
+    directionNumbers.assign(dimension,vector<unsigned int>(numDirectionNumbers));
+    shifts.assign(dimension,0);
+
+    for (int i = 0; i < dimension; i++) {
+        vector<unsigned int>& v = directionNumbers[i];
+        if (i == 0) {
+            for (int k = 0; k < numDirectionNumbers; k++) {
+                v[k] = 1u << (31 - k);
+            }
+        } else {
+            const SobolParameters& parameters = sobolParameters[i - 1];
+            int s = parameters.degree;
+            vector<unsigned int> m(numDirectionNumbers);
+            for (int k = 0; k < numDirectionNumbers; k++) {
+                if (k < s) {
+                    m[k] = parameters.m[k];
+                } else {
+                    m[k] = (m[k - s] << s) ^ m[k - s];
+                    for (int j = 1; j < s; j++) {
+                        if ((parameters.a >> (s - 1 - j)) & 1) {
+                            m[k] ^= m[k - j] << j;
+                        }
+                    }
+                }
+                v[k] = m[k] << (31 - k);
+            }
+        }
+    }
+
+    if (!scrambled) {
+        return;
+    }
+
+    mt19937_64 generator(seed_);
+    for (int i = 0; i < dimension; i++) {
+        // row r of the matrix : diagonal bit and random bits of the more significant digits
+        vector<unsigned int> rows(32);
+        for (int r = 0; r < 32; r++) {
+            unsigned int diagonal = 1u << (31 - r);
+            unsigned int higher   = (r == 0) ? 0u : ~((diagonal << 1) - 1u);
+            rows[r] = diagonal | ((unsigned int)generator() & higher);
+        }
+        for (int k = 0; k < numDirectionNumbers; k++) {
+            unsigned int scrambledValue = 0;
+            for (int r = 0; r < 32; r++) {
+                unsigned int bits = rows[r] & directionNumbers[i][k];
+                // parity of the selected digits
+                bits ^= bits >> 16;
+                bits ^= bits >> 8;
+                bits ^= bits >> 4;
+                bits ^= bits >> 2;
+                bits ^= bits >> 1;
+                scrambledValue |= (bits & 1u) << (31 - r);
+            }
+            directionNumbers[i][k] = scrambledValue;
+        }
+        shifts[i] = (unsigned int)generator();
+    }
+}
+
+/**
+ * @brief QuasiRandomSampler::initHalton chooses the prime bases and the digit permutations of all dimensions
+ * @param seed_ seed of the scrambling
+ *
+ * Every digit position of every dimension gets its own random permutation of the digits.
+ * The digit 0 is kept, therefore the (infinitely many) leading zeros of the index stay zeros.
+ */
+void QuasiRandomSampler::initHalton(unsigned long long seed_) {
+    int dimension = domain.dimension();
+    bases.clear();
+    for (unsigned int candidate = 2; (int)bases.size() < dimension; candidate++) {
+        bool prime = true;
+        for (unsigned int i = 0; i < bases.size() && bases[i] * bases[i] <= candidate; i++) {
+            if (candidate % bases[i] == 0) {
+                prime = false;
+                break;
+            }
+        }
+        if (prime) {
+            bases.push_back(candidate);
+        }
+    }
+
+    digitPermutations.clear();
+    if (!scrambled) {
+        return;
+    }
+
+    mt19937_64 generator(seed_);
+    digitPermutations.resize(dimension);
+    for (int i = 0; i < dimension; i++) {
+        // number of digits of a 64 bit index in base bases[i]
+        int numDigits = (int)ceil(64.0 / log2(double(bases[i])));
+        digitPermutations[i].resize(numDigits);
+        for (int k = 0; k < numDigits; k++) {
+            vector<unsigned int>& permutation = digitPermutations[i][k];
+            permutation.resize(bases[i]);
+            iota(permutation.begin(),permutation.end(),0);
+            shuffle(permutation.begin() + 1,permutation.end(),generator);
+        }
+    }
+}
@@ -0,0 +1,403 @@
+#include "RingAllReduce.h"
+
+// STL
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <thread>
+#include <cstdint>
+#include <cerrno>
+// POSIX
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * splits "host:port" into host and port
+ */
+bool splitAddress(const string& address_, string& host_, string& port_) {
+    size_t colon = address_.rfind(':');
+    if (colon == string::npos || colon + 1 == address_.size()) {
+        return false;
+    }
+    host_ = address_.substr(0,colon);
+    port_ = address_.substr(colon + 1);
+    return true;
+}
+
+/**
+ * disables Nagle's algorithm, the chunks are sent as soon as they are complete
+ */
+void setNoDelay(int socket_) {
+    int one = 1;
+    setsockopt(socket_,IPPROTO_TCP,TCP_NODELAY,&one,sizeof(one));
+}
+
+}
+
+/* --- constructors / destructors --- */
+
+/**
+ * @brief RingAllReduce::RingAllReduce connects rank rank_ to the ring of all ranks
+ * @param rank_           rank of this process (0 .. addresses_.size() - 1)
+ * @param addresses_      addresses ("host:port") of all ranks
+ * @param timeoutSeconds_ time to wait for the other ranks, both for connecting and for every exchange
+ *
+ * NOTICE : all ranks have to be started within the timeout
+ */
+RingAllReduce::RingAllReduce(int rank_, const vector<string>& addresses_, int timeoutSeconds_)
+    : rank(rank_), worldSize(addresses_.size()), timeoutSeconds(timeoutSeconds_), open(false), nextSocket(-1), previousSocket(-1) {
+    if (rank < 0 || rank >= worldSize) {
+        cout << "Error : rank " << rank << " is not part of a ring of " << worldSize << " ranks" << endl;
+        return;
+    }
+    open = connectRing(addresses_);
+}
+
+/**
+ * @brief RingAllReduce::~RingAllReduce closes the connections
+ */
+RingAllReduce::~RingAllReduce() {
+    if (nextSocket >= 0) {
+        close(nextSocket);
+    }
+    if (previousSocket >= 0) {
+        close(previousSocket);
+    }
+}
+
+/* --- communication --- */
+
+/**
+ * @brief RingAllReduce::allReduce replaces values_ by the sum of values_ of all ranks
+ * @param values_    buffer of numValues_ values, numValues_ has to be equal on all ranks
+ * @param numValues_ number of values
+ * @return returns true if the sum has been received, otherwise false (values_ is undefined then)
+ */
+bool RingAllReduce::allReduce(double* values_, size_t numValues_) {
+    if (!open) {
+        return false;
+    }
+    if (worldSize == 1) {
+        return true;
+    }
+
+    // chunk c : values [chunkBegin(c), chunkBegin(c + 1))
+    auto chunkBegin = [this, numValues_](int chunk_) {return numValues_ * chunk_ / worldSize;};
+    auto chunkSize  = [&chunkBegin](int chunk_) {return chunkBegin(chunk_ + 1) - chunkBegin(chunk_);};
+    vector<double> received(numValues_ / worldSize + 1);
+
+    // reduce-scatter : afterwards rank r holds the sum of chunk r + 1
+    for (int step = 0; step < worldSize - 1; step++) {
+        int sendChunk    = (rank - step + worldSize) % worldSize;
+        int receiveChunk = (rank - step - 1 + 2 * worldSize) % worldSize;
+        if (!exchange(reinterpret_cast<const char*>(values_ + chunkBegin(sendChunk)),chunkSize(sendChunk) * sizeof(double),
+                      reinterpret_cast<char*>(received.data()),chunkSize(receiveChunk) * sizeof(double))) {
+            return false;
+        }
+        double* chunk = values_ + chunkBegin(receiveChunk);
+        for (size_t i = 0; i < chunkSize(receiveChunk); i++) {
+            chunk[i] += received[i];
+        }
+    }
+
+    // all-gather : the summed chunks are passed around the ring
+    for (int step = 0; step < worldSize - 1; step++) {
+        int sendChunk    = (rank - step + 1 + worldSize) % worldSize;
+        int receiveChunk = (rank - step + worldSize) % worldSize;
+        if (!exchange(reinterpret_cast<const char*>(values_ + chunkBegin(sendChunk)),chunkSize(sendChunk) * sizeof(double),
+                      reinterpret_cast<char*>(values_ + chunkBegin(receiveChunk)),chunkSize(receiveChunk) * sizeof(double))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief RingAllReduce::broadcast replaces data_ by data_ of rank root_
+ * @return returns true if data_ has been received, otherwise false
+ *
+ * The data is passed along the ring from root_, every rank forwards it to its successor.
+ */
+bool RingAllReduce::broadcast(string& data_, int root_) {
+    if (!open) {
+        return false;
+    }
+    if (worldSize == 1) {
+        return true;
+    }
+
+    uint64_t size = data_.size();
+    if (rank != root_) {
+        if (!exchange(nullptr,0,reinterpret_cast<char*>(&size),sizeof(size))) {
+            return false;
+        }
+        data_.resize(size);
+        if (!exchange(nullptr,0,&data_[0],size)) {
+            return false;
+        }
+    }
+    if ((rank + 1) % worldSize != root_) {
+        if (!exchange(reinterpret_cast<const char*>(&size),sizeof(size),nullptr,0) ||
+            !exchange(data_.data(),size,nullptr,0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief RingAllReduce::barrier returns as soon as all ranks have called barrier
+ * @return returns true if all ranks have arrived, otherwise false
+ *
+ * Sums one value per rank, as the sum of every chunk depends on all ranks.
+ */
+bool RingAllReduce::barrier() {
+    vector<double> values(worldSize,1.0);
+    return allReduce(values.data(),values.size());
+}
+
+/* --- miscellaneous --- */
+
+/**
+ * @brief RingAllReduce::localAddresses returns the loopback addresses 127.0.0.1:basePort_ + rank of worldSize_ ranks
+ */
+vector<string> RingAllReduce::localAddresses(int worldSize_, int basePort_) {
+    vector<string> addresses;
+    for (int r = 0; r < worldSize_; r++) {
+        stringstream address;
+        address << "127.0.0.1:" << basePort_ + r;
+        addresses.push_back(address.str());
+    }
+    return addresses;
+}
+
+/**
+ * @brief RingAllReduce::freeLocalPorts finds numPorts_ consecutive ports which are free on 127.0.0.1
+ * @return returns the first of the ports, 0 if no free ports have been found
+ *
+ * The first port is chosen by the system (bind to port 0), the following ones are tried.
+ *
+ * NOTICE : the ports are released before the function returns, therefore another process
+ *          may take them before the ranks listen on them
+ */
+int RingAllReduce::freeLocalPorts(int numPorts_) {
+    for (int attempt = 0; attempt < 100; attempt++) {
+        vector<int> sockets;
+        int basePort = 0;
+        bool free = true;
+        for (int p = 0; p < numPorts_ && free; p++) {
+            sockaddr_in address = {};
+            address.sin_family      = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            address.sin_port        = htons(p == 0 ? 0 : basePort + p);
+            socklen_t length = sizeof(address);
+            int socket_l = socket(AF_INET,SOCK_STREAM,0);
+            free = socket_l >= 0 && bind(socket_l,reinterpret_cast<sockaddr*>(&address),length) == 0 &&
+                   getsockname(socket_l,reinterpret_cast<sockaddr*>(&address),&length) == 0;
+            if (socket_l >= 0) {
+                sockets.push_back(socket_l);
+            }
+            if (free && p == 0) {
+                basePort = ntohs(address.sin_port);
+                free = basePort + numPorts_ - 1 <= 65535;
+            }
+        }
+        for (int socket_l : sockets) {
+            close(socket_l);
+        }
+        if (free) {
+            return basePort;
+        }
+    }
+    cout << "Error : no " << numPorts_ << " consecutive free ports have been found" << endl;
+    return 0;
+}
+
+/**
+ * @brief RingAllReduce::connectRing listens on the own address, connects to the successor and accepts the predecessor
+ *
+ * Every rank listens before it connects, therefore the connection to the successor is
+ * established as soon as the successor listens (before it accepts), which is retried
+ * until the timeout. The rank is sent as handshake to detect misconfigured addresses.
+ */
+bool RingAllReduce::connectRing(const vector<string>& addresses_) {
+    if (worldSize == 1) {
+        return true;
+    }
+    chrono::steady_clock::time_point deadline = chrono::steady_clock::now() + chrono::seconds(timeoutSeconds);
+
+    // listen on the own address
+    string host, port;
+    if (!splitAddress(addresses_[rank],host,port)) {
+        cout << "Error : " << addresses_[rank] << " is no valid address (host:port)" << endl;
+        return false;
+    }
+    addrinfo hints = {};
+    hints.ai_family   = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags    = AI_PASSIVE;
+    addrinfo* listenAddress = nullptr;
+    if (getaddrinfo(host.empty() ? nullptr : host.c_str(),port.c_str(),&hints,&listenAddress) != 0) {
+        cout << "Error : can not listen on " << addresses_[rank] << endl;
+        return false;
+    }
+    int listenSocket = socket(listenAddress->ai_family,listenAddress->ai_socktype,listenAddress->ai_protocol);
+    int one = 1;
+    setsockopt(listenSocket,SOL_SOCKET,SO_REUSEADDR,&one,sizeof(one));
+    bool listening = listenSocket >= 0 && bind(listenSocket,listenAddress->ai_addr,listenAddress->ai_addrlen) == 0 && listen(listenSocket,1) == 0;
+    freeaddrinfo(listenAddress);
+    if (!listening) {
+        cout << "Error : can not listen on " << addresses_[rank] << endl;
+        if (listenSocket >= 0) {
+            close(listenSocket);
+        }
+        return false;
+    }
+
+    // connect to the successor
+    int next = (rank + 1) % worldSize;
+    if (!splitAddress(addresses_[next],host,port)) {
+        cout << "Error : " << addresses_[next] << " is no valid address (host:port)" << endl;
+        close(listenSocket);
+        return false;
+    }
+    hints.ai_flags = 0;
+    addrinfo* nextAddress = nullptr;
+    if (getaddrinfo(host.c_str(),port.c_str(),&hints,&nextAddress) != 0) {
+        cout << "Error : can not resolve " << addresses_[next] << endl;
+        close(listenSocket);
+        return false;
+    }
+    while (nextSocket < 0 && chrono::steady_clock::now() < deadline) {
+        nextSocket = socket(nextAddress->ai_family,nextAddress->ai_socktype,nextAddress->ai_protocol);
+        if (nextSocket >= 0 && connect(nextSocket,nextAddress->ai_addr,nextAddress->ai_addrlen) != 0) {
+            close(nextSocket);
+            nextSocket = -1;
+            this_thread::sleep_for(chrono::milliseconds(50));
+        }
+    }
+    freeaddrinfo(nextAddress);
+
+    // accept the predecessor
+    pollfd listenPoll = {listenSocket,POLLIN,0};
+    int remainingMilliseconds = chrono::duration_cast<chrono::milliseconds>(deadline - chrono::steady_clock::now()).count();
+    if (nextSocket >= 0 && poll(&listenPoll,1,max(remainingMilliseconds,0)) == 1) {
+        previousSocket = accept(listenSocket,nullptr,nullptr);
+    }
+    close(listenSocket);
+    if (nextSocket < 0 || previousSocket < 0) {
+        cout << "Error : rank " << rank << " can not connect to the ring within " << timeoutSeconds << " s" << endl;
+        return false;
+    }
+    setNoDelay(nextSocket);
+    setNoDelay(previousSocket);
+
+    // handshake
+    int32_t ownRank = rank, previousRank = -1;
+    if (!exchange(reinterpret_cast<const char*>(&ownRank),sizeof(ownRank),reinterpret_cast<char*>(&previousRank),sizeof(previousRank)) ||
+        previousRank != (rank - 1 + worldSize) % worldSize) {
+        cout << "Error : rank " << rank << " is connected to rank " << previousRank << " instead of its predecessor" << endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief RingAllReduce::exchange sends sendBytes_ bytes to the successor while receiving receiveBytes_ bytes from the predecessor
+ * @return returns true if all bytes have been exchanged, otherwise false (connection closed or timeout)
+ */
+bool RingAllReduce::exchange(const char* sendBuffer_, size_t sendBytes_, char* receiveBuffer_, size_t receiveBytes_) {
+    size_t sent = 0, received = 0;
+    while (sent < sendBytes_ || received < receiveBytes_) {
+        pollfd polls[2];
+        int    numPolls = 0;
+        if (sent < sendBytes_) {
+            polls[numPolls++] = {nextSocket,POLLOUT,0};
+        }
+        if (received < receiveBytes_) {
+            polls[numPolls++] = {previousSocket,POLLIN,0};
+        }
+        if (poll(polls,numPolls,timeoutSeconds * 1000) <= 0) {
+            cout << "Error : rank " << rank << " timed out while exchanging values with its neighbours" << endl;
+            return false;
+        }
+        for (int i = 0; i < numPolls; i++) {
+            if (polls[i].revents == 0) {
+                continue;
+            }
+            ssize_t bytes;
+            if (polls[i].fd == nextSocket && sent < sendBytes_) {
+                bytes = send(nextSocket,sendBuffer_ + sent,sendBytes_ - sent,MSG_NOSIGNAL | MSG_DONTWAIT);
+                sent += bytes > 0 ? bytes : 0;
+            } else {
+                bytes = recv(previousSocket,receiveBuffer_ + received,receiveBytes_ - received,MSG_DONTWAIT);
+                received += bytes > 0 ? bytes : 0;
+                if (bytes == 0) {
+                    cout << "Error : rank " << rank << " has lost the connection to its predecessor" << endl;
+                    return false;
+                }
+            }
+            if (bytes < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                cout << "Error : rank " << rank << " has lost the connection to its neighbours" << endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief DistributedLauncher::run runs worker_ in worldSize_ processes connected by a RingAllReduce
+ * @param worldSize_ number of ranks (processes)
+ * @param basePort_  rank r listens on 127.0.0.1:basePort_ + r, 0 : free ports are taken
+ * @param worker_    function run by every rank, returns true on success
+ * @return returns true if all ranks have returned true, otherwise false
+ *
+ * NOTICE : the processes are forked from the calling process, therefore worker_ has to be
+ *          started before threads are created which the children would need
+ */
+bool DistributedLauncher::run(int worldSize_, int basePort_, const function<bool(RingAllReduce&)>& worker_) {
+    if (basePort_ == 0) {
+        basePort_ = RingAllReduce::freeLocalPorts(worldSize_);
+        if (basePort_ == 0) {
+            return false;
+        }
+    }
+    vector<string> addresses = RingAllReduce::localAddresses(worldSize_,basePort_);
+    cout.flush();
+
+    vector<pid_t> children;
+    for (int r = 0; r < worldSize_; r++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            cout << "Error : can not start rank " << r << endl;
+            break;
+        }
+        if (pid == 0) {
+            bool success;
+            {
+                RingAllReduce ring(r,addresses);
+                success = ring.isOpen() && worker_(ring);
+            }
+            cout.flush();
+            _exit(success ? 0 : 1);
+        }
+        children.push_back(pid);
+    }
+
+    bool success = int(children.size()) == worldSize_;
+    for (pid_t child : children) {
+        int status = 0;
+        waitpid(child,&status,0);
+        success = success && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+    return success;
+}
@@ -0,0 +1,32 @@
+#include "SolverNet.h"
+
+/* --- resolving --- */
+
+/**
+ * @brief SolverNet::netParameter resolves the net of the solver parameters param_
+ * @param param_ solver parameters, one of train_net_param, train_net, net_param or net has to be set
+ * @param phase_ phase the net is built for
+ * @return returns the parameters of the net, the state holds phase_
+ */
+NetParameter SolverNet::netParameter(const SolverParameter& param_, Phase phase_) {
+    NetParameter netParam;
+    if (phase_ == caffe::TRAIN && param_.has_train_net_param()) {
+        netParam.CopyFrom(param_.train_net_param());
+    } else if (phase_ == caffe::TRAIN && param_.has_train_net()) {
+        ReadNetParamsFromTextFileOrDie(param_.train_net(),&netParam);
+    } else if (param_.has_net_param()) {
+        netParam.CopyFrom(param_.net_param());
+    } else {
+        ReadNetParamsFromTextFileOrDie(param_.net(),&netParam);
+    }
+
+    // the phase overrides the state of the prototxt, the train_state of the solver overrides both
+    NetState state;
+    state.set_phase(phase_);
+    state.MergeFrom(netParam.state());
+    if (phase_ == caffe::TRAIN) {
+        state.MergeFrom(param_.train_state());
+    }
+    netParam.mutable_state()->CopyFrom(state);
+    return netParam;
+}
@@ -0,0 +1,372 @@
+#include "StreamingEvaluator.h"
+
+// STL
+#include <thread>
+#include <atomic>
+#include <cstdlib>
+#include <algorithm>
+// POSIX
+#include <sys/mman.h>
+
+/* --- constructors / destructors --- */
+
+/**
+ * @brief StreamingEvaluator::StreamingEvaluator constructor of class StreamingEvaluator
+ *
+ * @param ann_                the net which is to evaluate
+ * @param numInputs_          number of input values per sample (number of input neurons of ann_)
+ * @param numExpectedColumns_ number of expected output values per sample stored in the input file
+ * @param chunkSize_          number of samples which are propagated through the net at once
+ */
+StreamingEvaluator::StreamingEvaluator(ANN& ann_, int numInputs_, int numExpectedColumns_, int chunkSize_)
+    : ann(ann_), numInputs(numInputs_), numExpectedColumns(numExpectedColumns_) {
+    setChunkSize(chunkSize_);
+}
+
+/* --- evaluation --- */
+
+/**
+ * @brief StreamingEvaluator::evaluate propagates all samples of an input file through the net
+ * @param inputPath_   path of the file containing the samples
+ * @param inputFormat_ format of the file containing the samples
+ * @param outputPath_  path of the csv-file the results are written to
+ * @return returns true if all samples have been evaluated and written, otherwise false
+ */
+bool StreamingEvaluator::evaluate(const string& inputPath_, InputFormat inputFormat_, const string& outputPath_) {
+    return runPipeline([&](BoundedQueue<Chunk>& parsedChunks_) {
+        if (inputFormat_ == CSV) {
+            return readCSV(inputPath_,parsedChunks_);
+        }
+        return readRawBinary(inputPath_,parsedChunks_);
+    },outputPath_);
+}
+
+/**
+ * @brief StreamingEvaluator::evaluate propagates all samples of a columnar data set through the net
+ * @param dataSet_    opened data set, its outputs are the expected values
+ * @param outputPath_ path of the csv-file the results are written to
+ * @return returns true if all samples have been evaluated and written, otherwise false
+ *
+ * The data set is read by ranges of chunkSize rows of every column. The pages of a range are
+ * released after it has been copied, therefore the data set is never held in memory as a whole.
+ *
+ * NOTICE : the data set has to have numInputs inputs and numExpectedColumns outputs, otherwise
+ *          the function stops and returns false
+ */
+bool StreamingEvaluator::evaluate(const ColumnarDataSet& dataSet_, const string& outputPath_) {
+    if (!dataSet_.isOpen() || dataSet_.getNumInputs() != numInputs || dataSet_.getNumOutputs() != numExpectedColumns) {
+        cout << "Error : the data set does not have " << numInputs << " inputs and " << numExpectedColumns << " outputs" << endl;
+        return false;
+    }
+    return runPipeline([&](BoundedQueue<Chunk>& parsedChunks_) {
+        return readColumnar(dataSet_,parsedChunks_);
+    },outputPath_);
+}
+
+/* --- pipeline stages --- */
+
+/**
+ * @brief StreamingEvaluator::runPipeline propagates all chunks read by read_ through the net
+ * @param read_       pushes all chunks of the input into the queue, returns true on success
+ * @param outputPath_ path of the csv-file the results are written to
+ * @return returns true if all samples have been evaluated and written, otherwise false
+ *
+ * The evaluation is a pipeline of three threads :
+ *   1. reader  : reads chunkSize samples into a chunk, calculates the expected values
+ *                by the reference function (if needed)
+ *   2. forward : propagates every chunk through the net (this is done by the calling thread)
+ *   3. writer  : appends every evaluated chunk to the output file
+ *
+ * NOTICE : the queues between the threads only hold a few chunks, therefore the memory usage
+ *          is bounded by a small multiple of chunkSize samples
+ */
+bool StreamingEvaluator::runPipeline(const function<bool(BoundedQueue<Chunk>&)>& read_, const string& outputPath_) {
+    if (numInputs <= 0 || numExpectedColumns < 0) {
+        cout << "Error : invalid number of input or expected columns" << endl;
+        return false;
+    }
+
+    CsvWriter oFile(outputPath_);
+    if (!oFile.isOpen()) {
+        return false;
+    }
+
+    BoundedQueue<Chunk> parsedChunks(2);
+    BoundedQueue<Chunk> evaluatedChunks(2);
+    atomic<bool> readSucceeded(true);
+    atomic<bool> writeSucceeded(true);
+
+    // 1. reader thread
+    thread reader([&] {
+        readSucceeded = read_(parsedChunks);
+        parsedChunks.close();
+    });
+
+    // 3. writer thread
+    thread writer([&] {
+        writeSucceeded = writeCSV(oFile,evaluatedChunks);
+    });
+
+    // 2. propagate every chunk through the net
+    Chunk chunk;
+    while (parsedChunks.pop(chunk)) {
+        chunk.outputValues = ann.forward(chunk.inputValues.view());
+        if (!evaluatedChunks.push(std::move(chunk))) {
+            break;
+        }
+    }
+    evaluatedChunks.close();
+
+    // unblock the reader in case the writer stopped early
+    parsedChunks.close();
+
+    reader.join();
+    writer.join();
+    oFile.close();
+
+    return readSucceeded && writeSucceeded;
+}
+
+/**
+ * @brief StreamingEvaluator::readCSV parses a csv-file chunk by chunk
+ * @param inputPath_    path of the csv-file
+ * @param parsedChunks_ queue the parsed chunks are pushed into
+ * @return returns true if the whole file has been parsed, otherwise false
+ *
+ * NOTICE : every line has to contain numInputs + numExpectedColumns values, otherwise the
+ *          function stops and returns false
+ */
+bool StreamingEvaluator::readCSV(const string& inputPath_, BoundedQueue<Chunk>& parsedChunks_) {
+    ifstream iFile(inputPath_);
+    if (!iFile.is_open()) {
+        cout << "Error : could not open " << inputPath_ << endl;
+        return false;
+    }
+
+    int numColumns = numInputs + numExpectedColumns;
+    vector<double> row(numColumns);
+    string line;
+    bool firstLine = true;
+
+    // the rows of a chunk are filled one after another, a complete chunk is pushed
+    Chunk chunk;
+    int numSamplesInChunk = 0;
+    auto pushChunk = [&]() {
+        chunk.inputValues.resize(numSamplesInChunk,numInputs);
+        chunk.expectedValues.resize(numSamplesInChunk,numExpectedColumns);
+        completeChunk(chunk);
+        bool pushed = parsedChunks_.push(std::move(chunk));
+        chunk = Chunk();
+        chunk.inputValues.resize(chunkSize,numInputs);
+        chunk.expectedValues.resize(chunkSize,numExpectedColumns);
+        numSamplesInChunk = 0;
+        return pushed;
+    };
+    chunk.inputValues.resize(chunkSize,numInputs);
+    chunk.expectedValues.resize(chunkSize,numExpectedColumns);
+
+    while (getline(iFile,line)) {
+        if (line.empty() || line == "\r") {
+            continue;
+        }
+
+        // split line at commas and convert every field
+        int column = 0;
+        bool valid = true;
+        const char* position = line.data();
+        const char* lineEnd  = line.data() + line.size();
+        while (valid && position < lineEnd) {
+            double value;
+            const char* end = CsvReader::parseDouble(position,lineEnd,value);
+            if (end == position || column >= numColumns) {
+                valid = false;
+            } else {
+                row[column++] = value;
+                while (end < lineEnd && (*end == ' ' || *end == '\r')) {
+                    end++;
+                }
+                if (end < lineEnd && *end == ',') {
+                    end++;
+                } else if (end < lineEnd) {
+                    valid = false;
+                }
+                position = end;
+            }
+        }
+
+        if (!valid || column != numColumns) {
+            // a non-numeric first line is a header
+            if (firstLine && !valid) {
+                firstLine = false;
+                continue;
+            }
+            cout << "Error : invalid line in " << inputPath_ << " : " << line << endl;
+            return false;
+        }
+        firstLine = false;
+
+        copy(row.begin(),row.begin() + numInputs,chunk.inputValues.row(numSamplesInChunk));
+        copy(row.begin() + numInputs,row.end(),chunk.expectedValues.row(numSamplesInChunk));
+        numSamplesInChunk++;
+
+        if (numSamplesInChunk == chunkSize && !pushChunk()) {
+            return false;
+        }
+    }
+
+    if (numSamplesInChunk > 0 && !pushChunk()) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief StreamingEvaluator::readRawBinary reads a headerless columnar binary file chunk by chunk
+ * @param inputPath_    path of the binary file
+ * @param parsedChunks_ queue the read chunks are pushed into
+ * @return returns true if the whole file has been read, otherwise false
+ *
+ * The number of samples is derived from the file size :
+ *     numSamples = fileSize / (sizeof(double) * (numInputs + numExpectedColumns))
+ *
+ * NOTICE : if the file size is no multiple of the size of one sample the function
+ *          stops and returns false
+ */
+bool StreamingEvaluator::readRawBinary(const string& inputPath_, BoundedQueue<Chunk>& parsedChunks_) {
+    ifstream iFile(inputPath_, ios::binary | ios::ate);
+    if (!iFile.is_open()) {
+        cout << "Error : could not open " << inputPath_ << endl;
+        return false;
+    }
+
+    int numColumns = numInputs + numExpectedColumns;
+    long long fileSize   = iFile.tellg();
+    long long sampleSize = (long long)sizeof(double) * numColumns;
+    if (fileSize % sampleSize != 0) {
+        cout << "Error : size of " << inputPath_ << " does not fit to " << numColumns << " columns" << endl;
+        return false;
+    }
+    long long numSamples = fileSize / sampleSize;
+
+    vector<double> column(chunkSize);
+    for (long long firstSample = 0; firstSample < numSamples; firstSample += chunkSize) {
+        int numSamplesInChunk = (int)min<long long>(chunkSize,numSamples - firstSample);
+
+        Chunk chunk;
+        chunk.inputValues.resize(numSamplesInChunk,numInputs);
+        chunk.expectedValues.resize(numSamplesInChunk,numExpectedColumns);
+
+        // read the part of every column which belongs to this chunk
+        for (int columnIndex = 0; columnIndex < numColumns; columnIndex++) {
+            iFile.seekg((columnIndex * numSamples + firstSample) * (long long)sizeof(double));
+            iFile.read(reinterpret_cast<char*>(column.data()),numSamplesInChunk * sizeof(double));
+            if (!iFile) {
+                cout << "Error : could not read " << inputPath_ << endl;
+                return false;
+            }
+            for (int i = 0; i < numSamplesInChunk; i++) {
+                if (columnIndex < numInputs) {
+                    chunk.inputValues(i,columnIndex) = column[i];
+                } else {
+                    chunk.expectedValues(i,columnIndex - numInputs) = column[i];
+                }
+            }
+        }
+
+        completeChunk(chunk);
+        if (!parsedChunks_.push(std::move(chunk))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief StreamingEvaluator::readColumnar copies the rows of a columnar data set chunk by chunk
+ * @param dataSet_      opened data set with numInputs inputs and numExpectedColumns outputs
+ * @param parsedChunks_ queue the chunks are pushed into
+ * @return returns true if all rows have been read, otherwise false
+ */
+bool StreamingEvaluator::readColumnar(const ColumnarDataSet& dataSet_, BoundedQueue<Chunk>& parsedChunks_) {
+    size_t numSamples = dataSet_.getNumRows();
+    for (size_t firstSample = 0; firstSample < numSamples; firstSample += chunkSize) {
+        int numSamplesInChunk = (int)min<size_t>(chunkSize,numSamples - firstSample);
+
+        Chunk chunk;
+        chunk.inputValues.resize(numSamplesInChunk,numInputs);
+        chunk.expectedValues.resize(numSamplesInChunk,numExpectedColumns);
+
+        // the part of every column which belongs to this chunk
+        for (int columnIndex = 0; columnIndex < dataSet_.getNumColumns(); columnIndex++) {
+            const double* column = dataSet_.getColumnData(columnIndex) + firstSample;
+            for (int i = 0; i < numSamplesInChunk; i++) {
+                if (columnIndex < numInputs) {
+                    chunk.inputValues(i,columnIndex) = column[i];
+                } else {
+                    chunk.expectedValues(i,columnIndex - numInputs) = column[i];
+                }
+            }
+        }
+        // the rows are not read again
+        dataSet_.advise(firstSample,numSamplesInChunk,MADV_DONTNEED);
+
+        completeChunk(chunk);
+        if (!parsedChunks_.push(std::move(chunk))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief StreamingEvaluator::writeCSV appends every evaluated chunk to oFile_
+ * @param oFile_           opened output file
+ * @param evaluatedChunks_ queue the evaluated chunks are taken from
+ * @return returns true if all chunks have been written, otherwise false
+ */
+bool StreamingEvaluator::writeCSV(CsvWriter& oFile_, BoundedQueue<Chunk>& evaluatedChunks_) {
+    Chunk chunk;
+    vector<double> rows;
+    while (evaluatedChunks_.pop(chunk)) {
+        // inputs, expected values and outputs of every sample form one row
+        size_t numRows    = chunk.inputValues.getNumRows();
+        int    numColumns = chunk.inputValues.getNumColumns() + chunk.expectedValues.getNumColumns() + chunk.outputValues.getNumColumns();
+        rows.resize(numRows * numColumns);
+        double* position = rows.data();
+        for (size_t i = 0; i < numRows; i++) {
+            position = copy(chunk.inputValues.row(i),chunk.inputValues.row(i + 1),position);
+            position = copy(chunk.expectedValues.row(i),chunk.expectedValues.row(i + 1),position);
+            position = copy(chunk.outputValues.row(i),chunk.outputValues.row(i + 1),position);
+        }
+        if (numRows > 0) {
+            oFile_.writeRows(rows.data(),numRows,numColumns);
+        }
+    }
+    if (!oFile_.flush()) {
+        cout << "Error : could not write results" << endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief StreamingEvaluator::completeChunk calculates the expected values of chunk_
+ *        by the reference function, if the input file does not contain expected values
+ */
+void StreamingEvaluator::completeChunk(Chunk& chunk_) {
+    size_t numRows = chunk_.inputValues.getNumRows();
+    if (chunk_.expectedValues.getNumColumns() > 0 || !referenceFunction || numRows == 0) {
+        return;
+    }
+    vector<double> inputValues;
+    for (size_t i = 0; i < numRows; i++) {
+        inputValues.assign(chunk_.inputValues.row(i),chunk_.inputValues.row(i + 1));
+        vector<double> expectedValues = referenceFunction(inputValues);
+        // the first sample defines the number of expected values
+        if (i == 0) {
+            chunk_.expectedValues.resize(numRows,expectedValues.size());
+        }
+        expectedValues.resize(chunk_.expectedValues.getNumColumns());
+        copy(expectedValues.begin(),expectedValues.end(),chunk_.expectedValues.row(i));
+    }
+}
@@ -0,0 +1,194 @@
+#include "Transforms.h"
+
+// STL
+#include <vector>
+#include <thread>
+#include <algorithm>
+// SIMD
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+int Transforms::numThreads = 0;
+
+namespace {
+
+enum Operation {
+    MULTIPLY_ADD,
+    MULTIPLY,
+    DIVIDE,
+    ADD
+};
+
+/**
+ * applies the operation to length_ values with the parameters at the same positions
+ */
+template <Operation operation>
+void applyBlock(double* values_, const double* factors_, const double* summands_, size_t length_) {
+    size_t i = 0;
+#if defined(__AVX__)
+    for (; i + 4 <= length_; i += 4) {
+        __m256d value = _mm256_loadu_pd(values_ + i);
+        if (operation == DIVIDE) {
+            value = _mm256_div_pd(value,_mm256_loadu_pd(factors_ + i));
+        } else if (operation != ADD) {
+            value = _mm256_mul_pd(value,_mm256_loadu_pd(factors_ + i));
+        }
+        if (operation == MULTIPLY_ADD || operation == ADD) {
+            value = _mm256_add_pd(value,_mm256_loadu_pd(summands_ + i));
+        }
+        _mm256_storeu_pd(values_ + i,value);
+    }
+#elif defined(__SSE2__)
+    for (; i + 2 <= length_; i += 2) {
+        __m128d value = _mm_loadu_pd(values_ + i);
+        if (operation == DIVIDE) {
+            value = _mm_div_pd(value,_mm_loadu_pd(factors_ + i));
+        } else if (operation != ADD) {
+            value = _mm_mul_pd(value,_mm_loadu_pd(factors_ + i));
+        }
+        if (operation == MULTIPLY_ADD || operation == ADD) {
+            value = _mm_add_pd(value,_mm_loadu_pd(summands_ + i));
+        }
+        _mm_storeu_pd(values_ + i,value);
+    }
+#endif
+    for (; i < length_; i++) {
+        double value = values_[i];
+        if (operation == DIVIDE) {
+            value /= factors_[i];
+        } else if (operation != ADD) {
+            value *= factors_[i];
+        }
+        if (operation == MULTIPLY_ADD || operation == ADD) {
+            value += summands_[i];
+        }
+        values_[i] = value;
+    }
+}
+
+/**
+ * applies the operation with per-column parameters to numRows_ rows
+ *
+ * The parameters are repeated into a block of whole rows (at least 256 values), therefore every
+ * block of the buffer is transformed by one contiguous pass over values and parameters.
+ */
+template <Operation operation>
+void apply(double* values_, size_t numRows_, int numColumns_, const double* factors_, const double* summands_, int numThreads_) {
+    if (numRows_ == 0 || numColumns_ <= 0) {
+        return;
+    }
+
+    // rows with many columns are used as they are, short rows are repeated into a block on the stack
+    size_t rowsPerBlock = (numColumns_ < 256) ? (256 + numColumns_ - 1) / numColumns_ : 1;
+    size_t blockLength  = rowsPerBlock * numColumns_;
+    double factorBlock[512];
+    double summandBlock[512];
+    const double* factors  = factors_;
+    const double* summands = summands_;
+    if (rowsPerBlock > 1) {
+        for (size_t i = 0; i < blockLength; i++) {
+            if (operation != ADD) {
+                factorBlock[i] = factors_[i % numColumns_];
+            }
+            if (operation == MULTIPLY_ADD || operation == ADD) {
+                summandBlock[i] = summands_[i % numColumns_];
+            }
+        }
+        factors  = factorBlock;
+        summands = summandBlock;
+    }
+
+    auto applyRows = [&](size_t firstRow_, size_t numRows_l) {
+        double* position = values_ + firstRow_ * numColumns_;
+        double* end      = position + numRows_l * numColumns_;
+        for (; position + blockLength <= end; position += blockLength) {
+            applyBlock<operation>(position,factors,summands,blockLength);
+        }
+        applyBlock<operation>(position,factors,summands,end - position);
+    };
+
+    // split big buffers into one part of whole rows per thread
+    int    numThreads_l = (numThreads_ > 0) ? numThreads_ : max(1u,thread::hardware_concurrency());
+    size_t numParts     = min<size_t>(numThreads_l,max<size_t>(1,numRows_ * numColumns_ >> 18));
+    if (numParts == 1) {
+        applyRows(0,numRows_);
+        return;
+    }
+    vector<thread> threads;
+    size_t rowsPerPart = (numRows_ + numParts - 1) / numParts;
+    for (size_t p = 0; p < numParts; p++) {
+        size_t firstRow = min(numRows_,p * rowsPerPart);
+        threads.push_back(thread(applyRows,firstRow,min(numRows_,firstRow + rowsPerPart) - firstRow));
+    }
+    for (unsigned int p = 0; p < threads.size(); p++) {
+        threads[p].join();
+    }
+}
+
+}
+
+/* --- transforms --- */
+
+/**
+ * @brief Transforms::multiplyAdd values_[r * numColumns_ + c] = values_[r * numColumns_ + c] * factors_[c] + summands_[c]
+ * @param values_     numRows_ * numColumns_ values, row-major
+ * @param numRows_    number of rows
+ * @param numColumns_ number of columns
+ * @param factors_    one factor per column
+ * @param summands_   one summand per column
+ */
+void Transforms::multiplyAdd(double* values_, size_t numRows_, int numColumns_, const double* factors_, const double* summands_) {
+    apply<MULTIPLY_ADD>(values_,numRows_,numColumns_,factors_,summands_,numThreads);
+}
+
+/**
+ * @brief Transforms::scale values_[r * numColumns_ + c] = values_[r * numColumns_ + c] * factors_[c]
+ */
+void Transforms::scale(double* values_, size_t numRows_, int numColumns_, const double* factors_) {
+    apply<MULTIPLY>(values_,numRows_,numColumns_,factors_,nullptr,numThreads);
+}
+
+/**
+ * @brief Transforms::divide values_[r * numColumns_ + c] = values_[r * numColumns_ + c] / divisors_[c]
+ */
+void Transforms::divide(double* values_, size_t numRows_, int numColumns_, const double* divisors_) {
+    apply<DIVIDE>(values_,numRows_,numColumns_,divisors_,nullptr,numThreads);
+}
+
+/**
+ * @brief Transforms::shift values_[r * numColumns_ + c] = values_[r * numColumns_ + c] + offsets_[c]
+ */
+void Transforms::shift(double* values_, size_t numRows_, int numColumns_, const double* offsets_) {
+    apply<ADD>(values_,numRows_,numColumns_,nullptr,offsets_,numThreads);
+}
+
+/**
+ * @brief Transforms::zTransform values_[r * numColumns_ + c] = (values_[r * numColumns_ + c] - means_[c]) / standardDeviations_[c]
+ *
+ * The transform is applied as multiplyAdd with the factors 1 / standardDeviations_[c] and the
+ * summands -means_[c] / standardDeviations_[c], which may differ from the quotient in the last bit.
+ *
+ * NOTICE : columns with standardDeviations_[c] == 0 are only shifted
+ */
+void Transforms::zTransform(double* values_, size_t numRows_, int numColumns_, const double* means_, const double* standardDeviations_) {
+    vector<double> factors(numColumns_), summands(numColumns_);
+    for (int c = 0; c < numColumns_; c++) {
+        factors [c] = (standardDeviations_[c] != 0.0) ? 1.0 / standardDeviations_[c] : 1.0;
+        summands[c] = -means_[c] * factors[c];
+    }
+    multiplyAdd(values_,numRows_,numColumns_,factors.data(),summands.data());
+}
+
+/**
+ * @brief Transforms::inverseZTransform values_[r * numColumns_ + c] = values_[r * numColumns_ + c] * standardDeviations_[c] + means_[c]
+ *
+ * NOTICE : columns with standardDeviations_[c] == 0 are only shifted
+ */
+void Transforms::inverseZTransform(double* values_, size_t numRows_, int numColumns_, const double* means_, const double* standardDeviations_) {
+    vector<double> factors(numColumns_);
+    for (int c = 0; c < numColumns_; c++) {
+        factors[c] = (standardDeviations_[c] != 0.0) ? standardDeviations_[c] : 1.0;
+    }
+    multiplyAdd(values_,numRows_,numColumns_,factors.data(),means_);
+}